@@ -0,0 +1,156 @@
+#include "BatchRunner.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "Logger.h"
+
+BatchRunner::BatchRunner(size_t concurrency, double memory_limit_per_job)
+    : concurrency_(std::max<size_t>(concurrency, 1)), memory_limit_per_job_(memory_limit_per_job)
+{
+}
+
+/**
+ * @brief Reads the jobs of a manifest. Every non-empty line not starting with # is a job with whitespace separated
+ * fields: instance path, time limit, timing formulation, run mode, export path, window size and overlap of the rolling
+ * horizon. Only the instance path is required, missing fields take the defaults of a single run.
+ */
+vector<RunOptions> BatchRunner::ReadManifest(const string &path)
+{
+   std::ifstream file(path);
+   if (!file)
+      throw std::runtime_error("Could not open manifest " + path);
+
+   vector<RunOptions> jobs;
+   string line;
+   while (std::getline(file, line))
+   {
+      std::istringstream fields(line);
+      string instance_path;
+      if (!(fields >> instance_path) || instance_path[0] == '#')
+         continue;
+
+      RunOptions options;
+      options.instance_path = instance_path;
+      // solutions of concurrent jobs would interleave on cout, their model files would overwrite each other
+      options.display_solution = false;
+      options.write_model_files = false;
+
+      string field;
+      if (fields >> field)
+         options.time_limit = stod(field);
+      if (fields >> field)
+         options.timing_formulation = ParseTimingFormulation(field);
+      if (fields >> field)
+         options.run_mode = ParseRunMode(field);
+      if (fields >> field)
+         options.export_path = field;
+      if (fields >> field)
+         options.horizon_window_size = stoul(field);
+      if (fields >> field)
+         options.horizon_overlap = stoul(field);
+
+      jobs.push_back(options);
+   }
+
+   return jobs;
+}
+
+/**
+ * @brief Runs all jobs on concurrency worker threads, every worker takes the next job that is not started yet
+ */
+void BatchRunner::Run(const vector<RunOptions> &jobs)
+{
+   reports_.assign(jobs.size(), JobReport());
+   for (size_t job = 0; job < jobs.size(); job++)
+   {
+      reports_[job].options = jobs[job];
+      reports_[job].options.memory_limit = memory_limit_per_job_;
+   }
+   next_job_ = 0;
+
+   PHALS_LOG(kInfo) << "[Batch] Solving " << jobs.size() << " instances with " << concurrency_ << " concurrent jobs" << endl;
+
+   auto batch_start = std::chrono::steady_clock::now();
+
+   vector<thread> workers;
+   for (size_t worker = 0; worker < std::min(concurrency_, jobs.size()); worker++)
+   {
+      workers.emplace_back(&BatchRunner::RunJobs, this);
+   }
+
+   for (auto &worker : workers)
+   {
+      worker.join();
+   }
+
+   wall_seconds_ = SecondsSince(batch_start);
+
+   PHALS_LOG(kInfo) << "[Batch] Finished " << jobs.size() << " instances after " << wall_seconds_ << "s, "
+                    << (wall_seconds_ > 0 ? jobs.size() * 3600 / wall_seconds_ : 0) << " instances per hour" << endl;
+   Logger::Get().Flush();
+}
+
+/**
+ * @brief Work loop of a worker thread. A failing job is reported and does not stop the batch.
+ */
+void BatchRunner::RunJobs()
+{
+   for (auto job = next_job_++; job < reports_.size(); job = next_job_++)
+   {
+      auto &report = reports_[job];
+      auto job_start = std::chrono::steady_clock::now();
+
+      try
+      {
+         report.result = RunInstance(report.options);
+      }
+      catch (const std::exception &error)
+      {
+         report.failed = true;
+         report.error = error.what();
+         report.result.seconds = SecondsSince(job_start);
+      }
+
+      PHALS_LOG(kInfo) << "[Batch] Job " << job + 1 << "/" << reports_.size() << " " << report.options.instance_path << " "
+                       << (report.failed ? "failed: " + report.error : report.result.has_solution ? "solved" : "without solution")
+                       << " after " << report.result.seconds << "s" << endl;
+   }
+}
+
+/**
+ * @brief Writes one row per job and the totals of the batch. Throughput is the number of instances per hour of wall
+ * time of the whole batch. Memory of a job is the memory of its SCIP instances at its end, see RunResult::scip_memory,
+ * the peak resident set size covers the whole process and thus all jobs.
+ */
+void BatchRunner::WriteReport(ostream &os) const
+{
+   os << "instance,run_mode,status,cost,seconds,scip_memory_mb,memory_limit_mb" << endl;
+
+   size_t solved = 0;
+   size_t failed = 0;
+   double job_seconds = 0;
+   double peak_scip_memory = 0;
+   for (auto &report : reports_)
+   {
+      string status = report.failed ? "failed" : report.result.has_solution ? "solved" : "no_solution";
+      os << report.options.instance_path << "," << GetRunModeName(report.options.run_mode) << "," << status << ",";
+      if (report.result.has_solution)
+         os << report.result.solution.cost;
+      os << "," << report.result.seconds << "," << report.result.scip_memory << "," << report.options.memory_limit << endl;
+
+      solved += report.result.has_solution ? 1 : 0;
+      failed += report.failed ? 1 : 0;
+      job_seconds += report.result.seconds;
+      peak_scip_memory = std::max(peak_scip_memory, report.result.scip_memory);
+   }
+
+   os << "# jobs " << reports_.size() << ", solved " << solved << ", failed " << failed << ", concurrency " << concurrency_
+      << endl;
+   os << "# wall time " << wall_seconds_ << "s, summed job time " << job_seconds << "s, "
+      << (wall_seconds_ > 0 ? reports_.size() * 3600 / wall_seconds_ : 0) << " instances per hour" << endl;
+   os << "# memory limit per job " << memory_limit_per_job_ << " MB (0 for no limit), peak SCIP memory of a job " << peak_scip_memory
+      << " MB, peak resident set size of the batch " << PeakResidentSetSizeInMegabytes() << " MB" << endl;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+
+#include "InstanceRun.h"
+
+/**
+ * @brief Solves the instances of a manifest in one process with a fixed number of concurrent jobs
+ *
+ * Every job reads its instance and builds its own SCIP instances, see RunInstance, so jobs do not share any solver
+ * state. The SCIP instances of a job share its memory limit. Results of all jobs are collected into one report.
+ */
+class BatchRunner
+{
+public:
+   BatchRunner(size_t concurrency, double memory_limit_per_job);
+
+   // one job per line: instance path, optionally time limit, timing formulation, run mode and export path
+   static vector<RunOptions> ReadManifest(const string &path);
+
+   void Run(const vector<RunOptions> &jobs);
+
+   // one row per job followed by a summary, as csv
+   void WriteReport(ostream &os) const;
+
+private:
+   size_t concurrency_;
+   double memory_limit_per_job_;
+
+   struct JobReport
+   {
+      RunOptions options;
+      bool failed = false;
+      string error;
+      RunResult result;
+   };
+
+   vector<JobReport> reports_;
+   double wall_seconds_ = 0;
+
+   // index of the next job that is not started yet
+   std::atomic<size_t> next_job_{0};
+
+   void RunJobs();
+};
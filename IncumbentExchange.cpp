@@ -0,0 +1,155 @@
+#include "IncumbentExchange.h"
+
+#include "Logger.h"
+#include "Settings.h"
+
+IncumbentExchange::IncumbentExchange(shared_ptr<Instance> instance) : instance_(instance)
+{
+}
+
+/**
+ * @brief Stores a solution if it is strictly better than the best known one
+ *
+ * @param source Solver that found the solution
+ * @param solution Sequences and cost of the solution, the timing is computed here
+ * @return true If the solution is the new best known solution
+ */
+bool IncumbentExchange::Publish(Solver source, SequenceSolution solution)
+{
+   solution.ComputeTiming(*instance_);
+   auto cost = solution.cost;
+
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (has_solution_ && solution.cost >= best_.cost - Settings::kIncumbentExchangeTolerance)
+         return false;
+
+      best_ = std::move(solution);
+      best_source_ = source;
+      has_solution_ = true;
+      version_++;
+   }
+
+   PHALS_LOG(kInfo) << "[Portfolio] New incumbent " << cost << " found by " << GetSolverName(source) << endl;
+   return true;
+}
+
+/**
+ * @brief Copies the best known solution if another solver found it and it improves the incumbent of the receiver
+ *
+ * @param receiver Solver asking for a solution
+ * @param objective Objective value of the incumbent of the receiver
+ * @param solution Set to the best known solution if true is returned
+ * @param version Set to the version of the returned solution
+ */
+bool IncumbentExchange::FetchBetter(Solver receiver, double objective, SequenceSolution &solution, size_t &version) const
+{
+   std::lock_guard<std::mutex> lock(mutex_);
+   if (!has_solution_ || best_source_ == receiver || best_.cost >= objective - Settings::kIncumbentExchangeTolerance)
+      return false;
+
+   solution = best_;
+   version = version_;
+   return true;
+}
+
+/**
+ * @brief Marks a solver as terminated. If it proved optimality of its incumbent or infeasibility, no other solver can
+ * improve the result and all of them are interrupted.
+ */
+void IncumbentExchange::Finish(Solver source, bool proven)
+{
+   if (!proven)
+      return;
+
+   vector<std::function<void()>> interrupts;
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!has_prover_)
+      {
+         has_prover_ = true;
+         prover_ = source;
+      }
+
+      for (auto &[solver, interrupt] : interrupts_)
+      {
+         if (solver != source)
+            interrupts.push_back(interrupt);
+      }
+   }
+
+   stop_requested_ = true;
+   PHALS_LOG(kInfo) << "[Portfolio] " << GetSolverName(source) << " finished the search, interrupting other solvers" << endl;
+
+   for (auto &interrupt : interrupts)
+   {
+      interrupt();
+   }
+}
+
+void IncumbentExchange::RegisterInterrupt(Solver solver, std::function<void()> interrupt)
+{
+   std::lock_guard<std::mutex> lock(mutex_);
+   interrupts_[solver] = std::move(interrupt);
+}
+
+bool IncumbentExchange::IsStopRequested() const
+{
+   return stop_requested_;
+}
+
+/**
+ * @brief Prints the best known solution in the format of the solution display of the models
+ */
+void IncumbentExchange::DisplayBest(ostream &os) const
+{
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   os << "==== Portfolio Result ====" << endl;
+   if (!has_solution_)
+   {
+      os << "No solution found" << endl;
+      return;
+   }
+
+   os << "Best solution found by " << GetSolverName(best_source_) << endl;
+   os << "Optimality proven by " << (has_prover_ ? GetSolverName(prover_) : "none") << endl;
+
+   os << "==== Coil Assignment ====" << endl;
+   for (auto &[line, sequence] : best_.sequences)
+   {
+      os << "Line " << line << endl;
+      os << "Start -> ";
+      for (auto &[coil, mode] : sequence)
+      {
+         os << "C" << coil << "M" << mode;
+         if (best_.delayed.at(coil))
+            os << " delayed";
+         os << " -> ";
+      }
+      os << "End" << endl;
+   }
+   os << "Total cost: " << best_.cost << endl;
+}
+
+bool IncumbentExchange::GetBest(SequenceSolution &solution) const
+{
+   std::lock_guard<std::mutex> lock(mutex_);
+   if (!has_solution_)
+      return false;
+
+   solution = best_;
+   return true;
+}
+
+const char *IncumbentExchange::GetSolverName(Solver solver)
+{
+   switch (solver)
+   {
+   case Solver::kCompact:
+      return "compact model";
+   case Solver::kBranchAndPrice:
+      return "branch and price";
+   }
+   return "unknown";
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "Instance.h"
+#include "SequenceSolution.h"
+
+/**
+ * @brief Shares incumbents between solvers running concurrently on the same instance, e.g. the compact model and
+ * branch and price in the portfolio run mode
+ *
+ * Every solver publishes its improving solutions and fetches solutions of other solvers that are better than its own
+ * incumbent, see IncumbentExchangeHeur. Once a solver proves optimality, all other solvers are interrupted. All
+ * methods are thread-safe.
+ */
+class IncumbentExchange
+{
+public:
+   enum class Solver
+   {
+      kCompact = 0,
+      kBranchAndPrice = 1
+   };
+
+   IncumbentExchange(shared_ptr<Instance> instance);
+
+   // store the solution if it improves the best known solution, returns true if it was stored
+   bool Publish(Solver source, SequenceSolution solution);
+
+   // best known solution if it was found by another solver and is better than the given objective value
+   bool FetchBetter(Solver receiver, double objective, SequenceSolution &solution, size_t &version) const;
+
+   // called once a solver terminates, interrupts every other solver if it proved optimality or infeasibility
+   void Finish(Solver source, bool proven);
+
+   // called from the thread of a finishing solver to interrupt the given solver
+   void RegisterInterrupt(Solver solver, std::function<void()> interrupt);
+
+   bool IsStopRequested() const;
+
+   void DisplayBest(ostream &os = cout) const;
+
+   // best known solution with its timing, false if there is none
+   bool GetBest(SequenceSolution &solution) const;
+
+   static const char *GetSolverName(Solver solver);
+
+private:
+   shared_ptr<Instance> instance_;
+
+   mutable std::mutex mutex_;
+   bool has_solution_ = false;
+   SequenceSolution best_;
+   Solver best_source_ = Solver::kCompact;
+   // incremented with every stored solution, lets solvers skip solutions they have already seen
+   size_t version_ = 0;
+
+   map<Solver, std::function<void()>> interrupts_;
+   std::atomic<bool> stop_requested_{false};
+   bool has_prover_ = false;
+   Solver prover_ = Solver::kCompact;
+};
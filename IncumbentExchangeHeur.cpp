@@ -0,0 +1,99 @@
+#include "IncumbentExchangeHeur.h"
+
+#include <scip/scip.h>
+
+#include "Settings.h"
+
+/**
+ * @brief Construct the heuristic. It runs before and after every node and during the pricing loop of branch and
+ * price, where a single node can take long.
+ *
+ * @param scip SCIP environment the heuristic is included in
+ * @param exchange Exchange shared by all solvers
+ * @param solver Solver this SCIP environment belongs to
+ * @param extract Translation of SCIP solutions to sequences
+ * @param import Translation of sequences to SCIP solutions
+ */
+IncumbentExchangeHeur::IncumbentExchangeHeur(SCIP *scip, shared_ptr<IncumbentExchange> exchange, IncumbentExchange::Solver solver, Extractor extract, Importer import)
+    : ObjHeur(scip,
+              "incumbent_exchange",                                                                      // name
+              "shares incumbents with concurrently running solvers",                                     // description
+              'x',                                                                                       // display character
+              1000000,                                                                                   // priority
+              1,                                                                                         // frequency
+              0,                                                                                         // frequency offset
+              -1,                                                                                        // maximal depth, none
+              SCIP_HEURTIMING_BEFORENODE | SCIP_HEURTIMING_DURINGPRICINGLOOP | SCIP_HEURTIMING_AFTERNODE, // timing
+              FALSE),                                                                                    // uses no sub SCIP
+      exchange_(exchange), solver_(solver), extract_(std::move(extract)), import_(std::move(import)),
+      published_objective_(std::numeric_limits<double>::infinity())
+{
+}
+
+/**
+ * @brief Publishes the incumbent, imports better solutions of other solvers and stops the solve if another solver
+ * finished the search
+ */
+SCIP_RETCODE IncumbentExchangeHeur::scip_exec(SCIP *scip, SCIP_HEUR *heur, SCIP_HEURTIMING heurtiming, SCIP_Bool nodeinfeasible, SCIP_RESULT *result)
+{
+   *result = SCIP_DIDNOTRUN;
+
+   if (exchange_->IsStopRequested())
+   {
+      SCIP_CALL(SCIPinterruptSolve(scip));
+      return SCIP_OKAY;
+   }
+
+   PublishBestSolution(scip);
+
+   *result = SCIP_DIDNOTFIND;
+
+   SequenceSolution solution;
+   size_t version;
+   if (!exchange_->FetchBetter(solver_, SCIPgetPrimalbound(scip), solution, version) || version == handled_version_)
+      return SCIP_OKAY;
+
+   *result = import_(solution, heur);
+   if (*result == SCIP_DELAYED)
+   {
+      // the model needs another pricing round to express the solution, try again at the next call
+      *result = SCIP_DIDNOTFIND;
+      return SCIP_OKAY;
+   }
+
+   handled_version_ = version;
+   if (*result == SCIP_FOUNDSOL)
+   {
+      // the imported solution is not published again
+      published_objective_ = solution.cost;
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Publishes the best solution of the SCIP instance if it improved since the last call
+ */
+void IncumbentExchangeHeur::PublishBestSolution(SCIP *scip)
+{
+   auto best_solution = SCIPgetBestSol(scip);
+   if (best_solution == nullptr)
+      return;
+
+   auto objective = SCIPgetSolOrigObj(scip, best_solution);
+   if (objective >= published_objective_ - Settings::kIncumbentExchangeTolerance)
+      return;
+
+   auto solution = extract_(best_solution);
+   solution.cost = objective;
+   exchange_->Publish(solver_, std::move(solution));
+   published_objective_ = objective;
+}
+
+void IncumbentExchangeHeur::Finish(SCIP *scip)
+{
+   PublishBestSolution(scip);
+
+   auto status = SCIPgetStatus(scip);
+   exchange_->Finish(solver_, status == SCIP_STATUS_OPTIMAL || status == SCIP_STATUS_INFEASIBLE);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <memory>
+
+#include "objscip/objscip.h"
+
+#include "IncumbentExchange.h"
+
+using namespace scip;
+
+/**
+ * @brief Primal heuristic connecting a SCIP instance to an IncumbentExchange
+ *
+ * Whenever it is called, the heuristic publishes the incumbent of its SCIP instance if it improved and imports the
+ * best solution of the other solvers if it is better than the own incumbent. Translating between SCIP solutions and
+ * sequences is done by the model, see CompactModel and Master. If another solver finished the search, the solve is
+ * interrupted.
+ */
+class IncumbentExchangeHeur : public ObjHeur
+{
+public:
+   // sequences of a feasible SCIP solution
+   using Extractor = std::function<SequenceSolution(SCIP_SOL *)>;
+   // SCIP_FOUNDSOL if the solution was stored, SCIP_DIDNOTFIND if it was rejected and SCIP_DELAYED if the model
+   // cannot express it yet and the import should be retried at the next call
+   using Importer = std::function<SCIP_RESULT(const SequenceSolution &, SCIP_HEUR *)>;
+
+   IncumbentExchangeHeur(SCIP *scip, shared_ptr<IncumbentExchange> exchange, IncumbentExchange::Solver solver, Extractor extract, Importer import);
+
+   virtual SCIP_RETCODE scip_exec(SCIP *scip, SCIP_HEUR *heur, SCIP_HEURTIMING heurtiming, SCIP_Bool nodeinfeasible, SCIP_RESULT *result) override;
+
+   // publish the final incumbent and tell the exchange if the search is complete, called after SCIPsolve returned
+   void Finish(SCIP *scip);
+
+private:
+   shared_ptr<IncumbentExchange> exchange_;
+   IncumbentExchange::Solver solver_;
+   Extractor extract_;
+   Importer import_;
+
+   // objective value of the last published incumbent
+   double published_objective_;
+   // version of the last solution of the exchange that was imported or rejected
+   size_t handled_version_ = 0;
+
+   void PublishBestSolution(SCIP *scip);
+};
@@ -1,43 +1,197 @@
 #include "Instance.h"
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <iterator>
 #include <numeric>
 
+#include "InstanceCache.h"
+#include "InstanceDelta.h"
+#include "Logger.h"
+#include "MappedFile.h"
+#include "Settings.h"
+
+/**
+ * @brief Tokenizer of a single line of an instance file, numbers are parsed in place by std::from_chars
+ */
+class LineScanner
+{
+public:
+   LineScanner(const char *begin, const char *end, size_t lineNumber) : current_(begin), end_(end), lineNumber_(lineNumber) {}
+
+   // read the next number of the line, throws if there is none
+   template <typename T>
+   T Next()
+   {
+      SkipWhitespace();
+      T value{};
+      auto [next, error] = std::from_chars(current_, end_, value);
+      if (error != std::errc())
+         throw std::runtime_error("Malformed number in line " + std::to_string(lineNumber_));
+      current_ = next;
+      return value;
+   }
+
+   // first non-whitespace character of the line, 0 if the line is blank
+   char RecordType()
+   {
+      SkipWhitespace();
+      return current_ < end_ ? *current_++ : 0;
+   }
+
+   // rest of the line without the single separating space, see comment records
+   string Rest()
+   {
+      auto begin = current_ < end_ ? current_ + 1 : end_;
+      return string(begin, end_);
+   }
+
+private:
+   const char *current_;
+   const char *end_;
+   size_t lineNumber_;
+
+   void SkipWhitespace()
+   {
+      while (current_ < end_ && (*current_ == ' ' || *current_ == '\t' || *current_ == '\r'))
+         current_++;
+   }
+};
+
+/**
+ * @brief Inserts records into a map at once. Records are sorted first, so that every insertion happens at the end of
+ * the map in amortized constant time. Later records overwrite earlier ones with the same key, as if they were assigned
+ * in file order.
+ */
+template <typename Map>
+static void InsertSorted(Map &map, vector<pair<typename Map::key_type, typename Map::mapped_type>> &records)
+{
+   std::stable_sort(records.begin(), records.end(), [](const auto &lhs, const auto &rhs)
+                    { return lhs.first < rhs.first; });
+
+   for (auto &[key, value] : records)
+   {
+      auto entry = map.emplace_hint(map.end(), key, value);
+      entry->second = value;
+   }
+}
+
+/**
+ * @brief Reads an instance file and derives everything the models need from it
+ *
+ * If the instance cache is enabled, a valid cache of the file is loaded instead, see InstanceCache. Otherwise the
+ * file is parsed and preprocessed and the cache is written for the next run.
+ *
+ * @param nameFile Path of the instance file
+ */
 void Instance::read(string nameFile)
 {
-   ifstream infile(nameFile);
-   if (!infile)
-      throw std::runtime_error("Cannot read file");
+   uint64_t source_size = 0;
+   uint64_t source_checksum = 0;
+   auto cache_path = InstanceCache::CachePath(nameFile);
 
-   string line;
+   bool loaded = false;
+   if (Settings::kEnableInstanceCache)
+   {
+      MappedFile source(nameFile);
+      source_size = source.size();
+      source_checksum = InstanceCache::Checksum(source.begin(), source.size());
 
-   while (getline(infile, line))
+      loaded = InstanceCache::Load(cache_path, *this, source_size, source_checksum);
+      if (loaded)
+      {
+         PHALS_LOG(kInfo) << "Instance loaded from cache " << cache_path << endl;
+      }
+      else
+      {
+         // discard whatever an invalid cache left behind
+         *this = Instance();
+      }
+   }
+
+   if (!loaded)
    {
-      // if this line is empty, skip it
-      if (line.length() == 0)
+      parse(nameFile);
+
+      // remove dominated modes and infeasible arcs before any model is built
+      if (Settings::kEnablePreprocessing)
+         Preprocess();
+
+      // calculate tight big M values instead of a ridiculously large number
+      ComputeBigM();
+
+      if (Settings::kEnableInstanceCache && !InstanceCache::Write(cache_path, *this, source_size, source_checksum))
       {
-         continue;
+         PHALS_LOG(kWarning) << "Cannot write instance cache " << cache_path << endl;
       }
+   }
 
-      istringstream ss(line);
+   DetectIdenticalLines();
+}
+
+/**
+ * @brief Parses an instance file without any preprocessing
+ *
+ * The file is memory mapped and scanned line by line, numbers are converted directly from the mapped buffer, so no
+ * allocations happen per line except for comments.
+ *
+ * @param nameFile Path of the instance file
+ */
+void Instance::parse(string nameFile)
+{
+   parse(nameFile, nullptr);
+}
+
+/**
+ * @brief Parses an instance file without any preprocessing, but keeps only the setup times and stringer costs of
+ * transitions between the given coils. Transitions make up nearly the whole instance, so parts of a large instance can
+ * be parsed without holding all of its transitions, see RollingHorizon.
+ *
+ * @param transitionCoils Coils including the sentinel coils whose transitions are kept
+ */
+void Instance::parse(string nameFile, const std::set<Coil> &transitionCoils)
+{
+   parse(nameFile, &transitionCoils);
+}
 
-      char par_name;
+/**
+ * @brief Parses an instance file, see parse
+ *
+ * @param transitionCoils Coils whose transitions are kept, nullptr to keep all transitions
+ */
+void Instance::parse(string nameFile, const std::set<Coil> *transitionCoils)
+{
+   MappedFile file(nameFile);
 
-      ss >> par_name;
+   auto keep_transition = [transitionCoils](Coil coil1, Coil coil2)
+   { return transitionCoils == nullptr || (transitionCoils->count(coil1) > 0 && transitionCoils->count(coil2) > 0); };
 
-      switch (par_name) // Instead of using multiple if-statements, we use a switch statement: if(par_name == '')
+   // setup times and stringer costs make up nearly the whole file, they are collected and inserted in key order
+   vector<pair<tuple<Coil, Mode, Coil, Mode, ProductionLine>, SetupTime>> setupTimeRecords;
+   vector<pair<tuple<Coil, Mode, Coil, Mode, ProductionLine>, StringerCosts>> stringerRecords;
+
+   size_t lineNumber = 0;
+   for (const char *lineBegin = file.begin(); lineBegin < file.end();)
+   {
+      auto lineEnd = static_cast<const char *>(memchr(lineBegin, '\n', file.end() - lineBegin));
+      if (lineEnd == nullptr)
+         lineEnd = file.end();
+
+      LineScanner ss(lineBegin, lineEnd, ++lineNumber);
+      lineBegin = lineEnd + 1;
+
+      switch (ss.RecordType())
       {
       case 'X':
       {
-         string comment;
-         std::getline(ss, comment);
-
-         comment.erase(0, 1); // remove leading space due to not being removed because not reading from ss using >>
-         this->comments.push_back(comment);
-
+         this->comments.push_back(ss.Rest());
          break;
       }
       case 'I': // read number of coils
       {
-         ss >> this->numberOfCoils;
+         this->numberOfCoils = ss.Next<int>();
 
          // initialize all coil sets
          auto coil_sets = {&this->coils, &this->regularCoils, &this->coilsWithoutStartCoil, &this->coilsWithoutEndCoil};
@@ -63,39 +217,31 @@ void Instance::read(string nameFile)
       }
       case 'M':
       {
-         ss >> this->numberOfModes;
+         this->numberOfModes = ss.Next<int>();
          this->allModes.resize(this->numberOfModes);
          std::iota(std::begin(this->allModes), std::end(this->allModes), 0); // coils are indexed by 0,...,I-1
+         break;
       }
-
       case 'K': // read number of production lines
       {
-         ss >> this->numberOfProductionLines;
+         this->numberOfProductionLines = ss.Next<int>();
 
          this->productionLines.resize(this->numberOfProductionLines);
          std::iota(this->productionLines.begin(), this->productionLines.end(), 0); // production lines are indexed by 0,...,K-1
 
          break;
       }
-
       case 'a': // read max number of delayed coils
       {
-         ss >> this->maximumDelayedCoils;
+         this->maximumDelayedCoils = ss.Next<int>();
          break;
       }
       case 'm': // read number of modes per coil and production line
       {
-         Coil coil;
-         ProductionLine line;
-         Mode mode;
-
-         int numberOfModes;
-         bool modeEnabled;
-
-         ss >> coil;
-         ss >> line;
-         ss >> mode;
-         ss >> modeEnabled;
+         auto coil = ss.Next<Coil>();
+         auto line = ss.Next<ProductionLine>();
+         auto mode = ss.Next<Mode>();
+         bool modeEnabled = ss.Next<int>() != 0;
 
          if (modeEnabled)
             this->modes[make_tuple(coil, line)].push_back(mode);
@@ -104,71 +250,44 @@ void Instance::read(string nameFile)
       }
       case 'd': // read due date of coil
       {
-         Coil coil;
-         DueDate dueDate;
-
-         ss >> coil;
-         ss >> dueDate;
-
-         this->dueDates[coil] = dueDate;
+         auto coil = ss.Next<Coil>();
+         this->dueDates[coil] = ss.Next<DueDate>();
          break;
       }
       case 'p': // read processing time
       {
-         Coil coil;
-         ProductionLine line;
-         Mode mode;
-         ProcessingTime time;
+         auto coil = ss.Next<Coil>();
+         auto line = ss.Next<ProductionLine>();
+         auto mode = ss.Next<Mode>();
 
-         ss >> coil;
-         ss >> line;
-         ss >> mode;
-         ss >> time;
-
-         this->processingTimes[make_tuple(coil, line, mode)] = time;
+         this->processingTimes[make_tuple(coil, line, mode)] = ss.Next<ProcessingTime>();
          break;
       }
       case 't': // read setup time
       {
-         Coil coil1;
-         Mode mode1;
-         Coil coil2;
-         Mode mode2;
-         ProductionLine line;
-         SetupTime time;
-
-         ss >> coil1;
-         ss >> coil2;
-         ss >> line;
-         ss >> mode1;
-         ss >> mode2;
-         ss >> time;
+         auto coil1 = ss.Next<Coil>();
+         auto coil2 = ss.Next<Coil>();
+         auto line = ss.Next<ProductionLine>();
+         auto mode1 = ss.Next<Mode>();
+         auto mode2 = ss.Next<Mode>();
 
-         this->setupTimes[make_tuple(coil1, mode1, coil2, mode2, line)] = time;
+         auto time = ss.Next<SetupTime>();
+         if (keep_transition(coil1, coil2))
+            setupTimeRecords.emplace_back(make_tuple(coil1, mode1, coil2, mode2, line), time);
 
          break;
       }
       case 'c': // read stringer infos
       {
-         Coil coil1;
-         Mode mode1;
-         Coil coil2;
-         Mode mode2;
-         ProductionLine line;
-         StringerNeeded stringerNeeded = true;
-         StringerCosts stringerCosts;
-
-         ss >> coil1;
-         ss >> coil2;
-         ss >> line;
-         ss >> mode1;
-         ss >> mode2;
-         ss >> stringerCosts;
+         auto coil1 = ss.Next<Coil>();
+         auto coil2 = ss.Next<Coil>();
+         auto line = ss.Next<ProductionLine>();
+         auto mode1 = ss.Next<Mode>();
+         auto mode2 = ss.Next<Mode>();
 
-         auto tuple = make_tuple(coil1, mode1, coil2, mode2, line);
-
-         this->stringerNeeded[tuple] = stringerNeeded;
-         this->stringerCosts[tuple] = stringerCosts;
+         auto costs = ss.Next<StringerCosts>();
+         if (keep_transition(coil1, coil2))
+            stringerRecords.emplace_back(make_tuple(coil1, mode1, coil2, mode2, line), costs);
 
          break;
       }
@@ -176,36 +295,708 @@ void Instance::read(string nameFile)
       }
    }
 
+   InsertSorted(this->setupTimes, setupTimeRecords);
+   InsertSorted(this->stringerCosts, stringerRecords);
+   for (auto &[tuple, costs] : stringerRecords)
+   {
+      this->stringerNeeded.emplace_hint(this->stringerNeeded.end(), tuple, true);
+   }
+
    // initialize mode index sets for start and end coil: both can be produced on every line with every mode
    for (auto &line : this->productionLines)
    {
       modes[make_tuple(this->startCoil, line)] = {0};
       modes[make_tuple(this->endCoil, line)] = {0};
    }
+}
+
+/**
+ * @brief Get the processing time of a coil without inserting into the map
+ *
+ * @return ProcessingTime Processing time, 0 if coil cannot be produced with this mode on this line
+ */
+ProcessingTime Instance::GetProcessingTime(Coil coil, ProductionLine line, Mode mode) const
+{
+   auto entry = processingTimes.find(make_tuple(coil, line, mode));
+   return entry != processingTimes.end() ? entry->second : 0;
+}
+
+/**
+ * @brief Get the setup time between two coils without inserting into the map
+ *
+ * @return SetupTime Setup time, 0 if there is no entry
+ */
+SetupTime Instance::GetSetupTime(Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j, ProductionLine line) const
+{
+   auto entry = setupTimes.find(make_tuple(coil_i, mode_i, coil_j, mode_j, line));
+   return entry != setupTimes.end() ? entry->second : 0;
+}
 
-   infile.close();
+/**
+ * @brief Get the stringer cost of a transition without inserting into the map
+ *
+ * @return StringerCosts Stringer cost, 0 if no stringer is needed
+ */
+StringerCosts Instance::GetStringerCost(Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j, ProductionLine line) const
+{
+   auto entry = stringerCosts.find(make_tuple(coil_i, mode_i, coil_j, mode_j, line));
+   return entry != stringerCosts.end() ? entry->second : 0;
+}
+
+/**
+ * @brief Get the modes of a coil on a line without inserting into the map
+ *
+ * @return const vector<Mode>& Modes, empty if coil cannot be produced on this line
+ */
+const vector<Mode> &Instance::GetModes(Coil coil, ProductionLine line) const
+{
+   static const vector<Mode> no_modes;
+
+   auto entry = modes.find(make_tuple(coil, line));
+   return entry != modes.end() ? entry->second : no_modes;
+}
+
+/**
+ * @brief Computes upper bounds of start times and the big M values of the delay linking and start time linking
+ * constraints.
+ *
+ * Every schedule can be shifted such that every coil starts as early as possible without changing the sequence and
+ * without delaying any coil. Then the start time of coil i is at most the time needed to produce all other coils that
+ * may precede it, i.e. the sum of the longest processing time and the longest setup time to any successor of every
+ * other coil on this line. Bounding S_i by this value is valid and allows to derive
+ * - M of delay linking: latest completion of coil i minus its due date
+ * - M of start time linking (i, j): latest start of coil i minus earliest start of coil j, which is 0 since every coil
+ *   may be the first coil of a line
+ */
+void Instance::ComputeBigM()
+{
+   startTimeUpperBound.clear();
+   delayBigM.clear();
+   bigM.clear();
 
-   // calculate a better bound for big M than a ridiculously large number
    for (auto &line : productionLines)
    {
-      double bigM_value = 0;
-      for (auto &coil_i : coils)
+      // time coil c occupies the line at most before its successor may start
+      map<Coil, double> max_occupation_time;
+      map<Coil, double> max_processing_time;
+      for (auto &coil_c : regularCoils)
       {
-         for (auto &mode_i : modes[make_tuple(coil_i, line)])
+         double max_processing = 0;
+         double max_setup = 0;
+         for (auto &mode_c : GetModes(coil_c, line))
          {
-            bigM_value += processingTimes[make_tuple(coil_i, line, mode_i)];
-            for (auto &coil_j : coils)
+            max_processing = std::max(max_processing, GetProcessingTime(coil_c, line, mode_c));
+            for (auto &coil_d : regularCoils)
             {
-               for (auto &mode_j : modes[make_tuple(coil_j, line)])
+               if (coil_d == coil_c)
+                  continue;
+
+               for (auto &mode_d : GetModes(coil_d, line))
                {
-                  bigM_value += setupTimes[make_tuple(coil_i, mode_i, line, coil_j, mode_j)];
+                  max_setup = std::max(max_setup, (double)GetSetupTime(coil_c, mode_c, coil_d, mode_d, line));
                }
             }
          }
+
+         if (GetModes(coil_c, line).empty())
+            continue;
+
+         max_processing_time[coil_c] = max_processing;
+         max_occupation_time[coil_c] = max_processing + max_setup;
       }
 
-      bigM[line] = bigM_value;
+      double total_occupation_time = 0;
+      for (auto &[coil_c, occupation_time] : max_occupation_time)
+      {
+         total_occupation_time += occupation_time;
+      }
+
+      double line_horizon = 0;
+      for (auto &coil_i : regularCoils)
+      {
+         auto occupation_time = max_occupation_time.find(coil_i);
+
+         // coil cannot be produced on this line
+         if (occupation_time == max_occupation_time.end())
+         {
+            startTimeUpperBound[make_tuple(coil_i, line)] = 0;
+            delayBigM[make_tuple(coil_i, line)] = 0;
+            continue;
+         }
+
+         // all other coils may precede coil i
+         double start_time_bound = total_occupation_time - occupation_time->second;
+         double completion_time_bound = start_time_bound + max_processing_time[coil_i];
+
+         startTimeUpperBound[make_tuple(coil_i, line)] = start_time_bound;
+         delayBigM[make_tuple(coil_i, line)] = std::max(0.0, completion_time_bound - dueDates[coil_i]);
+
+         line_horizon = std::max(line_horizon, completion_time_bound);
+      }
+
+      // latest completion of any coil on this line
+      bigM[line] = line_horizon;
+   }
+}
+
+/**
+ * @brief Removes dominated modes and infeasible arcs, so that every model built from this instance gets smaller
+ *
+ * Mode m of coil c on a line is dominated by mode n if n has processing time, setup times and stringer costs to and
+ * from every neighbor that are less or equal. Replacing m by n in any schedule neither delays a coil nor increases
+ * costs, thus some optimal solution does not use m. Of equal modes the one with the smallest index is kept.
+ *
+ * An arc is infeasible if it is a self loop or forces more coils to be delayed than alpha allows: coil i is delayed
+ * in mode m if it cannot be finished in time even when started at 0, its successor j is delayed if it cannot be
+ * finished in time even when i starts at 0. If alpha is 0, modes in which a coil is always delayed are removed, too.
+ */
+void Instance::Preprocess()
+{
+   auto start = std::chrono::steady_clock::now();
+
+   auto count_modes = [this]()
+   {
+      int number_of_modes = 0;
+      for (auto &coil : regularCoils)
+      {
+         for (auto &line : productionLines)
+         {
+            number_of_modes += GetModes(coil, line).size();
+         }
+      }
+      return number_of_modes;
+   };
+
+   auto count_arcs = [this]()
+   {
+      int number_of_arcs = 0;
+      for (auto &line : productionLines)
+      {
+         for (auto &coil_i : coilsWithoutEndCoil)
+         {
+            for (auto &coil_j : coilsWithoutStartCoil)
+            {
+               if (!(IsStartCoil(coil_i) && IsEndCoil(coil_j)))
+                  number_of_arcs += GetModes(coil_i, line).size() * GetModes(coil_j, line).size();
+            }
+         }
+      }
+      return number_of_arcs;
+   };
+
+   numberOfModesBeforePreprocessing = count_modes();
+   numberOfArcsBeforePreprocessing = count_arcs();
+
+   // coil cannot be finished in time in this mode even if it is started first
+   auto always_delayed = [this](Coil coil, ProductionLine line, Mode mode)
+   {
+      return GetProcessingTime(coil, line, mode) > dueDates[coil];
+   };
+
+   // checks if mode_n is at least as good as mode_m with respect to every neighbor
+   auto dominates = [this](Coil coil, ProductionLine line, Mode mode_n, Mode mode_m)
+   {
+      if (GetProcessingTime(coil, line, mode_n) > GetProcessingTime(coil, line, mode_m))
+         return false;
+
+      for (auto &other_coil : coils)
+      {
+         if (other_coil == coil)
+            continue;
+
+         for (auto &other_mode : GetModes(other_coil, line))
+         {
+            // successor
+            if (!IsStartCoil(other_coil) &&
+                (GetSetupTime(coil, mode_n, other_coil, other_mode, line) > GetSetupTime(coil, mode_m, other_coil, other_mode, line) ||
+                 GetStringerCost(coil, mode_n, other_coil, other_mode, line) > GetStringerCost(coil, mode_m, other_coil, other_mode, line)))
+               return false;
+
+            // predecessor
+            if (!IsEndCoil(other_coil) &&
+                (GetSetupTime(other_coil, other_mode, coil, mode_n, line) > GetSetupTime(other_coil, other_mode, coil, mode_m, line) ||
+                 GetStringerCost(other_coil, other_mode, coil, mode_n, line) > GetStringerCost(other_coil, other_mode, coil, mode_m, line)))
+               return false;
+         }
+      }
+      return true;
+   };
+
+   // removing a mode may make further modes of its neighbors dominated, repeat until nothing changes
+   bool modes_removed = true;
+   while (modes_removed)
+   {
+      modes_removed = false;
+      for (auto &coil : regularCoils)
+      {
+         for (auto &line : productionLines)
+         {
+            auto entry = modes.find(make_tuple(coil, line));
+            if (entry == modes.end())
+               continue;
+
+            auto &coil_modes = entry->second;
+            for (size_t m = 0; m < coil_modes.size();)
+            {
+               bool dominated = maximumDelayedCoils == 0 && always_delayed(coil, line, coil_modes[m]);
+               for (size_t n = 0; n < coil_modes.size() && !dominated; n++)
+               {
+                  if (n == m)
+                     continue;
+
+                  // equal modes dominate each other, keep the first one
+                  dominated = dominates(coil, line, coil_modes[n], coil_modes[m]) &&
+                              (n < m || !dominates(coil, line, coil_modes[m], coil_modes[n]));
+               }
+
+               if (dominated)
+               {
+                  removedModes.insert(make_tuple(coil, line, coil_modes[m]));
+                  coil_modes.erase(coil_modes.begin() + m);
+                  modes_removed = true;
+               }
+               else
+               {
+                  m++;
+               }
+            }
+         }
+      }
+   }
+
+   numberOfModesAfterPreprocessing = count_modes();
+
+   // arcs
+   eliminatedArcs.clear();
+   for (auto &line : productionLines)
+   {
+      for (auto &coil_i : coilsWithoutEndCoil)
+      {
+         for (auto &coil_j : coilsWithoutStartCoil)
+         {
+            if (IsStartCoil(coil_i) && IsEndCoil(coil_j))
+               continue;
+
+            for (auto &mode_i : GetModes(coil_i, line))
+            {
+               for (auto &mode_j : GetModes(coil_j, line))
+               {
+                  bool eliminated = coil_i == coil_j;
+                  if (!eliminated && IsRegularCoil(coil_i) && IsRegularCoil(coil_j))
+                  {
+                     int forced_delays = always_delayed(coil_i, line, mode_i) ? 1 : 0;
+                     double earliest_completion_j = GetProcessingTime(coil_i, line, mode_i) +
+                                                    GetSetupTime(coil_i, mode_i, coil_j, mode_j, line) +
+                                                    GetProcessingTime(coil_j, line, mode_j);
+                     if (earliest_completion_j > dueDates[coil_j])
+                        forced_delays++;
+
+                     eliminated = forced_delays > maximumDelayedCoils;
+                  }
+
+                  if (eliminated)
+                     eliminatedArcs.insert(make_tuple(coil_i, mode_i, coil_j, mode_j, line));
+               }
+            }
+         }
+      }
    }
+   numberOfArcsAfterPreprocessing = count_arcs() - eliminatedArcs.size();
+
+   auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+   PHALS_LOG(kInfo) << "Preprocessing: " << numberOfModesAfterPreprocessing << "/" << numberOfModesBeforePreprocessing << " modes and "
+                    << numberOfArcsAfterPreprocessing << "/" << numberOfArcsBeforePreprocessing << " arcs kept in " << duration << "s" << endl;
+}
+
+/**
+ * @brief Checks if an arc was removed by preprocessing, i.e. if no X variable exists for it
+ */
+bool Instance::IsArcEliminated(Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j, ProductionLine line) const
+{
+   assert(!preprocessingDataReleased);
+   return eliminatedArcs.count(make_tuple(coil_i, mode_i, coil_j, mode_j, line)) > 0;
+}
+
+/**
+ * @brief Frees data that is only needed for preprocessing and building the models. Once every model is built, no
+ * variable exists for removed modes and eliminated arcs, so their processing times, setup times and stringer costs
+ * are dropped together with the eliminated arcs themselves and the stringer flags.
+ */
+void Instance::ReleasePreprocessingData()
+{
+   if (preprocessingDataReleased)
+      return;
+
+   std::set<tuple<Coil, ProductionLine, Mode>> kept_modes;
+   for (auto &[coil_line, coil_modes] : modes)
+   {
+      for (auto &mode : coil_modes)
+      {
+         kept_modes.insert(make_tuple(get<0>(coil_line), get<1>(coil_line), mode));
+      }
+   }
+
+   auto is_arc_kept = [&](const tuple<Coil, Mode, Coil, Mode, ProductionLine> &arc)
+   {
+      auto &[coil_i, mode_i, coil_j, mode_j, line] = arc;
+      return kept_modes.count(make_tuple(coil_i, line, mode_i)) > 0 && kept_modes.count(make_tuple(coil_j, line, mode_j)) > 0 &&
+             eliminatedArcs.count(arc) == 0;
+   };
+
+   size_t entries_before = processingTimes.size() + setupTimes.size() + stringerCosts.size();
+
+   for (auto entry = processingTimes.begin(); entry != processingTimes.end();)
+   {
+      entry = kept_modes.count(entry->first) > 0 ? std::next(entry) : processingTimes.erase(entry);
+   }
+
+   for (auto entry = setupTimes.begin(); entry != setupTimes.end();)
+   {
+      entry = is_arc_kept(entry->first) ? std::next(entry) : setupTimes.erase(entry);
+   }
+
+   for (auto entry = stringerCosts.begin(); entry != stringerCosts.end();)
+   {
+      entry = is_arc_kept(entry->first) ? std::next(entry) : stringerCosts.erase(entry);
+   }
+
+   size_t entries_after = processingTimes.size() + setupTimes.size() + stringerCosts.size();
+
+   stringerNeeded.clear();
+   eliminatedArcs.clear();
+   removedModes.clear();
+   preprocessingDataReleased = true;
+
+   PHALS_LOG(kInfo) << "Released preprocessing data: " << entries_after << "/" << entries_before << " time and cost entries kept" << endl;
+}
+
+/**
+ * @brief Groups lines that are identical, i.e. can be exchanged in every solution without changing its cost or
+ * feasibility. Used for aggregated pricing in the master problem and symmetry breaking in the compact model.
+ */
+void Instance::DetectIdenticalLines()
+{
+   lineRepresentative.clear();
+   identicalLines.clear();
+
+   for (auto &line : productionLines)
+   {
+      ProductionLine representative = line;
+      for (auto &[other_representative, _] : identicalLines)
+      {
+         if (AreLinesIdentical(other_representative, line))
+         {
+            representative = other_representative;
+            break;
+         }
+      }
+
+      lineRepresentative[line] = representative;
+      identicalLines[representative].push_back(line);
+   }
+
+   for (auto &[representative, lines] : identicalLines)
+   {
+      if (lines.size() > 1)
+      {
+         PHALS_LOG(kInfo) << "Lines identical to line " << representative << ": " << lines.size() << endl;
+      }
+   }
+}
+
+/**
+ * @brief Applies coil removals and insertions, due date changes and a new maximum number of delayed coils. Modes
+ * removed by preprocessing are restored first, since a change may make them relevant again, afterwards preprocessing,
+ * big M values and identical lines are computed again for the changed instance.
+ *
+ * Removed coils leave a gap in the numbering of the regular coils. Added coils are numbered after the last regular
+ * coil, thus the end coil is renumbered behind them. A delta referring to coils the changed instance does not have is
+ * rejected before anything is changed.
+ */
+void Instance::ApplyDelta(const InstanceDelta &delta)
+{
+   if (preprocessingDataReleased)
+      throw std::logic_error("Cannot change an instance after its preprocessing data was released");
+
+   // the instance is only changed once the whole delta is known to be valid, added coils are complete since
+   // InstanceDelta::Read validates them
+   auto is_regular_coil = [this](Coil coil)
+   { return std::binary_search(regularCoils.begin(), regularCoils.end(), coil); };
+   auto is_added_coil = [&delta](Coil coil)
+   { return std::count(delta.added_coils.begin(), delta.added_coils.end(), coil) > 0; };
+   auto is_delta_coil = [&](Coil coil)
+   {
+      bool is_removed = std::count(delta.removed_coils.begin(), delta.removed_coils.end(), coil) > 0;
+      return (is_regular_coil(coil) && !is_removed) || is_added_coil(coil);
+   };
+
+   for (auto &coil : delta.removed_coils)
+   {
+      if (!is_regular_coil(coil))
+         throw std::invalid_argument("Removed coil " + std::to_string(coil) + " is not a coil of the instance");
+   }
+   for (auto &coil : delta.added_coils)
+   {
+      if (coil < endCoil || is_regular_coil(coil))
+         throw std::invalid_argument("Added coil " + std::to_string(coil) + " has to be numbered after every existing coil");
+   }
+   for (auto &[coil, due_date] : delta.due_dates)
+   {
+      if (!is_delta_coil(coil))
+         throw std::invalid_argument("Due date of coil " + std::to_string(coil) + ", which is not a coil of the changed instance");
+   }
+   auto check_arcs = [&](const auto &arcs, const string &data)
+   {
+      for (auto &[arc, value] : arcs)
+      {
+         for (auto coil : {get<0>(arc), get<2>(arc)})
+         {
+            if (coil != startCoil && coil != InstanceDelta::kEndCoil && !is_delta_coil(coil))
+               throw std::invalid_argument(data + " of coil " + std::to_string(coil) + ", which is not a coil of the changed instance");
+         }
+      }
+   };
+   check_arcs(delta.setup_times, "Setup time");
+   check_arcs(delta.stringer_costs, "Stringer cost");
+
+   for (auto &[coil, line, mode] : removedModes)
+   {
+      auto &coil_modes = modes[make_tuple(coil, line)];
+      coil_modes.insert(std::lower_bound(coil_modes.begin(), coil_modes.end(), mode), mode);
+   }
+   removedModes.clear();
+   eliminatedArcs.clear();
+
+   // removed coils
+   std::set<Coil> removed(delta.removed_coils.begin(), delta.removed_coils.end());
+   auto erase_coils = [&removed](auto &map, auto coils_of_key)
+   {
+      for (auto entry = map.begin(); entry != map.end();)
+      {
+         entry = coils_of_key(entry->first) ? map.erase(entry) : std::next(entry);
+      }
+   };
+   auto is_removed = [&removed](Coil coil)
+   { return removed.count(coil) > 0; };
+   auto arc_is_removed = [&](const tuple<Coil, Mode, Coil, Mode, ProductionLine> &arc)
+   { return is_removed(get<0>(arc)) || is_removed(get<2>(arc)); };
+
+   erase_coils(modes, [&](const tuple<Coil, ProductionLine> &key)
+               { return is_removed(get<0>(key)); });
+   erase_coils(processingTimes, [&](const tuple<Coil, ProductionLine, Mode> &key)
+               { return is_removed(get<0>(key)); });
+   erase_coils(setupTimes, arc_is_removed);
+   erase_coils(stringerNeeded, arc_is_removed);
+   erase_coils(stringerCosts, arc_is_removed);
+   for (auto &coil : removed)
+   {
+      dueDates.erase(coil);
+   }
+   regularCoils.erase(std::remove_if(regularCoils.begin(), regularCoils.end(), is_removed), regularCoils.end());
+
+   // the end coil follows the added coils
+   Coil new_end_coil = endCoil;
+   for (auto &coil : delta.added_coils)
+   {
+      regularCoils.push_back(coil);
+      new_end_coil = std::max(new_end_coil, coil + 1);
+   }
+   std::sort(regularCoils.begin(), regularCoils.end());
+
+   if (new_end_coil != endCoil)
+   {
+      auto renumber = [this, new_end_coil](Coil coil)
+      { return coil == endCoil ? new_end_coil : coil; };
+      auto renumber_arcs = [&renumber](auto &map)
+      {
+         std::remove_reference_t<decltype(map)> renumbered;
+         for (auto &[arc, value] : map)
+         {
+            auto &[coil_i, mode_i, coil_j, mode_j, line] = arc;
+            renumbered.emplace(make_tuple(renumber(coil_i), mode_i, renumber(coil_j), mode_j, line), value);
+         }
+         map = std::move(renumbered);
+      };
+
+      renumber_arcs(setupTimes);
+      renumber_arcs(stringerNeeded);
+      renumber_arcs(stringerCosts);
+      for (auto &line : productionLines)
+      {
+         modes.erase(make_tuple(endCoil, line));
+         modes[make_tuple(new_end_coil, line)] = {0};
+      }
+
+      endCoil = new_end_coil;
+   }
+   numberOfCoils = endCoil;
+
+   auto delta_coil = [this](Coil coil)
+   { return coil == InstanceDelta::kEndCoil ? endCoil : coil; };
+   for (auto &[key, coil_modes] : delta.modes)
+   {
+      modes[key] = coil_modes;
+   }
+   for (auto &[key, time] : delta.processing_times)
+   {
+      processingTimes[key] = time;
+   }
+   for (auto &[arc, time] : delta.setup_times)
+   {
+      auto &[coil_i, mode_i, coil_j, mode_j, line] = arc;
+      setupTimes[make_tuple(delta_coil(coil_i), mode_i, delta_coil(coil_j), mode_j, line)] = time;
+   }
+   for (auto &[arc, cost] : delta.stringer_costs)
+   {
+      auto &[coil_i, mode_i, coil_j, mode_j, line] = arc;
+      auto tuple = make_tuple(delta_coil(coil_i), mode_i, delta_coil(coil_j), mode_j, line);
+      stringerCosts[tuple] = cost;
+      stringerNeeded[tuple] = true;
+   }
+
+   for (auto &[coil, due_date] : delta.due_dates)
+   {
+      dueDates[coil] = due_date;
+   }
+   if (delta.maximum_delayed_coils >= 0)
+      maximumDelayedCoils = delta.maximum_delayed_coils;
+
+   // coil sets in the order of parse
+   coils = coilsWithoutStartCoil = coilsWithoutEndCoil = regularCoils;
+   coils.push_back(startCoil);
+   coils.push_back(endCoil);
+   coilsWithoutEndCoil.push_back(startCoil);
+   coilsWithoutStartCoil.push_back(endCoil);
+
+   if (Settings::kEnablePreprocessing)
+      Preprocess();
+   ComputeBigM();
+   DetectIdenticalLines();
+
+   PHALS_LOG(kInfo) << "Instance changed: " << delta.removed_coils.size() << " coils removed, " << delta.added_coils.size()
+                    << " coils added, " << delta.due_dates.size() << " due dates set, now " << regularCoils.size() << " coils" << endl;
+}
+
+/**
+ * @brief Checks if two lines have the same modes, processing times, setup times, stringer costs and eliminated arcs
+ * for every coil
+ */
+bool Instance::AreLinesIdentical(ProductionLine line_a, ProductionLine line_b) const
+{
+   if (line_a == line_b)
+      return true;
+
+   for (auto &coil : regularCoils)
+   {
+      if (GetModes(coil, line_a) != GetModes(coil, line_b))
+         return false;
+
+      for (auto &mode : GetModes(coil, line_a))
+      {
+         if (GetProcessingTime(coil, line_a, mode) != GetProcessingTime(coil, line_b, mode))
+            return false;
+      }
+   }
+
+   auto stringer_needed = [this](Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j, ProductionLine line)
+   {
+      auto entry = stringerNeeded.find(make_tuple(coil_i, mode_i, coil_j, mode_j, line));
+      return entry != stringerNeeded.end() && entry->second;
+   };
+
+   for (auto &coil_i : coilsWithoutEndCoil)
+   {
+      for (auto &coil_j : coilsWithoutStartCoil)
+      {
+         for (auto &mode_i : GetModes(coil_i, line_a))
+         {
+            for (auto &mode_j : GetModes(coil_j, line_a))
+            {
+               if (GetSetupTime(coil_i, mode_i, coil_j, mode_j, line_a) != GetSetupTime(coil_i, mode_i, coil_j, mode_j, line_b) ||
+                   GetStringerCost(coil_i, mode_i, coil_j, mode_j, line_a) != GetStringerCost(coil_i, mode_i, coil_j, mode_j, line_b) ||
+                   stringer_needed(coil_i, mode_i, coil_j, mode_j, line_a) != stringer_needed(coil_i, mode_i, coil_j, mode_j, line_b) ||
+                   IsArcEliminated(coil_i, mode_i, coil_j, mode_j, line_a) != IsArcEliminated(coil_i, mode_i, coil_j, mode_j, line_b))
+                  return false;
+            }
+         }
+      }
+   }
+
+   return true;
+}
+
+/**
+ * @brief Smallest line of every group of identical lines, in ascending order
+ */
+vector<ProductionLine> Instance::GetRepresentativeLines() const
+{
+   vector<ProductionLine> representatives;
+   for (auto &[representative, _] : identicalLines)
+   {
+      representatives.push_back(representative);
+   }
+   return representatives;
+}
+
+/**
+ * @brief Upper bound of the start time of a coil on a line, see ComputeBigM
+ */
+double Instance::GetStartTimeUpperBound(Coil coil, ProductionLine line) const
+{
+   auto entry = startTimeUpperBound.find(make_tuple(coil, line));
+   return entry != startTimeUpperBound.end() ? entry->second : 0;
+}
+
+/**
+ * @brief Upper bound of the start time of a coil on any line, see ComputeBigM
+ */
+double Instance::GetStartTimeUpperBound(Coil coil) const
+{
+   double bound = 0;
+   for (auto &line : productionLines)
+   {
+      bound = std::max(bound, GetStartTimeUpperBound(coil, line));
+   }
+   return bound;
+}
+
+/**
+ * @brief Big M of the delay linking constraint of a coil on a line
+ */
+double Instance::GetDelayBigM(Coil coil, ProductionLine line) const
+{
+   auto entry = delayBigM.find(make_tuple(coil, line));
+   return entry != delayBigM.end() ? entry->second : 0;
+}
+
+/**
+ * @brief Big M of the delay linking constraint of a coil on any line
+ */
+double Instance::GetDelayBigM(Coil coil) const
+{
+   double big_M = 0;
+   for (auto &line : productionLines)
+   {
+      big_M = std::max(big_M, GetDelayBigM(coil, line));
+   }
+   return big_M;
+}
+
+/**
+ * @brief Big M of the start time linking constraint of coil i and coil j on a line. Since every coil may be the first
+ * coil of a line, the earliest start of coil j is 0.
+ */
+double Instance::GetStartTimeBigM(Coil coil_i, [[maybe_unused]] Coil coil_j, ProductionLine line) const
+{
+   return GetStartTimeUpperBound(coil_i, line);
+}
+
+/**
+ * @brief Big M of the start time linking constraint of coil i and coil j on any line
+ */
+double Instance::GetStartTimeBigM(Coil coil_i, [[maybe_unused]] Coil coil_j) const
+{
+   return GetStartTimeUpperBound(coil_i);
 }
 
 void Instance::display()
@@ -250,102 +1041,104 @@ void Instance::display()
    }
 }
 
-void Instance::printStructured()
+/**
+ * @brief Writes the instance in the .cal format, i.e. the result can be read by read
+ *
+ * Sentinel coils and derived data are not written. Transitions are only written if a stringer is needed.
+ *
+ * @param os Stream the instance is written to
+ */
+void Instance::printStructured(ostream &os) const
 {
-   auto &os = cout;
+   for (auto &comment : comments)
+   {
+      os << "X " << comment << "\n";
+   }
+   os << "----------------------------------------------\n\n";
+
+   os << "I " << numberOfCoils << "\n\n";
+   os << "K " << numberOfProductionLines << "\n\n";
+   os << "M " << numberOfModes << "\n\n";
 
    // print modes per coil
-   for (Coil &coil_i : coils)
+   for (const Coil &coil_i : regularCoils)
    {
-      if (!IsRegularCoil(coil_i))
-         continue;
-      for (ProductionLine &line : productionLines)
+      for (const ProductionLine &line : productionLines)
       {
-         for (Mode &mode_i : modes[make_tuple(coil_i, line)])
+         for (const Mode &mode_i : GetModes(coil_i, line))
          {
-            os << "m " << coil_i << " " << line << " " << mode_i << " 1" << endl;
+            os << "m " << coil_i << " " << line << " " << mode_i << " 1\n";
          }
       }
    }
 
-   os << endl;
+   os << "\n";
+
+   // print alpha
+   os << "a " << maximumDelayedCoils << "\n\n";
 
    // print processing time
-   for (Coil &coil_i : coils)
+   for (const Coil &coil_i : regularCoils)
    {
-      if (!IsRegularCoil(coil_i))
-         continue;
-
-      for (ProductionLine &line : productionLines)
+      for (const ProductionLine &line : productionLines)
       {
-         for (Mode &mode_i : modes[make_tuple(coil_i, line)])
+         for (const Mode &mode_i : GetModes(coil_i, line))
          {
-            os << "p " << coil_i << " " << line << " " << mode_i << " " << processingTimes[make_tuple(coil_i, line, mode_i)] << endl;
+            os << "p " << coil_i << " " << line << " " << mode_i << " " << GetProcessingTime(coil_i, line, mode_i) << "\n";
          }
       }
    }
 
-   os << endl;
+   os << "\n";
 
-   // print stringer costs
-   for (Coil &coil_i : coils)
+   // print due dates
+   for (const Coil &coil_i : regularCoils)
    {
-      for (Coil &coil_j : coils)
-      {
-         if (!IsRegularCoil(coil_i) || !IsRegularCoil(coil_j))
-            continue;
-
-         for (ProductionLine &line : productionLines)
-         {
-            for (Mode &mode_i : modes[make_tuple(coil_i, line)])
-            {
-               for (Mode &mode_j : modes[make_tuple(coil_j, line)])
-               {
-                  auto tuple = make_tuple(coil_i, mode_i, coil_j, mode_j, line);
-                  if (stringerNeeded[tuple])
-                  {
-
-                     os << "c " << coil_i << " " << coil_j << " " << line << " " << mode_i << " " << mode_j << " " << stringerCosts[tuple] << endl;
-                  }
-               }
-            }
-         }
-      }
+      auto due_date = dueDates.find(coil_i);
+      if (due_date != dueDates.end())
+         os << "d " << coil_i << " " << due_date->second << "\n";
    }
 
-   os << endl;
+   os << "\n";
 
-   // print stringer times
-   for (Coil &coil_i : coils)
+   // prints a record of every transition of regular coils that needs a stringer
+   auto print_transitions = [this, &os](char record, const auto &values)
    {
-      for (Coil &coil_j : coils)
+      for (const Coil &coil_i : regularCoils)
       {
-         if (!IsRegularCoil(coil_i) || !IsRegularCoil(coil_j))
-            continue;
-
-         for (ProductionLine &line : productionLines)
+         for (const Coil &coil_j : regularCoils)
          {
-            for (Mode &mode_i : modes[make_tuple(coil_i, line)])
+            for (const ProductionLine &line : productionLines)
             {
-               for (Mode &mode_j : modes[make_tuple(coil_j, line)])
+               for (const Mode &mode_i : GetModes(coil_i, line))
                {
-                  auto tuple = make_tuple(coil_i, mode_i, coil_j, mode_j, line);
-                  if (stringerNeeded[tuple])
+                  for (const Mode &mode_j : GetModes(coil_j, line))
                   {
+                     auto tuple = make_tuple(coil_i, mode_i, coil_j, mode_j, line);
+                     auto stringer_needed = stringerNeeded.find(tuple);
+                     if (stringer_needed == stringerNeeded.end() || !stringer_needed->second)
+                        continue;
 
-                     os << "t " << coil_i << " " << coil_j << " " << line << " " << mode_i << " " << mode_j << " " << setupTimes[tuple] << endl;
+                     auto value = values.find(tuple);
+                     os << record << " " << coil_i << " " << coil_j << " " << line << " " << mode_i << " " << mode_j << " "
+                        << (value != values.end() ? value->second : 0) << "\n";
                   }
                }
             }
          }
       }
-   }
+      os << "\n";
+   };
 
-   // print alpha
-   os << "a " << maximumDelayedCoils;
+   // print stringer costs
+   print_transitions('c', stringerCosts);
 
-   os << endl;
+   // print stringer times
+   print_transitions('t', setupTimes);
+
+   os.flush();
 }
+
 bool Instance::IsStartCoil(Coil i)
 {
    return i == this->startCoil;
@@ -5,6 +5,7 @@
 #include <sstream>
 #include <vector>
 #include <map>
+#include <set>
 
 using namespace std;
 
@@ -20,6 +21,9 @@ using ProcessingTime = double;
 using SetupTime = OurTime;
 
 using std::tuple, std::map, std::pair;
+
+struct InstanceDelta;
+
 class Instance
 {
 public:
@@ -49,9 +53,38 @@ public:
    map<tuple<Coil, Mode, Coil, Mode, ProductionLine>, StringerNeeded> stringerNeeded;
    map<tuple<Coil, Mode, Coil, Mode, ProductionLine>, StringerCosts> stringerCosts;
 
+   // latest completion time of any coil per line
    map<ProductionLine, double> bigM;
-   
+
+   // preprocessed bounds of start times and big M values, see ComputeBigM
+   map<tuple<Coil, ProductionLine>, double> startTimeUpperBound;
+   map<tuple<Coil, ProductionLine>, double> delayBigM;
+
+   // arcs removed by preprocessing, no X variable is created for them, see Preprocess
+   std::set<tuple<Coil, Mode, Coil, Mode, ProductionLine>> eliminatedArcs;
+
+   // lines with identical modes, processing times, setup times and stringer costs, see DetectIdenticalLines
+   // every line is mapped to the smallest line identical to it, its representative
+   map<ProductionLine, ProductionLine> lineRepresentative;
+   // lines identical to a representative line including itself, in ascending order
+   map<ProductionLine, vector<ProductionLine>> identicalLines;
+
+   // modes removed by Preprocess, they are restored before the instance is changed by ApplyDelta
+   std::set<tuple<Coil, ProductionLine, Mode>> removedModes;
+
+   // set by ReleasePreprocessingData, afterwards eliminated arcs and stringer flags are no longer available
+   bool preprocessingDataReleased = false;
+
+   // reduction statistics of Preprocess
+   int numberOfModesBeforePreprocessing = 0;
+   int numberOfModesAfterPreprocessing = 0;
+   int numberOfArcsBeforePreprocessing = 0;
+   int numberOfArcsAfterPreprocessing = 0;
+
    void read(string nameFile);      // function to read data from a file
+   void parse(string nameFile);     // function to read data from a file without preprocessing
+   // function to read data from a file without preprocessing, keeping only the transitions between the given coils
+   void parse(string nameFile, const std::set<Coil> &transitionCoils);
    void readPhals(string nameFile); // function to read data from a phals file
 
    void display(); // function to display the data
@@ -59,5 +92,30 @@ public:
    bool IsStartCoil(Coil i);
    bool IsEndCoil(Coil i);
    bool IsRegularCoil(Coil i);
-   void printStructured();
+
+   // lookups that do not insert into the maps
+   ProcessingTime GetProcessingTime(Coil coil, ProductionLine line, Mode mode) const;
+   SetupTime GetSetupTime(Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j, ProductionLine line) const;
+   StringerCosts GetStringerCost(Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j, ProductionLine line) const;
+   const vector<Mode> &GetModes(Coil coil, ProductionLine line) const;
+
+   void Preprocess();
+   bool IsArcEliminated(Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j, ProductionLine line) const;
+
+   void ComputeBigM();
+   void DetectIdenticalLines();
+   void ReleasePreprocessingData();
+   void ApplyDelta(const InstanceDelta &delta);
+   bool AreLinesIdentical(ProductionLine line_a, ProductionLine line_b) const;
+   vector<ProductionLine> GetRepresentativeLines() const;
+   double GetStartTimeUpperBound(Coil coil, ProductionLine line) const;
+   double GetStartTimeUpperBound(Coil coil) const;
+   double GetDelayBigM(Coil coil, ProductionLine line) const;
+   double GetDelayBigM(Coil coil) const;
+   double GetStartTimeBigM(Coil coil_i, Coil coil_j, ProductionLine line) const;
+   double GetStartTimeBigM(Coil coil_i, Coil coil_j) const;
+   void printStructured(ostream &os = cout) const; // function to write the instance in the format read by read
+
+private:
+   void parse(string nameFile, const std::set<Coil> *transitionCoils);
 };
\ No newline at end of file
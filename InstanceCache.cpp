@@ -0,0 +1,512 @@
+#include "InstanceCache.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <type_traits>
+
+#include "MappedFile.h"
+#include "Settings.h"
+
+namespace
+{
+   // layout of the cache file: header followed by the sections in the order of Section, every section starts with a
+   // SectionHeader and is padded to a multiple of 8 bytes
+   enum class Section : uint32_t
+   {
+      kScalars = 0,
+      kComments,
+      kCoils,
+      kRegularCoils,
+      kCoilsWithoutStartCoil,
+      kCoilsWithoutEndCoil,
+      kProductionLines,
+      kAllModes,
+      kModes,
+      kDueDates,
+      kProcessingTimes,
+      kSetupTimes,
+      kStringerCosts,
+      kEliminatedArcs,
+      kBounds,
+      kBigM,
+      kRemovedModes
+   };
+
+   struct Header
+   {
+      char magic[8];
+      uint32_t version;
+      // settings the derived data depends on
+      uint32_t preprocessing;
+      uint64_t source_size;
+      uint64_t source_checksum;
+   };
+
+   struct SectionHeader
+   {
+      uint32_t section;
+      uint32_t record_size;
+      uint64_t count;
+   };
+
+   struct ScalarRecord
+   {
+      int32_t number_of_coils;
+      int32_t number_of_production_lines;
+      int32_t number_of_modes;
+      int32_t maximum_delayed_coils;
+      int32_t start_coil;
+      int32_t end_coil;
+      int32_t modes_before_preprocessing;
+      int32_t modes_after_preprocessing;
+      int32_t arcs_before_preprocessing;
+      int32_t arcs_after_preprocessing;
+   };
+
+   struct ModeRecord
+   {
+      int32_t coil;
+      int32_t line;
+      int32_t mode;
+   };
+
+   struct DueDateRecord
+   {
+      int32_t coil;
+      int32_t due_date;
+   };
+
+   struct ProcessingTimeRecord
+   {
+      int32_t coil;
+      int32_t line;
+      int32_t mode;
+      int32_t padding;
+      double time;
+   };
+
+   // setup times, stringer costs and eliminated arcs, value is unused for eliminated arcs
+   struct ArcRecord
+   {
+      int32_t coil_i;
+      int32_t mode_i;
+      int32_t coil_j;
+      int32_t mode_j;
+      int32_t line;
+      int32_t value;
+   };
+
+   struct BoundRecord
+   {
+      int32_t coil;
+      int32_t line;
+      double start_time_upper_bound;
+      double delay_big_M;
+   };
+
+   struct BigMRecord
+   {
+      int32_t line;
+      int32_t padding;
+      double big_M;
+   };
+
+   constexpr char kMagic[8] = {'P', 'H', 'A', 'L', 'S', 'B', 'I', 'N'};
+
+   static_assert(sizeof(Header) % 8 == 0 && sizeof(SectionHeader) % 8 == 0);
+   static_assert(std::is_trivially_copyable_v<ScalarRecord> && std::is_trivially_copyable_v<ArcRecord>);
+
+   size_t Padding(size_t size)
+   {
+      return (8 - size % 8) % 8;
+   }
+
+   /**
+    * @brief Appends sections to a cache file
+    */
+   class Writer
+   {
+   public:
+      explicit Writer(FILE *file) : file_(file) {}
+
+      template <typename Record>
+      void WriteSection(Section section, const vector<Record> &records)
+      {
+         WriteRaw(section, sizeof(Record), records.size(), records.data(), records.size() * sizeof(Record));
+      }
+
+      void WriteRaw(Section section, uint32_t recordSize, uint64_t count, const void *data, size_t size)
+      {
+         SectionHeader header{static_cast<uint32_t>(section), recordSize, count};
+         Write(&header, sizeof(header));
+         Write(data, size);
+
+         static const char zeros[8] = {};
+         Write(zeros, Padding(size));
+      }
+
+      void Write(const void *data, size_t size)
+      {
+         if (size > 0 && fwrite(data, 1, size, file_) != size)
+            good_ = false;
+      }
+
+      bool good() const { return good_; }
+
+   private:
+      FILE *file_;
+      bool good_ = true;
+   };
+
+   /**
+    * @brief Reads sections of a mapped cache file in place
+    */
+   class Reader
+   {
+   public:
+      Reader(const char *begin, const char *end) : current_(begin), end_(end) {}
+
+      // pointer to the records of the next section, nullptr if the section does not match
+      template <typename Record>
+      const Record *ReadSection(Section section, uint64_t &count)
+      {
+         return static_cast<const Record *>(ReadRaw(section, sizeof(Record), count));
+      }
+
+      const void *ReadRaw(Section section, uint32_t recordSize, uint64_t &count)
+      {
+         if (end_ - current_ < (ptrdiff_t)sizeof(SectionHeader))
+            return nullptr;
+
+         auto header = reinterpret_cast<const SectionHeader *>(current_);
+         if (header->section != static_cast<uint32_t>(section) || header->record_size != recordSize)
+            return nullptr;
+
+         size_t size = header->count * recordSize;
+         if ((size_t)(end_ - current_) < sizeof(SectionHeader) + size + Padding(size))
+            return nullptr;
+
+         auto data = current_ + sizeof(SectionHeader);
+         current_ = data + size + Padding(size);
+         count = header->count;
+         return data;
+      }
+
+   private:
+      const char *current_;
+      const char *end_;
+   };
+
+   vector<int32_t> ToRecords(const vector<int> &values)
+   {
+      return vector<int32_t>(values.begin(), values.end());
+   }
+
+   bool FromRecords(Reader &reader, Section section, vector<int> &values)
+   {
+      uint64_t count;
+      auto records = reader.ReadSection<int32_t>(section, count);
+      if (records == nullptr)
+         return false;
+
+      values.assign(records, records + count);
+      return true;
+   }
+}
+
+/**
+ * @brief Path of the cache of an instance file, stored next to it
+ */
+std::string InstanceCache::CachePath(const std::string &instancePath)
+{
+   return instancePath + ".bin";
+}
+
+uint64_t InstanceCache::Checksum(const char *data, size_t size)
+{
+   uint64_t hash = 14695981039346656037ull;
+   for (size_t i = 0; i < size; i++)
+   {
+      hash ^= static_cast<unsigned char>(data[i]);
+      hash *= 1099511628211ull;
+   }
+   return hash;
+}
+
+/**
+ * @brief Writes a read instance to a cache file. The file is written under a unique temporary name and renamed
+ * afterwards, so concurrent runs and jobs never see a partial cache.
+ *
+ * @return true if the cache was written
+ */
+bool InstanceCache::Write(const std::string &cachePath, const Instance &instance, uint64_t sourceSize, uint64_t sourceChecksum)
+{
+   // the name is unique within and across processes, so jobs caching the same instance never share a temporary file
+   auto temporary_path = cachePath + ".tmpXXXXXX";
+   int fd = mkstemp(&temporary_path[0]);
+   if (fd < 0)
+      return false;
+
+   FILE *file = fdopen(fd, "wb");
+   if (file == nullptr)
+   {
+      close(fd);
+      std::remove(temporary_path.c_str());
+      return false;
+   }
+
+   Writer writer(file);
+
+   Header header{};
+   std::memcpy(header.magic, kMagic, sizeof(kMagic));
+   header.version = kVersion;
+   header.preprocessing = Settings::kEnablePreprocessing ? 1 : 0;
+   header.source_size = sourceSize;
+   header.source_checksum = sourceChecksum;
+   writer.Write(&header, sizeof(header));
+
+   ScalarRecord scalars{instance.numberOfCoils, instance.numberOfProductionLines, instance.numberOfModes,
+                        instance.maximumDelayedCoils, instance.startCoil, instance.endCoil,
+                        instance.numberOfModesBeforePreprocessing, instance.numberOfModesAfterPreprocessing,
+                        instance.numberOfArcsBeforePreprocessing, instance.numberOfArcsAfterPreprocessing};
+   writer.WriteSection(Section::kScalars, vector<ScalarRecord>{scalars});
+
+   // comments never contain line breaks, thus they are stored separated by them
+   std::string comments;
+   for (auto &comment : instance.comments)
+   {
+      comments += comment;
+      comments += '\n';
+   }
+   writer.WriteRaw(Section::kComments, 1, comments.size(), comments.data(), comments.size());
+
+   writer.WriteSection(Section::kCoils, ToRecords(instance.coils));
+   writer.WriteSection(Section::kRegularCoils, ToRecords(instance.regularCoils));
+   writer.WriteSection(Section::kCoilsWithoutStartCoil, ToRecords(instance.coilsWithoutStartCoil));
+   writer.WriteSection(Section::kCoilsWithoutEndCoil, ToRecords(instance.coilsWithoutEndCoil));
+   writer.WriteSection(Section::kProductionLines, ToRecords(instance.productionLines));
+   writer.WriteSection(Section::kAllModes, ToRecords(instance.allModes));
+
+   vector<ModeRecord> modes;
+   for (auto &[key, coil_modes] : instance.modes)
+   {
+      for (auto &mode : coil_modes)
+      {
+         modes.push_back({std::get<0>(key), std::get<1>(key), mode});
+      }
+   }
+   writer.WriteSection(Section::kModes, modes);
+
+   vector<DueDateRecord> due_dates;
+   for (auto &[coil, due_date] : instance.dueDates)
+   {
+      due_dates.push_back({coil, due_date});
+   }
+   writer.WriteSection(Section::kDueDates, due_dates);
+
+   vector<ProcessingTimeRecord> processing_times;
+   for (auto &[key, time] : instance.processingTimes)
+   {
+      processing_times.push_back({std::get<0>(key), std::get<1>(key), std::get<2>(key), 0, time});
+   }
+   writer.WriteSection(Section::kProcessingTimes, processing_times);
+
+   auto arc_records = [](const auto &map)
+   {
+      vector<ArcRecord> records;
+      records.reserve(map.size());
+      for (auto &[key, value] : map)
+      {
+         auto &[coil_i, mode_i, coil_j, mode_j, line] = key;
+         records.push_back({coil_i, mode_i, coil_j, mode_j, line, static_cast<int32_t>(value)});
+      }
+      return records;
+   };
+   writer.WriteSection(Section::kSetupTimes, arc_records(instance.setupTimes));
+   writer.WriteSection(Section::kStringerCosts, arc_records(instance.stringerCosts));
+
+   vector<ArcRecord> eliminated_arcs;
+   for (auto &[coil_i, mode_i, coil_j, mode_j, line] : instance.eliminatedArcs)
+   {
+      eliminated_arcs.push_back({coil_i, mode_i, coil_j, mode_j, line, 0});
+   }
+   writer.WriteSection(Section::kEliminatedArcs, eliminated_arcs);
+
+   vector<BoundRecord> bounds;
+   for (auto &[key, bound] : instance.startTimeUpperBound)
+   {
+      auto big_M = instance.delayBigM.find(key);
+      bounds.push_back({std::get<0>(key), std::get<1>(key), bound, big_M != instance.delayBigM.end() ? big_M->second : 0});
+   }
+   writer.WriteSection(Section::kBounds, bounds);
+
+   vector<BigMRecord> big_Ms;
+   for (auto &[line, big_M] : instance.bigM)
+   {
+      big_Ms.push_back({line, 0, big_M});
+   }
+   writer.WriteSection(Section::kBigM, big_Ms);
+
+   vector<ModeRecord> removed_modes;
+   for (auto &[coil, line, mode] : instance.removedModes)
+   {
+      removed_modes.push_back({coil, line, mode});
+   }
+   writer.WriteSection(Section::kRemovedModes, removed_modes);
+
+   bool good = writer.good();
+   good = fclose(file) == 0 && good;
+
+   if (!good || std::rename(temporary_path.c_str(), cachePath.c_str()) != 0)
+   {
+      std::remove(temporary_path.c_str());
+      return false;
+   }
+   return true;
+}
+
+/**
+ * @brief Loads a cache file into an empty instance
+ *
+ * @return true if the cache exists, has the current version and settings and was written for the given source file
+ */
+bool InstanceCache::Load(const std::string &cachePath, Instance &instance, uint64_t sourceSize, uint64_t sourceChecksum)
+{
+   if (access(cachePath.c_str(), R_OK) != 0)
+      return false;
+
+   MappedFile file(cachePath);
+   if (file.size() < sizeof(Header))
+      return false;
+
+   auto header = reinterpret_cast<const Header *>(file.begin());
+   if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+       header->version != kVersion ||
+       header->preprocessing != (Settings::kEnablePreprocessing ? 1u : 0u) ||
+       header->source_size != sourceSize ||
+       header->source_checksum != sourceChecksum)
+      return false;
+
+   Reader reader(file.begin() + sizeof(Header), file.end());
+   uint64_t count;
+
+   auto scalars = reader.ReadSection<ScalarRecord>(Section::kScalars, count);
+   if (scalars == nullptr || count != 1)
+      return false;
+
+   instance.numberOfCoils = scalars->number_of_coils;
+   instance.numberOfProductionLines = scalars->number_of_production_lines;
+   instance.numberOfModes = scalars->number_of_modes;
+   instance.maximumDelayedCoils = scalars->maximum_delayed_coils;
+   instance.startCoil = scalars->start_coil;
+   instance.endCoil = scalars->end_coil;
+   instance.numberOfModesBeforePreprocessing = scalars->modes_before_preprocessing;
+   instance.numberOfModesAfterPreprocessing = scalars->modes_after_preprocessing;
+   instance.numberOfArcsBeforePreprocessing = scalars->arcs_before_preprocessing;
+   instance.numberOfArcsAfterPreprocessing = scalars->arcs_after_preprocessing;
+
+   auto comments = static_cast<const char *>(reader.ReadRaw(Section::kComments, 1, count));
+   if (comments == nullptr)
+      return false;
+   for (auto comment_begin = comments; comment_begin < comments + count;)
+   {
+      auto comment_end = static_cast<const char *>(std::memchr(comment_begin, '\n', comments + count - comment_begin));
+      if (comment_end == nullptr)
+         return false;
+      instance.comments.emplace_back(comment_begin, comment_end);
+      comment_begin = comment_end + 1;
+   }
+
+   if (!FromRecords(reader, Section::kCoils, instance.coils) ||
+       !FromRecords(reader, Section::kRegularCoils, instance.regularCoils) ||
+       !FromRecords(reader, Section::kCoilsWithoutStartCoil, instance.coilsWithoutStartCoil) ||
+       !FromRecords(reader, Section::kCoilsWithoutEndCoil, instance.coilsWithoutEndCoil) ||
+       !FromRecords(reader, Section::kProductionLines, instance.productionLines) ||
+       !FromRecords(reader, Section::kAllModes, instance.allModes))
+      return false;
+
+   // records are stored in key order, thus every insertion happens at the end of the maps
+   auto modes = reader.ReadSection<ModeRecord>(Section::kModes, count);
+   if (modes == nullptr)
+      return false;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      auto entry = instance.modes.emplace_hint(instance.modes.end(), make_tuple(modes[i].coil, modes[i].line), vector<Mode>());
+      entry->second.push_back(modes[i].mode);
+   }
+
+   auto due_dates = reader.ReadSection<DueDateRecord>(Section::kDueDates, count);
+   if (due_dates == nullptr)
+      return false;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      instance.dueDates.emplace_hint(instance.dueDates.end(), due_dates[i].coil, due_dates[i].due_date);
+   }
+
+   auto processing_times = reader.ReadSection<ProcessingTimeRecord>(Section::kProcessingTimes, count);
+   if (processing_times == nullptr)
+      return false;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      auto &record = processing_times[i];
+      instance.processingTimes.emplace_hint(instance.processingTimes.end(), make_tuple(record.coil, record.line, record.mode), record.time);
+   }
+
+   auto setup_times = reader.ReadSection<ArcRecord>(Section::kSetupTimes, count);
+   if (setup_times == nullptr)
+      return false;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      auto &record = setup_times[i];
+      instance.setupTimes.emplace_hint(instance.setupTimes.end(), make_tuple(record.coil_i, record.mode_i, record.coil_j, record.mode_j, record.line), record.value);
+   }
+
+   auto stringer_costs = reader.ReadSection<ArcRecord>(Section::kStringerCosts, count);
+   if (stringer_costs == nullptr)
+      return false;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      auto &record = stringer_costs[i];
+      auto tuple = make_tuple(record.coil_i, record.mode_i, record.coil_j, record.mode_j, record.line);
+      instance.stringerCosts.emplace_hint(instance.stringerCosts.end(), tuple, record.value);
+      instance.stringerNeeded.emplace_hint(instance.stringerNeeded.end(), tuple, true);
+   }
+
+   auto eliminated_arcs = reader.ReadSection<ArcRecord>(Section::kEliminatedArcs, count);
+   if (eliminated_arcs == nullptr)
+      return false;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      auto &record = eliminated_arcs[i];
+      instance.eliminatedArcs.emplace_hint(instance.eliminatedArcs.end(), record.coil_i, record.mode_i, record.coil_j, record.mode_j, record.line);
+   }
+
+   auto bounds = reader.ReadSection<BoundRecord>(Section::kBounds, count);
+   if (bounds == nullptr)
+      return false;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      auto key = make_tuple(bounds[i].coil, bounds[i].line);
+      instance.startTimeUpperBound.emplace_hint(instance.startTimeUpperBound.end(), key, bounds[i].start_time_upper_bound);
+      instance.delayBigM.emplace_hint(instance.delayBigM.end(), key, bounds[i].delay_big_M);
+   }
+
+   auto big_Ms = reader.ReadSection<BigMRecord>(Section::kBigM, count);
+   if (big_Ms == nullptr)
+      return false;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      instance.bigM.emplace_hint(instance.bigM.end(), big_Ms[i].line, big_Ms[i].big_M);
+   }
+
+   auto removed_modes = reader.ReadSection<ModeRecord>(Section::kRemovedModes, count);
+   if (removed_modes == nullptr)
+      return false;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      instance.removedModes.emplace_hint(instance.removedModes.end(), removed_modes[i].coil, removed_modes[i].line, removed_modes[i].mode);
+   }
+
+   return true;
+}
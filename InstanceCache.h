@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Instance.h"
+
+/**
+ * @brief Versioned binary cache of a read instance
+ *
+ * The cache holds the parsed data, the preprocessed mode sets and eliminated arcs and the big M values, i.e. everything
+ * Instance::read derives from the text file. It is tagged with the size and a checksum of the source file and with
+ * the settings that change the derived data, so a stale cache is detected and rebuilt.
+ *
+ * All data is stored as arrays of fixed size records in key order. Loading maps the file and reads the records in
+ * place, inserting them at the end of the instance maps. The format uses the native byte order, thus a cache is only
+ * valid on the platform that wrote it.
+ */
+class InstanceCache
+{
+public:
+   // increase whenever the layout or the derivation of cached data changes
+   static constexpr uint32_t kVersion = 2;
+
+   // path of the cache of an instance file
+   static std::string CachePath(const std::string &instancePath);
+
+   // 64 bit FNV-1a hash of a buffer
+   static uint64_t Checksum(const char *data, size_t size);
+
+   // write a read instance, returns false if the file could not be written
+   static bool Write(const std::string &cachePath, const Instance &instance, uint64_t sourceSize, uint64_t sourceChecksum);
+
+   // load a cache into an empty instance, returns false if it does not exist, is invalid or belongs to another source
+   static bool Load(const std::string &cachePath, Instance &instance, uint64_t sourceSize, uint64_t sourceChecksum);
+};
@@ -0,0 +1,275 @@
+#include "InstanceDelta.h"
+
+#include <algorithm>
+
+#include "Logger.h"
+
+/**
+ * @brief Reads a delta file. Every line starts with a key like the lines of an instance file, coils of transitions
+ * may be given as start or end:
+ *   r coil                                            remove a coil
+ *   n coil                                            add a coil
+ *   d coil due_date                                   due date of an added or existing coil
+ *   a maximum_delayed_coils
+ *   m coil line mode                                  enabled mode of an added coil
+ *   p coil line mode processing_time
+ *   t coil_1 coil_2 line mode_1 mode_2 setup_time
+ *   c coil_1 coil_2 line mode_1 mode_2 stringer_cost
+ */
+void InstanceDelta::Read(const string &path)
+{
+   std::ifstream file(path);
+   if (!file)
+      throw std::runtime_error("Could not open delta " + path);
+
+   auto read_coil = [](std::istream &fields)
+   {
+      string coil;
+      fields >> coil;
+      if (coil == "start")
+         return -1;
+      if (coil == "end")
+         return kEndCoil;
+      return stoi(coil);
+   };
+
+   string line;
+   size_t line_number = 0;
+   while (std::getline(file, line))
+   {
+      line_number++;
+      std::istringstream fields(line);
+      char key;
+      if (!(fields >> key))
+         continue;
+
+      switch (key)
+      {
+      case 'r':
+         removed_coils.push_back(read_coil(fields));
+         break;
+      case 'n':
+         added_coils.push_back(read_coil(fields));
+         break;
+      case 'd':
+      {
+         auto coil = read_coil(fields);
+         fields >> due_dates[coil];
+         break;
+      }
+      case 'a':
+         fields >> maximum_delayed_coils;
+         break;
+      case 'm':
+      {
+         auto coil = read_coil(fields);
+         ProductionLine production_line;
+         Mode mode;
+         fields >> production_line >> mode;
+         modes[make_tuple(coil, production_line)].push_back(mode);
+         break;
+      }
+      case 'p':
+      {
+         auto coil = read_coil(fields);
+         ProductionLine production_line;
+         Mode mode;
+         fields >> production_line >> mode;
+         fields >> processing_times[make_tuple(coil, production_line, mode)];
+         break;
+      }
+      case 't':
+      case 'c':
+      {
+         auto coil_1 = read_coil(fields);
+         auto coil_2 = read_coil(fields);
+         ProductionLine production_line;
+         Mode mode_1, mode_2;
+         int value;
+         fields >> production_line >> mode_1 >> mode_2 >> value;
+
+         auto arc = make_tuple(coil_1, mode_1, coil_2, mode_2, production_line);
+         if (key == 't')
+            setup_times[arc] = value;
+         else
+            stringer_costs[arc] = value;
+         break;
+      }
+      default:
+         // unknown keys are ignored like in instance files
+         continue;
+      }
+
+      if (fields.fail())
+         throw std::runtime_error("Malformed line " + std::to_string(line_number) + " in delta " + path);
+   }
+
+   for (auto &[key, coil_modes] : modes)
+   {
+      std::sort(coil_modes.begin(), coil_modes.end());
+   }
+
+   Validate();
+}
+
+/**
+ * @brief Checks that every added coil can be scheduled: it needs a due date and at least one mode, and every mode needs
+ * a processing time. Missing values would silently become 0 in the instance. Setup times and stringer costs are
+ * optional, a missing transition has no setup time and no stringer cost like in instance files.
+ */
+void InstanceDelta::Validate() const
+{
+   std::set<Coil> added(added_coils.begin(), added_coils.end());
+   auto check_added = [&added](Coil coil, const string &data)
+   {
+      if (added.count(coil) == 0)
+         throw std::invalid_argument(data + " of coil " + std::to_string(coil) + ", which is not added by the delta");
+   };
+
+   for (auto &[key, coil_modes] : modes)
+   {
+      check_added(get<0>(key), "Modes");
+   }
+   for (auto &[key, processing_time] : processing_times)
+   {
+      check_added(get<0>(key), "Processing time");
+   }
+
+   for (auto &coil : added_coils)
+   {
+      if (due_dates.count(coil) == 0)
+         throw std::invalid_argument("Added coil " + std::to_string(coil) + " has no due date");
+
+      bool has_mode = false;
+      for (auto entry = modes.lower_bound(make_tuple(coil, std::numeric_limits<ProductionLine>::min()));
+           entry != modes.end() && get<0>(entry->first) == coil; ++entry)
+      {
+         auto line = get<1>(entry->first);
+         for (auto &mode : entry->second)
+         {
+            auto processing_time = processing_times.find(make_tuple(coil, line, mode));
+            if (processing_time == processing_times.end() || processing_time->second <= 0)
+               throw std::invalid_argument("Added coil " + std::to_string(coil) + " has no processing time in mode " +
+                                           std::to_string(mode) + " on line " + std::to_string(line));
+            has_mode = true;
+         }
+      }
+      if (!has_mode)
+         throw std::invalid_argument("Added coil " + std::to_string(coil) + " has no mode on any line");
+   }
+}
+
+/**
+ * @brief Translates the result of a solve of the unchanged instance to the changed instance
+ *
+ * Removed coils are cut out of the columns and the incumbent. A coil whose mode was removed by preprocessing continues
+ * in its fastest remaining mode on the line. Coils without a place, i.e. added coils and coils without any remaining
+ * mode on their line, are inserted into the incumbent where they increase the stringer cost the least. Columns and the
+ * incumbent may still use eliminated arcs, these are dropped when the models are warm started, see SolveInstance.
+ *
+ * @return RunResult Repaired columns and incumbent, without incumbent if a coil has no place on any line
+ */
+RunResult InstanceDelta::Repair(const RunResult &previous, const Instance &changed) const
+{
+   std::set<Coil> removed(removed_coils.begin(), removed_coils.end());
+   vector<Coil> unplaced(added_coils.begin(), added_coils.end());
+
+   auto repair_sequence = [&](ProductionLine line, const vector<tuple<Coil, Mode>> &sequence, bool collect_unplaced)
+   {
+      vector<tuple<Coil, Mode>> repaired;
+      for (auto &[coil, mode] : sequence)
+      {
+         if (removed.count(coil) > 0)
+            continue;
+
+         auto &coil_modes = changed.GetModes(coil, line);
+         if (std::find(coil_modes.begin(), coil_modes.end(), mode) != coil_modes.end())
+         {
+            repaired.push_back(make_tuple(coil, mode));
+            continue;
+         }
+
+         if (coil_modes.empty())
+         {
+            if (collect_unplaced)
+               unplaced.push_back(coil);
+            continue;
+         }
+
+         auto fastest = *std::min_element(coil_modes.begin(), coil_modes.end(), [&](Mode mode_a, Mode mode_b)
+                                          { return changed.GetProcessingTime(coil, line, mode_a) < changed.GetProcessingTime(coil, line, mode_b); });
+         repaired.push_back(make_tuple(coil, fastest));
+      }
+      return repaired;
+   };
+
+   RunResult repaired;
+   for (auto &[line, sequence] : previous.columns)
+   {
+      repaired.columns.emplace_back(line, repair_sequence(line, sequence, false));
+   }
+
+   if (!previous.has_solution)
+      return repaired;
+
+   auto &solution = repaired.solution;
+   for (auto &[line, sequence] : previous.solution.sequences)
+   {
+      solution.sequences[line] = repair_sequence(line, sequence, true);
+   }
+
+   auto arc_allowed = [&changed](Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j, ProductionLine line)
+   { return !changed.IsArcEliminated(coil_i, mode_i, coil_j, mode_j, line); };
+
+   // cheapest insertion of every coil without a place
+   for (auto &coil : unplaced)
+   {
+      bool found = false;
+      double best_increase = 0;
+      ProductionLine best_line = 0;
+      size_t best_position = 0;
+      Mode best_mode = 0;
+
+      for (auto &[line, sequence] : solution.sequences)
+      {
+         for (auto &mode : changed.GetModes(coil, line))
+         {
+            for (size_t position = 0; position <= sequence.size(); position++)
+            {
+               auto [coil_i, mode_i] = position > 0 ? sequence[position - 1] : make_tuple(changed.startCoil, 0);
+               auto [coil_j, mode_j] = position < sequence.size() ? sequence[position] : make_tuple(changed.endCoil, 0);
+
+               if (!arc_allowed(coil_i, mode_i, coil, mode, line) || !arc_allowed(coil, mode, coil_j, mode_j, line))
+                  continue;
+
+               double increase = changed.GetStringerCost(coil_i, mode_i, coil, mode, line) +
+                                 changed.GetStringerCost(coil, mode, coil_j, mode_j, line) -
+                                 changed.GetStringerCost(coil_i, mode_i, coil_j, mode_j, line);
+               if (!found || increase < best_increase)
+               {
+                  found = true;
+                  best_increase = increase;
+                  best_line = line;
+                  best_position = position;
+                  best_mode = mode;
+               }
+            }
+         }
+      }
+
+      if (!found)
+      {
+         PHALS_LOG(kInfo) << "Coil " << coil << " fits nowhere in the previous incumbent, starting without incumbent" << endl;
+         return repaired;
+      }
+
+      auto &sequence = solution.sequences[best_line];
+      sequence.insert(sequence.begin() + best_position, make_tuple(coil, best_mode));
+   }
+
+   solution.ComputeCost(changed);
+   solution.ComputeTiming(changed);
+   repaired.has_solution = true;
+
+   return repaired;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <limits>
+
+#include "Instance.h"
+#include "InstanceRun.h"
+
+/**
+ * @brief Changes of an instance during a shift: removed and added coils, changed due dates and a new maximum number of
+ * delayed coils, see Instance::ApplyDelta
+ *
+ * A delta also repairs the result of the last solve for the changed instance, so the next solve starts from the
+ * previous columns and incumbent instead of from scratch, see Repair.
+ */
+struct InstanceDelta
+{
+   // stands for the end coil in the transitions of added coils, its number changes when coils are added
+   static constexpr Coil kEndCoil = std::numeric_limits<Coil>::max();
+
+   vector<Coil> removed_coils;
+   // due dates of added coils and changed due dates of existing coils
+   map<Coil, DueDate> due_dates;
+   // negative to keep the maximum number of delayed coils
+   int maximum_delayed_coils = -1;
+
+   // added coils are numbered after every existing regular coil, their data is keyed like the maps of Instance
+   vector<Coil> added_coils;
+   map<tuple<Coil, ProductionLine>, vector<Mode>> modes;
+   map<tuple<Coil, ProductionLine, Mode>, ProcessingTime> processing_times;
+   map<tuple<Coil, Mode, Coil, Mode, ProductionLine>, SetupTime> setup_times;
+   map<tuple<Coil, Mode, Coil, Mode, ProductionLine>, StringerCosts> stringer_costs;
+
+   void Read(const string &path);
+
+   // throws if an added coil lacks its due date, modes or processing times, or data is given for coils not added
+   void Validate() const;
+
+   // previous result translated to the changed instance
+   RunResult Repair(const RunResult &previous, const Instance &changed) const;
+};
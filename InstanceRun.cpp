@@ -0,0 +1,351 @@
+#include "InstanceRun.h"
+
+#include <future>
+#include <thread>
+
+#include <sys/resource.h>
+
+#include "Logger.h"
+#include "IncumbentExchange.h"
+#include "RollingHorizon.h"
+#include "ScheduleExporter.h"
+#include "compact/CompactModel.h"
+#include "convexification/Master.h"
+#include "convexification/Pricer.h"
+
+/**
+ * @brief Parses the name of a formulation of the timing constraints
+ *
+ * @param name One of bigm, lazy, indicator
+ * @return Settings::TimingFormulation The formulation
+ */
+Settings::TimingFormulation ParseTimingFormulation(const string &name)
+{
+   if (name == "bigm")
+      return Settings::TimingFormulation::kBigM;
+   if (name == "lazy")
+      return Settings::TimingFormulation::kLazy;
+   if (name == "indicator")
+      return Settings::TimingFormulation::kIndicator;
+
+   throw std::invalid_argument("Unknown timing formulation " + name + ", expected bigm, lazy or indicator");
+}
+
+/**
+ * @brief Parses the name of a run mode
+ *
+ * @param name One of sequential, portfolio, compact, bp
+ * @return Settings::RunMode The run mode
+ */
+Settings::RunMode ParseRunMode(const string &name)
+{
+   if (name == "sequential")
+      return Settings::RunMode::kSequential;
+   if (name == "portfolio")
+      return Settings::RunMode::kPortfolio;
+   if (name == "compact")
+      return Settings::RunMode::kCompact;
+   if (name == "bp")
+      return Settings::RunMode::kBranchAndPrice;
+
+   throw std::invalid_argument("Unknown run mode " + name + ", expected sequential, portfolio, compact or bp");
+}
+
+/**
+ * @brief Name of a run mode as accepted by ParseRunMode
+ */
+string GetRunModeName(Settings::RunMode run_mode)
+{
+   switch (run_mode)
+   {
+   case Settings::RunMode::kSequential:
+      return "sequential";
+   case Settings::RunMode::kPortfolio:
+      return "portfolio";
+   case Settings::RunMode::kCompact:
+      return "compact";
+   case Settings::RunMode::kBranchAndPrice:
+      return "bp";
+   }
+   return "unknown";
+}
+
+/**
+ * @brief Seconds elapsed since a point in time
+ */
+double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Peak resident set size of this process so far
+ */
+double PeakResidentSetSizeInMegabytes()
+{
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+
+   // kilobytes on Linux
+   return usage.ru_maxrss / 1024.0;
+}
+
+/**
+ * @brief Reads an instance and solves it in the given run mode, see SolveInstance. Instances with more coils than the
+ * window size of the rolling horizon are solved window by window, see RollingHorizon, their transitions are never read
+ * as a whole.
+ */
+RunResult RunInstance(const RunOptions &options)
+{
+   auto read_start = std::chrono::steady_clock::now();
+
+   if (options.horizon_window_size > 0)
+   {
+      // coils without any transition, the windows parse the transitions of their own coils
+      auto coils = make_shared<Instance>();
+      coils->parse(options.instance_path, std::set<Coil>());
+      if (coils->regularCoils.size() > options.horizon_window_size)
+      {
+         PHALS_LOG(kInfo) << "Coils of instance read in " << SecondsSince(read_start) << "s" << endl;
+         auto result = RollingHorizon(coils, options).Solve();
+         result.seconds = SecondsSince(read_start);
+         return result;
+      }
+   }
+
+   auto instance = make_shared<Instance>();
+
+   // read instance
+   instance->read(options.instance_path);
+   PHALS_LOG(kInfo) << "Instance read in " << SecondsSince(read_start) << "s" << endl;
+
+   auto result = SolveInstance(instance, options);
+   result.seconds = SecondsSince(read_start);
+   return result;
+}
+
+/**
+ * @brief Solves an instance in the given run mode. Every call builds its own SCIP instances, so runs on different
+ * threads are independent of each other. The instance is only read.
+ *
+ * @param warm_start Result of an earlier solve, e.g. repaired by InstanceDelta::Repair. Its incumbent is added to
+ * every model and its columns start the master problem, columns using arcs that do not exist anymore are dropped.
+ * @return RunResult The best solution of all solvers of the run mode, the columns of the master problem and the time of
+ * the run
+ */
+RunResult SolveInstance(shared_ptr<Instance> instance, const RunOptions &options, const RunResult *warm_start)
+{
+   auto startup_start = std::chrono::steady_clock::now();
+
+   auto time_limit = options.time_limit;
+   auto timing_formulation = options.timing_formulation;
+   auto run_mode = options.run_mode;
+   auto run_mode_name = GetRunModeName(run_mode);
+
+   // only the models of the run mode are built
+   bool use_compact_model = run_mode != Settings::RunMode::kBranchAndPrice;
+   bool use_branch_and_price = run_mode != Settings::RunMode::kCompact;
+
+   // the compact model, the master problem and the subproblems are independent SCIP instances that only read the
+   // instance, so the compact model is built on its own thread while the master problem and the pricer are built here
+   std::future<unique_ptr<CompactModel>> compact_model_build;
+   if (use_compact_model)
+   {
+      compact_model_build = std::async(Settings::kEnableParallelModelConstruction ? std::launch::async : std::launch::deferred,
+                                       [&]
+                                       {
+                                          auto build_start = std::chrono::steady_clock::now();
+                                          auto model = make_unique<CompactModel>(instance, timing_formulation);
+                                          PHALS_LOG(kInfo) << "Compact model built in " << SecondsSince(build_start) << "s" << endl;
+                                          return model;
+                                       });
+   }
+
+   shared_ptr<Master> master_problem;
+   MyPricer *pricer = nullptr;
+   if (use_branch_and_price)
+   {
+      // create master problem
+      auto master_start = std::chrono::steady_clock::now();
+      master_problem = make_shared<Master>(instance);
+      PHALS_LOG(kInfo) << "Master problem built in " << SecondsSince(master_start) << "s" << endl;
+
+      // create pricer for linking SubProblem and Master in B&P algo
+      pricer = new MyPricer(
+         master_problem,
+         "PHALS_exact_mip",                                                      // name of the pricer
+         "PHALS Pricer with convexification and braching on original variables", // short description of the pricer
+         0,                                                                      //
+         TRUE,                                                                   //
+         timing_formulation);                                                    // formulation of timing constraints in subproblems
+
+      // include pricer in Master SCIP object
+      SCIPincludeObjPricer(master_problem->scipRMP_, //
+                           pricer,
+                           true);
+
+      // activate pricer
+      SCIPactivatePricer(master_problem->scipRMP_, SCIPfindPricer(master_problem->scipRMP_, pricer->pricer_name_));
+
+      if (Settings::kEnableLns)
+         master_problem->IncludeLargeNeighborhoodSearch();
+
+      if (options.write_model_files)
+         pricer->EnableModelFiles();
+   }
+
+   unique_ptr<CompactModel> compact_model;
+   if (use_compact_model)
+   {
+      compact_model = compact_model_build.get();
+      if (options.write_model_files)
+         compact_model->WriteModelFile();
+   }
+
+   // the SCIP instances of the run share its memory limit, i.e. the compact model, the master problem and every
+   // subproblem get an equal part
+   if (options.memory_limit > 0)
+   {
+      size_t number_of_scips = (use_compact_model ? 1 : 0) + (use_branch_and_price ? 1 + pricer->subproblems_.size() : 0);
+      double memory_limit = options.memory_limit / number_of_scips;
+      if (use_compact_model)
+         compact_model->SetMemoryLimit(memory_limit);
+      if (use_branch_and_price)
+      {
+         master_problem->SetMemoryLimit(memory_limit);
+         pricer->SetSubProblemMemoryLimit(memory_limit);
+      }
+   }
+
+   // memory of the SCIP instances of this run, unlike the resident set size of the process it excludes concurrent runs
+   auto scip_memory_used = [&]
+   {
+      double megabytes = 0;
+      if (use_compact_model)
+         megabytes += compact_model->GetMemoryUsed();
+      if (use_branch_and_price)
+         megabytes += master_problem->GetMemoryUsed() + pricer->GetSubProblemMemoryUsed();
+      return megabytes;
+   };
+
+   if (warm_start != nullptr)
+   {
+      if (use_compact_model && warm_start->has_solution)
+         compact_model->ImportSolution(warm_start->solution, nullptr);
+
+      if (use_branch_and_price)
+      {
+         vector<shared_ptr<ProductionLineSchedule>> columns;
+         for (auto &[line, sequence] : warm_start->columns)
+         {
+            SequenceSolution route;
+            route.sequences[line] = sequence;
+            route.ComputeTiming(*instance);
+
+            auto route_columns = master_problem->CreateColumns(route);
+            columns.insert(columns.end(), route_columns.begin(), route_columns.end());
+         }
+         pricer->AddInitialColumns(columns);
+         PHALS_LOG(kInfo) << "Warm start with " << columns.size() << "/" << warm_start->columns.size() << " previous columns" << endl;
+
+         if (warm_start->has_solution)
+            pricer->AddInitialSolution(warm_start->solution);
+      }
+   }
+
+   // every model is built, data only needed for building them is not needed anymore
+   if (options.release_preprocessing_data)
+      instance->ReleasePreprocessingData();
+
+   PHALS_LOG(kInfo) << "Startup in run mode " << run_mode_name << ": all models built after " << SecondsSince(startup_start)
+                    << "s, SCIP memory " << scip_memory_used() << " MB" << endl;
+   Logger::Get().Flush();
+
+   // best solution of all solvers of the run mode, exported at the end
+   RunResult result;
+   auto consider_final_solution = [&](const SequenceSolution &solution)
+   {
+      if (!result.has_solution || solution.cost < result.solution.cost)
+      {
+         result.solution = solution;
+         result.has_solution = true;
+      }
+   };
+
+   switch (run_mode)
+   {
+   case Settings::RunMode::kPortfolio:
+   {
+      // both solvers share the time limit and their incumbents, the first to finish the search stops the other
+      auto exchange = make_shared<IncumbentExchange>(instance);
+      compact_model->IncludeIncumbentExchange(exchange);
+      master_problem->IncludeIncumbentExchange(exchange);
+
+      auto portfolio_start = std::chrono::steady_clock::now();
+      thread compact_thread([&]
+                            { compact_model->Solve(time_limit); });
+      master_problem->Solve(time_limit);
+      compact_thread.join();
+
+      PHALS_LOG(kInfo) << "[Portfolio] Finished after " << SecondsSince(portfolio_start) << "s" << endl;
+      Logger::Get().Flush();
+
+      if (options.display_solution)
+         exchange->DisplayBest();
+
+      SequenceSolution solution;
+      if (exchange->GetBest(solution))
+         consider_final_solution(solution);
+
+      result.columns = master_problem->GetColumnSequences();
+      break;
+   }
+   default:
+      // solve and display solution
+      if (use_compact_model)
+      {
+         compact_model->Solve(time_limit);
+         if (options.display_solution)
+            compact_model->DisplaySolution();
+      }
+
+      SequenceSolution compact_solution;
+      bool has_compact_solution = use_compact_model && compact_model->GetBestSolution(compact_solution);
+      if (has_compact_solution)
+         consider_final_solution(compact_solution);
+
+      if (use_branch_and_price)
+      {
+         // the incumbent of the compact model gives initial columns and an upper bound
+         if (has_compact_solution && Settings::kTransferCompactIncumbent)
+            pricer->AddInitialSolution(compact_solution);
+
+         master_problem->Solve(time_limit);
+         if (options.display_solution)
+            master_problem->DisplaySolution();
+
+         SequenceSolution master_solution;
+         if (master_problem->GetBestSolution(master_solution))
+            consider_final_solution(master_solution);
+
+         result.columns = master_problem->GetColumnSequences();
+      }
+      break;
+   }
+
+   if (!options.export_path.empty())
+   {
+      if (result.has_solution)
+         ScheduleExporter(instance).WriteFile(result.solution, options.export_path);
+      else
+         PHALS_LOG(kWarning) << "No solution found, nothing exported to " << options.export_path << endl;
+   }
+
+   result.scip_memory = scip_memory_used();
+   PHALS_LOG(kInfo) << "Finished run mode " << run_mode_name << " after " << SecondsSince(startup_start) << "s, SCIP memory "
+                    << result.scip_memory << " MB" << endl;
+   Logger::Get().Flush();
+
+   result.seconds = SecondsSince(startup_start);
+   return result;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "Instance.h"
+#include "SequenceSolution.h"
+#include "Settings.h"
+
+/**
+ * @brief Everything needed to solve one instance, parsed from the command line or a line of a batch manifest
+ */
+struct RunOptions
+{
+   string instance_path;
+   double time_limit = Settings::kDefaultTimeLimit;
+   Settings::TimingFormulation timing_formulation = Settings::kDefaultTimingFormulation;
+   Settings::RunMode run_mode = Settings::kDefaultRunMode;
+
+   // the final schedule is exported here if not empty, see ScheduleExporter
+   string export_path;
+
+   // memory limit in megabytes shared by all SCIP instances of the run, 0 for no limit. Memory held outside of SCIP,
+   // e.g. the instance and the networks of the bucket pricing, is not limited.
+   double memory_limit = 0;
+
+   // print the solutions of the models to cout
+   bool display_solution = true;
+
+   // write model files for debugging to fixed paths in the working directory, runs in the same process must not
+   // enable it, see Settings::kWriteModelFiles
+   bool write_model_files = Settings::kWriteModelFiles;
+
+   // drop data of the instance only needed to build the models once they are built, see
+   // Instance::ReleasePreprocessingData. Instances solved several times have to keep it.
+   bool release_preprocessing_data = true;
+
+   // instances with more coils than this are solved window by window, see RollingHorizon, 0 to always solve them as a
+   // whole
+   size_t horizon_window_size = Settings::kDefaultHorizonWindowSize;
+   size_t horizon_overlap = Settings::kDefaultHorizonOverlap;
+};
+
+/**
+ * @brief Outcome of solving one instance
+ */
+struct RunResult
+{
+   bool has_solution = false;
+   // best solution of all solvers of the run mode
+   SequenceSolution solution;
+   double seconds = 0;
+   // memory used by the SCIP instances of the run at its end in megabytes, the largest window for a rolling horizon
+   double scip_memory = 0;
+
+   // columns of the master problem as (line, sequence), empty if branch and price was not run
+   vector<tuple<ProductionLine, vector<tuple<Coil, Mode>>>> columns;
+};
+
+Settings::TimingFormulation ParseTimingFormulation(const string &name);
+Settings::RunMode ParseRunMode(const string &name);
+string GetRunModeName(Settings::RunMode run_mode);
+
+double SecondsSince(std::chrono::steady_clock::time_point start);
+// of the whole process, includes every run of a batch or service
+double PeakResidentSetSizeInMegabytes();
+
+// reads the instance, builds the models of the run mode and solves them, large instances window by window
+RunResult RunInstance(const RunOptions &options);
+
+// builds the models of the run mode for an instance that is already read and solves them, optionally starting from the
+// columns and incumbent of an earlier result
+RunResult SolveInstance(shared_ptr<Instance> instance, const RunOptions &options, const RunResult *warm_start = nullptr);
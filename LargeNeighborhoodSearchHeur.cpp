@@ -0,0 +1,369 @@
+#include "LargeNeighborhoodSearchHeur.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <thread>
+
+#include <scip/scip.h>
+
+#include "Logger.h"
+#include "Settings.h"
+
+/**
+ * @brief Construct the heuristic. It runs after every node and during the pricing loop of branch and price, where a
+ * single node can take long, but only searches if there is an incumbent that was not searched yet.
+ *
+ * @param scip SCIP environment the heuristic is included in
+ * @param instance Instance of the model, only read by the workers
+ * @param extract Translation of SCIP solutions to sequences
+ * @param import Translation of sequences to SCIP solutions
+ * @param is_arc_allowed Arcs the model can express, schedules using other arcs are discarded
+ */
+LargeNeighborhoodSearchHeur::LargeNeighborhoodSearchHeur(SCIP *scip, shared_ptr<Instance> instance, Extractor extract, Importer import, ArcFilter is_arc_allowed)
+    : ObjHeur(scip,
+              "large_neighborhood_search",                                       // name
+              "destroys and repairs parts of the incumbent sequences",           // description
+              'L',                                                               // display character
+              -100000,                                                           // priority
+              1,                                                                 // frequency
+              0,                                                                 // frequency offset
+              -1,                                                                // maximal depth, none
+              SCIP_HEURTIMING_DURINGPRICINGLOOP | SCIP_HEURTIMING_AFTERNODE,     // timing
+              FALSE),                                                            // uses no sub SCIP
+      instance_(instance), extract_(std::move(extract)), import_(std::move(import)), is_arc_allowed_(std::move(is_arc_allowed))
+{
+   coils_by_due_date_ = instance_->regularCoils;
+   std::stable_sort(coils_by_due_date_.begin(), coils_by_due_date_.end(), [this](Coil coil_a, Coil coil_b)
+                    { return instance_->dueDates.at(coil_a) < instance_->dueDates.at(coil_b); });
+}
+
+/**
+ * @brief Searches from the incumbent on Settings::kLnsThreads workers and imports the best schedule found if it
+ * improves the incumbent
+ */
+SCIP_RETCODE LargeNeighborhoodSearchHeur::scip_exec(SCIP *scip, SCIP_HEUR *heur, SCIP_HEURTIMING heurtiming, SCIP_Bool nodeinfeasible, SCIP_RESULT *result)
+{
+   *result = SCIP_DIDNOTRUN;
+
+   if (has_pending_solution_)
+   {
+      *result = import_(pending_solution_, heur);
+      if (*result == SCIP_DELAYED)
+      {
+         // the pricer has not added the columns of the schedule yet
+         *result = SCIP_DIDNOTFIND;
+         return SCIP_OKAY;
+      }
+
+      has_pending_solution_ = false;
+      return SCIP_OKAY;
+   }
+
+   auto incumbent = SCIPgetBestSol(scip);
+   if (incumbent == nullptr)
+      return SCIP_OKAY;
+
+   // another search from the same incumbent rarely pays off
+   double objective = SCIPgetSolOrigObj(scip, incumbent);
+   if (has_searched_ && objective == searched_objective_)
+      return SCIP_OKAY;
+
+   SCIP_Real time_limit;
+   SCIP_CALL(SCIPgetRealParam(scip, "limits/time", &time_limit));
+   double search_time_limit = std::min(Settings::kLnsTimeLimit, time_limit - SCIPgetSolvingTime(scip));
+   if (search_time_limit <= 0)
+      return SCIP_OKAY;
+
+   has_searched_ = true;
+   searched_objective_ = objective;
+   number_of_searches_++;
+
+   auto start = extract_(incumbent);
+   start.cost = objective;
+   for (auto &line : instance_->productionLines)
+   {
+      start.sequences[line];
+   }
+
+   // every worker searches with its own random numbers and writes only its own result
+   auto number_of_workers = std::max<size_t>(Settings::kLnsThreads, 1);
+   vector<SequenceSolution> found(number_of_workers);
+   vector<char> improved(number_of_workers, false);
+   vector<thread> workers;
+   for (size_t worker = 0; worker < number_of_workers; worker++)
+   {
+      unsigned seed = number_of_searches_ * number_of_workers + worker;
+      workers.emplace_back([&, worker, seed]
+                           { improved[worker] = Search(start, seed, search_time_limit, found[worker]); });
+   }
+   for (auto &worker : workers)
+   {
+      worker.join();
+   }
+
+   *result = SCIP_DIDNOTFIND;
+
+   long best_worker = -1;
+   for (size_t worker = 0; worker < number_of_workers; worker++)
+   {
+      if (improved[worker] && (best_worker < 0 || found[worker].cost < found[best_worker].cost))
+         best_worker = worker;
+   }
+   if (best_worker < 0)
+      return SCIP_OKAY;
+
+   auto &best = found[best_worker];
+   PHALS_LOG(kInfo) << "[LNS] Found schedule with cost " << best.cost << ", incumbent " << objective << endl;
+
+   *result = import_(best, heur);
+   if (*result == SCIP_DELAYED)
+   {
+      // the columns of the schedule are added in the next pricing round, import it at the next call
+      pending_solution_ = best;
+      has_pending_solution_ = true;
+      *result = SCIP_DIDNOTFIND;
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Destroys and repairs a schedule until Settings::kLnsMaxIterations steps are done, the last
+ * Settings::kLnsMaxIterationsWithoutImprovement steps found no better schedule or the time limit is reached. Schedules
+ * that are not worse replace the current one, so the search can move across plateaus of equal cost.
+ *
+ * @param start Incumbent with its cost
+ * @param best Set to the best schedule found if true is returned
+ * @return true If a schedule better than start was found
+ */
+bool LargeNeighborhoodSearchHeur::Search(const SequenceSolution &start, unsigned seed, double time_limit, SequenceSolution &best) const
+{
+   auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(time_limit);
+   std::mt19937 random(seed);
+   std::uniform_int_distribution<int> neighborhoods(0, 2);
+
+   auto current = start;
+   bool improved = false;
+   size_t iterations_without_improvement = 0;
+
+   for (size_t iteration = 0; iteration < Settings::kLnsMaxIterations && iterations_without_improvement < Settings::kLnsMaxIterationsWithoutImprovement &&
+                              std::chrono::steady_clock::now() < deadline;
+        iteration++)
+   {
+      iterations_without_improvement++;
+
+      auto candidate = current;
+      auto freed = Destroy(candidate, static_cast<Neighborhood>(neighborhoods(random)), random);
+      if (!Repair(candidate, std::move(freed), random) || !Evaluate(candidate))
+         continue;
+
+      if (candidate.cost <= current.cost + Settings::kIncumbentExchangeTolerance)
+         current = candidate;
+
+      if (candidate.cost < (improved ? best.cost : start.cost) - Settings::kIncumbentExchangeTolerance)
+      {
+         best = std::move(candidate);
+         improved = true;
+         iterations_without_improvement = 0;
+      }
+   }
+
+   return improved;
+}
+
+/**
+ * @brief Removes the coils of a neighborhood from the sequences
+ *
+ * @return vector<Coil> Removed coils
+ */
+vector<Coil> LargeNeighborhoodSearchHeur::Destroy(SequenceSolution &solution, Neighborhood neighborhood, std::mt19937 &random) const
+{
+   auto number_of_freed_coils = std::min(Settings::kLnsFreedCoils, coils_by_due_date_.size());
+   vector<Coil> freed;
+
+   switch (neighborhood)
+   {
+   case Neighborhood::kLine:
+   {
+      // a segment of a line, coils produced one after the other depend on each other the most
+      vector<ProductionLine> used_lines;
+      for (auto &[line, sequence] : solution.sequences)
+      {
+         if (!sequence.empty())
+            used_lines.push_back(line);
+      }
+      if (used_lines.empty())
+         return freed;
+
+      auto &sequence = solution.sequences[used_lines[std::uniform_int_distribution<size_t>(0, used_lines.size() - 1)(random)]];
+      auto length = std::min(number_of_freed_coils, sequence.size());
+      auto begin = std::uniform_int_distribution<size_t>(0, sequence.size() - length)(random);
+      for (size_t position = begin; position < begin + length; position++)
+      {
+         freed.push_back(get<0>(sequence[position]));
+      }
+      sequence.erase(sequence.begin() + begin, sequence.begin() + begin + length);
+      return freed;
+   }
+   case Neighborhood::kDueDateWindow:
+   {
+      // coils with similar due dates compete for the same positions
+      auto begin = std::uniform_int_distribution<size_t>(0, coils_by_due_date_.size() - number_of_freed_coils)(random);
+      freed.assign(coils_by_due_date_.begin() + begin, coils_by_due_date_.begin() + begin + number_of_freed_coils);
+      break;
+   }
+   case Neighborhood::kRandom:
+   {
+      freed = coils_by_due_date_;
+      std::shuffle(freed.begin(), freed.end(), random);
+      freed.resize(number_of_freed_coils);
+      break;
+   }
+   }
+
+   std::set<Coil> removed(freed.begin(), freed.end());
+   for (auto &[line, sequence] : solution.sequences)
+   {
+      sequence.erase(std::remove_if(sequence.begin(), sequence.end(), [&removed](const tuple<Coil, Mode> &entry)
+                                    { return removed.count(get<0>(entry)) > 0; }),
+                     sequence.end());
+   }
+
+   return freed;
+}
+
+/**
+ * @brief Inserts the freed coils in random order, every coil where it increases the stringer costs the least. A
+ * position is only considered if its arcs exist in the model and the coils delayed on its line do not exceed the
+ * maximum number of delayed coils.
+ *
+ * @return true If every freed coil was inserted
+ */
+bool LargeNeighborhoodSearchHeur::Repair(SequenceSolution &solution, vector<Coil> freed, std::mt19937 &random) const
+{
+   std::shuffle(freed.begin(), freed.end(), random);
+
+   constexpr auto kNoInsertion = std::numeric_limits<size_t>::max();
+   map<ProductionLine, int> line_delayed_coils;
+   int delayed_coils = 0;
+   for (auto &[line, sequence] : solution.sequences)
+   {
+      line_delayed_coils[line] = CountDelayedCoils(line, sequence, kNoInsertion, {});
+      delayed_coils += line_delayed_coils[line];
+   }
+
+   for (auto &coil : freed)
+   {
+      bool found = false;
+      double best_increase = 0;
+      ProductionLine best_line = 0;
+      size_t best_position = 0;
+      Mode best_mode = 0;
+      int best_line_delayed_coils = 0;
+
+      for (auto &[line, sequence] : solution.sequences)
+      {
+         for (auto &mode : instance_->GetModes(coil, line))
+         {
+            for (size_t position = 0; position <= sequence.size(); position++)
+            {
+               auto [coil_i, mode_i] = position > 0 ? sequence[position - 1] : make_tuple(instance_->startCoil, 0);
+               auto [coil_j, mode_j] = position < sequence.size() ? sequence[position] : make_tuple(instance_->endCoil, 0);
+
+               if (!is_arc_allowed_(coil_i, mode_i, coil, mode, line) || !is_arc_allowed_(coil, mode, coil_j, mode_j, line))
+                  continue;
+
+               double increase = instance_->GetStringerCost(coil_i, mode_i, coil, mode, line) +
+                                 instance_->GetStringerCost(coil, mode, coil_j, mode_j, line) -
+                                 instance_->GetStringerCost(coil_i, mode_i, coil_j, mode_j, line);
+               if (found && increase >= best_increase)
+                  continue;
+
+               // the timing of the line is only checked for positions that would be chosen
+               int new_line_delayed_coils = CountDelayedCoils(line, sequence, position, make_tuple(coil, mode));
+               if (new_line_delayed_coils > line_delayed_coils[line] &&
+                   delayed_coils - line_delayed_coils[line] + new_line_delayed_coils > instance_->maximumDelayedCoils)
+                  continue;
+
+               found = true;
+               best_increase = increase;
+               best_line = line;
+               best_position = position;
+               best_mode = mode;
+               best_line_delayed_coils = new_line_delayed_coils;
+            }
+         }
+      }
+
+      if (!found)
+         return false;
+
+      auto &sequence = solution.sequences[best_line];
+      sequence.insert(sequence.begin() + best_position, make_tuple(coil, best_mode));
+      delayed_coils += best_line_delayed_coils - line_delayed_coils[best_line];
+      line_delayed_coils[best_line] = best_line_delayed_coils;
+   }
+
+   return true;
+}
+
+/**
+ * @brief Computes cost and timing of a repaired schedule
+ *
+ * @return true If the model can express the schedule and it does not delay too many coils
+ */
+bool LargeNeighborhoodSearchHeur::Evaluate(SequenceSolution &solution) const
+{
+   for (auto &[line, sequence] : solution.sequences)
+   {
+      Coil coil_i = instance_->startCoil;
+      Mode mode_i = 0;
+      for (size_t position = 0; position <= sequence.size(); position++)
+      {
+         auto [coil_j, mode_j] = position < sequence.size() ? sequence[position] : make_tuple(instance_->endCoil, 0);
+         // removing coils joins their neighbors by arcs the model may not have
+         if (!is_arc_allowed_(coil_i, mode_i, coil_j, mode_j, line))
+            return false;
+
+         coil_i = coil_j;
+         mode_i = mode_j;
+      }
+   }
+
+   solution.ComputeTiming(*instance_);
+   auto delayed_coils = std::count_if(solution.delayed.begin(), solution.delayed.end(), [](const pair<const Coil, bool> &entry)
+                                      { return entry.second; });
+   if (delayed_coils > instance_->maximumDelayedCoils)
+      return false;
+
+   solution.ComputeCost(*instance_);
+   return true;
+}
+
+/**
+ * @brief Counts the delayed coils of a sequence with the timing of SequenceSolution::ComputeTiming
+ */
+int LargeNeighborhoodSearchHeur::CountDelayedCoils(ProductionLine line, const vector<tuple<Coil, Mode>> &sequence, size_t position, tuple<Coil, Mode> inserted) const
+{
+   size_t length = sequence.size() + (position <= sequence.size() ? 1 : 0);
+
+   int delayed_coils = 0;
+   double time = 0;
+   Coil coil_i = instance_->startCoil;
+   Mode mode_i = 0;
+   for (size_t k = 0; k < length; k++)
+   {
+      auto [coil, mode] = k == position ? inserted : sequence[k < position ? k : k - 1];
+      if (k > 0)
+         time += instance_->GetSetupTime(coil_i, mode_i, coil, mode, line);
+      time += instance_->GetProcessingTime(coil, line, mode);
+      if (time > instance_->dueDates.at(coil) + Settings::kIncumbentExchangeTolerance)
+         delayed_coils++;
+
+      coil_i = coil;
+      mode_i = mode;
+   }
+
+   return delayed_coils;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <random>
+
+#include "objscip/objscip.h"
+
+#include "Instance.h"
+#include "SequenceSolution.h"
+
+using namespace scip;
+
+/**
+ * @brief Primal heuristic improving the incumbent by a large neighborhood search on its sequences
+ *
+ * Every iteration destroys a part of the schedule, i.e. removes a segment of a line, the coils of a due date window or
+ * random coils, and repairs it by inserting the removed coils where they increase the stringer costs the least
+ * without exceeding the maximum number of delayed coils. Several workers search from the incumbent on their own
+ * threads, the best schedule found is imported into the SCIP instance. Every incumbent is searched once, the heuristic
+ * does not run without incumbent. Translating between SCIP solutions and sequences is done by the model, see Master.
+ */
+class LargeNeighborhoodSearchHeur : public ObjHeur
+{
+public:
+   // sequences of a feasible SCIP solution
+   using Extractor = std::function<SequenceSolution(SCIP_SOL *)>;
+   // SCIP_FOUNDSOL if the solution was stored, SCIP_DIDNOTFIND if it was rejected and SCIP_DELAYED if the model
+   // cannot express it yet and the import should be retried at the next call
+   using Importer = std::function<SCIP_RESULT(const SequenceSolution &, SCIP_HEUR *)>;
+   // true if the model has a variable for the arc (coil i, mode i, coil j, mode j, line), called from the workers
+   using ArcFilter = std::function<bool(Coil, Mode, Coil, Mode, ProductionLine)>;
+
+   LargeNeighborhoodSearchHeur(SCIP *scip, shared_ptr<Instance> instance, Extractor extract, Importer import, ArcFilter is_arc_allowed);
+
+   virtual SCIP_RETCODE scip_exec(SCIP *scip, SCIP_HEUR *heur, SCIP_HEURTIMING heurtiming, SCIP_Bool nodeinfeasible, SCIP_RESULT *result) override;
+
+private:
+   enum class Neighborhood
+   {
+      kLine = 0,
+      kDueDateWindow = 1,
+      kRandom = 2
+   };
+
+   shared_ptr<Instance> instance_;
+   Extractor extract_;
+   Importer import_;
+   ArcFilter is_arc_allowed_;
+
+   // regular coils ordered by due date
+   vector<Coil> coils_by_due_date_;
+
+   // objective value of the incumbent the last search started from
+   bool has_searched_ = false;
+   double searched_objective_ = 0;
+   size_t number_of_searches_ = 0;
+
+   // improved schedule whose columns are added by the pricer before it can be imported
+   bool has_pending_solution_ = false;
+   SequenceSolution pending_solution_;
+
+   bool Search(const SequenceSolution &start, unsigned seed, double time_limit, SequenceSolution &best) const;
+   vector<Coil> Destroy(SequenceSolution &solution, Neighborhood neighborhood, std::mt19937 &random) const;
+   bool Repair(SequenceSolution &solution, vector<Coil> freed, std::mt19937 &random) const;
+   bool Evaluate(SequenceSolution &solution) const;
+
+   // delayed coils of a sequence if a coil is inserted at the position, no coil is inserted for a position after its end
+   int CountDelayedCoils(ProductionLine line, const vector<tuple<Coil, Mode>> &sequence, size_t position, tuple<Coil, Mode> inserted) const;
+};
@@ -0,0 +1,196 @@
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+/**
+ * @brief Returns the process wide logger. The logger and its drain thread are created on first use.
+ *
+ * @return Logger& The logger
+ */
+Logger &Logger::Get()
+{
+   static Logger logger;
+   return logger;
+}
+
+/**
+ * @brief Construct a new Logger object and start the drain thread
+ */
+Logger::Logger()
+{
+   drain_thread_ = thread([this]
+                          { DrainLoop(); });
+}
+
+/**
+ * @brief Stop the drain thread and write all remaining messages
+ */
+Logger::~Logger()
+{
+   stop_.store(true, std::memory_order_release);
+   wakeup_.notify_all();
+
+   if (drain_thread_.joinable())
+      drain_thread_.join();
+
+   // write everything that was enqueued after the last drain
+   DrainOnce();
+   cout.flush();
+}
+
+/**
+ * @brief Retire the buffer of an exiting thread. The drain thread releases it once every message was written.
+ */
+Logger::ThreadBufferHandle::~ThreadBufferHandle()
+{
+   if (buffer)
+      buffer->retired.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Get the ring buffer of the calling thread, registering it on first use
+ *
+ * @return RingBuffer& Ring buffer only written by the calling thread
+ */
+Logger::RingBuffer &Logger::GetThreadBuffer()
+{
+   thread_local ThreadBufferHandle handle;
+
+   if (!handle.buffer)
+   {
+      handle.buffer = make_shared<RingBuffer>();
+
+      // only taken once per thread
+      std::lock_guard<std::mutex> guard(buffers_mutex_);
+      buffers_.push_back(handle.buffer);
+   }
+
+   return *handle.buffer;
+}
+
+/**
+ * @brief Enqueue a message. Never takes a lock, except when the calling thread logs for the first time. If the ring
+ * buffer of the calling thread is full, the calling thread waits until the drain thread has freed a slot.
+ *
+ * @param level Severity of the message
+ * @param message The message, already containing its trailing newline
+ */
+void Logger::Write(LogLevel level, string message)
+{
+   auto &buffer = GetThreadBuffer();
+
+   auto head = buffer.head.load(std::memory_order_relaxed);
+
+   // wait for a free slot
+   while (head - buffer.tail.load(std::memory_order_acquire) >= Settings::kLogRingBufferCapacity)
+   {
+      wakeup_.notify_one();
+      std::this_thread::yield();
+   }
+
+   auto &slot = buffer.slots[head % Settings::kLogRingBufferCapacity];
+   slot.level = level;
+   slot.text = std::move(message);
+
+   // publish slot to the drain thread
+   buffer.head.store(head + 1, std::memory_order_release);
+   messages_enqueued_.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Wait until every message that was enqueued before this call has been written to cout
+ */
+void Logger::Flush()
+{
+   auto target = messages_enqueued_.load(std::memory_order_acquire);
+
+   while (messages_written_.load(std::memory_order_acquire) < target)
+   {
+      wakeup_.notify_one();
+      std::this_thread::yield();
+   }
+}
+
+/**
+ * @brief Write all messages currently contained in the buffers of every thread and free buffers of exited threads
+ *
+ * @return size_t Number of written messages
+ */
+size_t Logger::DrainOnce()
+{
+   vector<shared_ptr<RingBuffer>> buffers;
+   {
+      std::lock_guard<std::mutex> guard(buffers_mutex_);
+      buffers = buffers_;
+   }
+
+   size_t written = 0;
+   for (auto &buffer : buffers)
+   {
+      auto tail = buffer->tail.load(std::memory_order_relaxed);
+      auto head = buffer->head.load(std::memory_order_acquire);
+
+      for (; tail < head; tail++)
+      {
+         auto &slot = buffer->slots[tail % Settings::kLogRingBufferCapacity];
+
+         switch (slot.level)
+         {
+         case LogLevel::kWarning:
+            cout << "[WARNING] ";
+            break;
+         case LogLevel::kError:
+            cout << "[ERROR] ";
+            break;
+         default:
+            break;
+         }
+         cout << slot.text;
+
+         // release memory of message
+         string().swap(slot.text);
+         written++;
+      }
+
+      // hand slots back to the producer
+      buffer->tail.store(tail, std::memory_order_release);
+   }
+
+   if (written > 0)
+   {
+      cout.flush();
+      messages_written_.fetch_add(written, std::memory_order_release);
+   }
+
+   // free buffers of threads that have exited and whose messages were all written
+   {
+      std::lock_guard<std::mutex> guard(buffers_mutex_);
+      buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                    [](const shared_ptr<RingBuffer> &buffer)
+                                    {
+                                       return buffer->retired.load(std::memory_order_acquire) &&
+                                              buffer->tail.load(std::memory_order_relaxed) == buffer->head.load(std::memory_order_acquire);
+                                    }),
+                     buffers_.end());
+   }
+
+   return written;
+}
+
+/**
+ * @brief Main loop of the drain thread. Drains all buffers until the logger is destroyed and sleeps for a short
+ * interval whenever there was nothing to write.
+ */
+void Logger::DrainLoop()
+{
+   while (!stop_.load(std::memory_order_acquire))
+   {
+      if (DrainOnce() == 0)
+      {
+         std::unique_lock<std::mutex> lock(wakeup_mutex_);
+         wakeup_.wait_for(lock, std::chrono::milliseconds(Settings::kLogDrainIntervalInMilliseconds));
+      }
+   }
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Settings.h"
+
+using namespace std;
+using Settings::LogLevel;
+
+/**
+ * @brief Checks at compile time if messages of a given level are emitted at all
+ *
+ * @param level The level of the message
+ * @return true If messages of this level reach the log sink
+ */
+constexpr bool IsLogLevelEnabled(LogLevel level)
+{
+   return static_cast<int>(level) >= static_cast<int>(Settings::kMinimumLogLevel);
+}
+
+/**
+ * @brief Leveled, asynchronous logger
+ *
+ * Every thread that logs gets its own single-producer/single-consumer ring buffer, so logging threads never
+ * contend with each other or with any other lock. A background thread drains all buffers and writes the
+ * messages to cout. Messages of one thread keep their order, messages of different threads are interleaved in
+ * the order the drain thread encounters them. Use the PHALS_LOG macro, which removes disabled levels at compile
+ * time.
+ */
+class Logger
+{
+public:
+   // returns the process wide logger, starting the drain thread on first use
+   static Logger &Get();
+
+   ~Logger();
+
+   // enqueue a message into the ring buffer of the calling thread
+   void Write(LogLevel level, string message);
+
+   // block until every message enqueued before this call was written
+   void Flush();
+
+private:
+   Logger();
+
+   struct LogMessage
+   {
+      LogLevel level;
+      string text;
+   };
+
+   // lock-free ring buffer with exactly one producer (owning thread) and one consumer (drain thread)
+   struct RingBuffer
+   {
+      array<LogMessage, Settings::kLogRingBufferCapacity> slots;
+
+      // next slot to be written by the producer
+      atomic<size_t> head{0};
+
+      // next slot to be read by the consumer
+      atomic<size_t> tail{0};
+
+      // set by the producer when its thread exits, the drain thread frees the buffer once it is empty
+      atomic<bool> retired{false};
+   };
+
+   // registers a buffer for the calling thread and retires it when the thread exits
+   struct ThreadBufferHandle
+   {
+      shared_ptr<RingBuffer> buffer;
+      ~ThreadBufferHandle();
+   };
+
+   RingBuffer &GetThreadBuffer();
+
+   // drain every registered buffer once, returns number of written messages
+   size_t DrainOnce();
+   void DrainLoop();
+
+   // buffers of all threads that ever logged, only locked when a thread logs for the first time and by the drain thread
+   std::mutex buffers_mutex_;
+   vector<shared_ptr<RingBuffer>> buffers_;
+
+   // counters of enqueued and written messages, used for flushing
+   atomic<uint64_t> messages_enqueued_{0};
+   atomic<uint64_t> messages_written_{0};
+
+   // signaling of drain thread
+   std::mutex wakeup_mutex_;
+   std::condition_variable wakeup_;
+   atomic<bool> stop_{false};
+
+   thread drain_thread_;
+};
+
+/**
+ * @brief A single log line that collects stream output and hands it to the logger on destruction
+ */
+class LogLine
+{
+public:
+   explicit LogLine(LogLevel level) : level_(level) {}
+
+   ~LogLine()
+   {
+      Logger::Get().Write(level_, stream_.str());
+   }
+
+   template <typename T>
+   LogLine &operator<<(const T &value)
+   {
+      stream_ << value;
+      return *this;
+   }
+
+   // support for manipulators like endl, endl is translated to a newline without flushing
+   LogLine &operator<<(std::ostream &(*manipulator)(std::ostream &))
+   {
+      if (manipulator == static_cast<std::ostream &(*)(std::ostream &)>(std::endl))
+      {
+         stream_ << '\n';
+      }
+      else
+      {
+         manipulator(stream_);
+      }
+      return *this;
+   }
+
+private:
+   LogLevel level_;
+   ostringstream stream_;
+};
+
+/**
+ * @brief Turns a complete log statement into a void expression, see PHALS_LOG. operator& binds weaker than operator<<,
+ * so it applies to the log line after every operand was streamed into it.
+ */
+struct LogLineVoidify
+{
+   void operator&(const LogLine &) {}
+};
+
+// Stream-style logging, e.g. PHALS_LOG(kInfo) << "x = " << x << endl;
+// The statement is a single expression, thus it can be the body of an unbraced if without capturing a following else.
+// If the level is below Settings::kMinimumLogLevel, its operands are never evaluated and the whole statement is removed
+// as dead code.
+#define PHALS_LOG(level)                         \
+   !IsLogLevelEnabled(LogLevel::level) ? (void)0 \
+                                       : LogLineVoidify() & LogLine(LogLevel::level)
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Read-only memory mapping of a whole file, unmapped on destruction
+ */
+class MappedFile
+{
+public:
+   explicit MappedFile(const std::string &nameFile)
+   {
+      int file_descriptor = open(nameFile.c_str(), O_RDONLY);
+      if (file_descriptor < 0)
+         throw std::runtime_error("Cannot read file");
+
+      struct stat file_status;
+      if (fstat(file_descriptor, &file_status) < 0)
+      {
+         close(file_descriptor);
+         throw std::runtime_error("Cannot read file");
+      }
+
+      size_ = file_status.st_size;
+      if (size_ > 0)
+      {
+         data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+         if (data_ == MAP_FAILED)
+         {
+            close(file_descriptor);
+            throw std::runtime_error("Cannot map file");
+         }
+         // file is scanned once from front to back
+         madvise(data_, size_, MADV_SEQUENTIAL);
+      }
+
+      // mapping stays valid after the descriptor is closed
+      close(file_descriptor);
+   }
+
+   ~MappedFile()
+   {
+      if (size_ > 0)
+         munmap(data_, size_);
+   }
+
+   MappedFile(const MappedFile &) = delete;
+   MappedFile &operator=(const MappedFile &) = delete;
+
+   const char *begin() const { return static_cast<const char *>(data_); }
+   const char *end() const { return begin() + size_; }
+   size_t size() const { return size_; }
+
+private:
+   void *data_ = nullptr;
+   size_t size_ = 0;
+};
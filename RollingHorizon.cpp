@@ -0,0 +1,279 @@
+#include "RollingHorizon.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "Logger.h"
+#include "ScheduleExporter.h"
+
+RollingHorizon::RollingHorizon(shared_ptr<Instance> instance, const RunOptions &options) : instance_(instance), options_(options)
+{
+   if (options_.horizon_window_size == 0 || options_.horizon_overlap >= options_.horizon_window_size)
+      throw std::invalid_argument("The overlap of the rolling horizon has to be smaller than its window size");
+}
+
+/**
+ * @brief Solves the windows one after the other. The time limit of the run is shared by the windows, every window
+ * gets the remaining time divided by the number of windows still expected.
+ *
+ * @return RunResult Concatenated sequences of all windows, without solution if a window could not be solved
+ */
+RunResult RollingHorizon::Solve()
+{
+   auto horizon_start = std::chrono::steady_clock::now();
+   auto window_size = options_.horizon_window_size;
+   auto overlap = options_.horizon_overlap;
+
+   // uncommitted coils by due date
+   vector<Coil> pending = instance_->regularCoils;
+   std::stable_sort(pending.begin(), pending.end(), [this](Coil coil_a, Coil coil_b)
+                    { return instance_->dueDates.at(coil_a) < instance_->dueDates.at(coil_b); });
+
+   PHALS_LOG(kInfo) << "[Horizon] Solving " << pending.size() << " coils in windows of " << window_size << " coils with overlap " << overlap << endl;
+
+   // windows are solved as a whole and discarded afterwards
+   auto window_options = options_;
+   window_options.horizon_window_size = 0;
+   window_options.export_path.clear();
+   window_options.display_solution = false;
+   window_options.write_model_files = false;
+   window_options.release_preprocessing_data = true;
+
+   RunResult result;
+   auto &solution = result.solution;
+   for (auto &line : instance_->productionLines)
+   {
+      solution.sequences[line];
+   }
+
+   map<ProductionLine, Anchor> anchors;
+   int delayed_coils = 0;
+   size_t window_number = 0;
+   while (!pending.empty())
+   {
+      window_number++;
+      vector<Coil> window(pending.begin(), pending.begin() + std::min(window_size, pending.size()));
+      bool last_window = window.size() == pending.size();
+
+      // a window usually commits all coils but its overlap
+      size_t remaining_windows = 1 + (pending.size() - window.size() + window_size - overlap - 1) / (window_size - overlap);
+      window_options.time_limit = std::max(Settings::kMinimumHorizonWindowTimeLimit,
+                                           (options_.time_limit - SecondsSince(horizon_start)) / remaining_windows);
+
+      auto window_instance = CreateWindowInstance(window, anchors, instance_->maximumDelayedCoils - delayed_coils);
+      auto window_result = SolveInstance(window_instance, window_options);
+      if (!window_result.has_solution)
+      {
+         PHALS_LOG(kError) << "[Horizon] No solution for window " << window_number << ", " << pending.size() << " coils left" << endl;
+         return RunResult();
+      }
+
+      result.scip_memory = std::max(result.scip_memory, window_result.scip_memory);
+
+      auto &window_solution = window_result.solution;
+      window_solution.ComputeTiming(*window_instance);
+
+      // the coils with the latest due dates are solved again with the next window
+      std::set<Coil> overlap_coils;
+      if (!last_window)
+         overlap_coils.insert(window.end() - overlap, window.end());
+
+      auto committed_end = [&overlap_coils](const vector<tuple<Coil, Mode>> &sequence, size_t begin)
+      {
+         size_t end = begin;
+         while (end < sequence.size() && overlap_coils.count(get<0>(sequence[end])) == 0)
+            end++;
+         return end;
+      };
+
+      size_t number_of_committed_coils = 0;
+      for (auto &[line, sequence] : window_solution.sequences)
+      {
+         assert(anchors.count(line) == 0 || get<0>(sequence.front()) == anchors.at(line).coil);
+         number_of_committed_coils += committed_end(sequence, anchors.count(line)) - anchors.count(line);
+      }
+
+      // every line continues with a coil of the overlap, the whole window is committed to make progress
+      if (number_of_committed_coils == 0)
+         overlap_coils.clear();
+
+      std::set<Coil> committed;
+      for (auto &[line, sequence] : window_solution.sequences)
+      {
+         size_t begin = anchors.count(line);
+         size_t end = committed_end(sequence, begin);
+         if (end == begin)
+            continue;
+
+         for (size_t position = begin; position < end; position++)
+         {
+            auto coil = get<0>(sequence[position]);
+            solution.sequences[line].push_back(sequence[position]);
+            committed.insert(coil);
+            if (window_solution.delayed.at(coil))
+               delayed_coils++;
+
+            auto predecessor = position > 0 ? sequence[position - 1] : make_tuple(window_instance->startCoil, 0);
+            CommitTransition(*window_instance, line, predecessor, sequence[position]);
+         }
+
+         auto [coil, mode] = sequence[end - 1];
+         anchors[line] = {coil, mode, window_solution.start_times.at(coil) + window_instance->GetProcessingTime(coil, line, mode)};
+      }
+
+      // every line may end after its last committed coil
+      for (auto &line : instance_->productionLines)
+      {
+         auto last = anchors.count(line) > 0 ? make_tuple(anchors.at(line).coil, anchors.at(line).mode) : make_tuple(window_instance->startCoil, 0);
+         CommitTransition(*window_instance, line, last, make_tuple(window_instance->endCoil, 0));
+      }
+
+      pending.erase(std::remove_if(pending.begin(), pending.end(), [&committed](Coil coil)
+                                   { return committed.count(coil) > 0; }),
+                    pending.end());
+
+      PHALS_LOG(kInfo) << "[Horizon] Window " << window_number << ": " << committed.size() << "/" << window.size() << " coils committed, "
+                       << pending.size() << " coils left after " << SecondsSince(horizon_start) << "s" << endl;
+   }
+
+   solution.ComputeCost(*instance_);
+   solution.ComputeTiming(*instance_);
+   result.has_solution = true;
+
+   PHALS_LOG(kInfo) << "[Horizon] Finished " << window_number << " windows with cost " << solution.cost << " and " << delayed_coils
+                    << " delayed coils after " << SecondsSince(horizon_start) << "s, SCIP memory of the largest window " << result.scip_memory << " MB"
+                    << endl;
+   Logger::Get().Flush();
+
+   if (!options_.export_path.empty())
+      ScheduleExporter(instance_).WriteFile(solution, options_.export_path);
+
+   result.seconds = SecondsSince(horizon_start);
+   return result;
+}
+
+/**
+ * @brief Builds the instance of a window from the data of its coils and the anchors of the lines. Setup times and
+ * stringer costs are parsed from the instance file for the coils of the window only, so neither the window instance
+ * nor the horizon ever holds more than the transitions between the coils of one window.
+ *
+ * The anchor of a line can only be produced on its line in its committed mode. Its processing time is its committed
+ * completion time, so started at 0 it completes when it does in the committed sequence. Arcs from the start coil to
+ * other coils and from other coils to the anchor are eliminated on its line, thus the anchor is produced first.
+ *
+ * @param window Uncommitted coils of the window
+ * @param anchors Last committed coil per line, lines without a committed coil start empty
+ * @param maximum_delayed_coils Delayed coils left for the window after the committed ones
+ */
+shared_ptr<Instance> RollingHorizon::CreateWindowInstance(const vector<Coil> &window, const map<ProductionLine, Anchor> &anchors,
+                                                          int maximum_delayed_coils) const
+{
+   auto window_instance = make_shared<Instance>();
+   auto &sub = *window_instance;
+
+   // coils keep their numbers, thus solutions of the window are solutions of the instance
+   sub.startCoil = instance_->startCoil;
+   sub.endCoil = instance_->endCoil;
+   sub.numberOfCoils = instance_->numberOfCoils;
+   sub.numberOfProductionLines = instance_->numberOfProductionLines;
+   sub.numberOfModes = instance_->numberOfModes;
+   sub.maximumDelayedCoils = maximum_delayed_coils;
+   sub.productionLines = instance_->productionLines;
+   sub.allModes = instance_->allModes;
+
+   sub.regularCoils = window;
+   for (auto &[line, anchor] : anchors)
+   {
+      sub.regularCoils.push_back(anchor.coil);
+   }
+   std::sort(sub.regularCoils.begin(), sub.regularCoils.end());
+
+   // coil sets in the order of parse
+   sub.coils = sub.coilsWithoutStartCoil = sub.coilsWithoutEndCoil = sub.regularCoils;
+   sub.coils.push_back(sub.startCoil);
+   sub.coils.push_back(sub.endCoil);
+   sub.coilsWithoutEndCoil.push_back(sub.startCoil);
+   sub.coilsWithoutStartCoil.push_back(sub.endCoil);
+
+   for (auto &coil : window)
+   {
+      sub.dueDates[coil] = instance_->dueDates.at(coil);
+      for (auto &line : sub.productionLines)
+      {
+         auto &coil_modes = instance_->GetModes(coil, line);
+         if (coil_modes.empty())
+            continue;
+
+         sub.modes[make_tuple(coil, line)] = coil_modes;
+         for (auto &mode : coil_modes)
+         {
+            sub.processingTimes[make_tuple(coil, line, mode)] = instance_->GetProcessingTime(coil, line, mode);
+         }
+      }
+   }
+
+   for (auto &[line, anchor] : anchors)
+   {
+      sub.modes[make_tuple(anchor.coil, line)] = {anchor.mode};
+      sub.processingTimes[make_tuple(anchor.coil, line, anchor.mode)] = anchor.completion_time;
+      // the anchor is never delayed in the window, its delay is committed already
+      sub.dueDates[anchor.coil] = static_cast<DueDate>(std::ceil(anchor.completion_time));
+   }
+
+   for (auto &line : sub.productionLines)
+   {
+      sub.modes[make_tuple(sub.startCoil, line)] = {0};
+      sub.modes[make_tuple(sub.endCoil, line)] = {0};
+   }
+
+   // the coil data of the parsed instance is discarded with it, only the transitions are kept
+   Instance transitions;
+   transitions.parse(options_.instance_path, std::set<Coil>(sub.coils.begin(), sub.coils.end()));
+   sub.setupTimes = std::move(transitions.setupTimes);
+   sub.stringerCosts = std::move(transitions.stringerCosts);
+   sub.stringerNeeded = std::move(transitions.stringerNeeded);
+
+   if (Settings::kEnablePreprocessing)
+      sub.Preprocess();
+
+   for (auto &[line, anchor] : anchors)
+   {
+      for (auto &coil : sub.regularCoils)
+      {
+         if (coil == anchor.coil)
+            continue;
+
+         for (auto &mode : sub.GetModes(coil, line))
+         {
+            sub.eliminatedArcs.insert(make_tuple(sub.startCoil, 0, coil, mode, line));
+            sub.eliminatedArcs.insert(make_tuple(coil, mode, anchor.coil, anchor.mode, line));
+         }
+      }
+   }
+
+   sub.ComputeBigM();
+   sub.DetectIdenticalLines();
+
+   return window_instance;
+}
+
+/**
+ * @brief Keeps the setup time and the stringer cost of a committed transition in the instance of the horizon, so the
+ * cost, the timing and the export of the concatenated sequences need no other transitions
+ */
+void RollingHorizon::CommitTransition(const Instance &window_instance, ProductionLine line, tuple<Coil, Mode> from, tuple<Coil, Mode> to)
+{
+   auto arc = make_tuple(get<0>(from), get<1>(from), get<0>(to), get<1>(to), line);
+
+   auto setup_time = window_instance.setupTimes.find(arc);
+   if (setup_time != window_instance.setupTimes.end())
+      instance_->setupTimes[arc] = setup_time->second;
+
+   auto stringer_cost = window_instance.stringerCosts.find(arc);
+   if (stringer_cost != window_instance.stringerCosts.end())
+   {
+      instance_->stringerCosts[arc] = stringer_cost->second;
+      instance_->stringerNeeded[arc] = true;
+   }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "InstanceRun.h"
+
+/**
+ * @brief Solves instances that are too large for the models as a whole window by window
+ *
+ * Coils are ordered by due date. Every window consists of the uncommitted coils with the earliest due dates and is
+ * solved as an instance of its own in the run mode of the options. The last committed coil of every line is part of
+ * the window as its anchor: it has to be produced first on its line and completes at its committed completion time,
+ * so the window continues the committed sequences. Per line, coils are committed up to the first coil of the overlap,
+ * i.e. the coils of the window with the latest due dates, which are solved again with the next window. Only the
+ * models and the transitions of one window exist at a time: every window parses the transitions between its coils
+ * from the instance file, the instance of the horizon holds the transitions of the committed sequences only.
+ */
+class RollingHorizon
+{
+public:
+   // instance parsed from options.instance_path without transitions, see Instance::parse
+   RollingHorizon(shared_ptr<Instance> instance, const RunOptions &options);
+
+   // solves all windows, the result contains the committed sequences of all windows
+   RunResult Solve();
+
+private:
+   // last committed coil of a line
+   struct Anchor
+   {
+      Coil coil;
+      Mode mode;
+      double completion_time;
+   };
+
+   shared_ptr<Instance> instance_;
+   RunOptions options_;
+
+   void CommitTransition(const Instance &window_instance, ProductionLine line, tuple<Coil, Mode> from, tuple<Coil, Mode> to);
+   shared_ptr<Instance> CreateWindowInstance(const vector<Coil> &window, const map<ProductionLine, Anchor> &anchors, int maximum_delayed_coils) const;
+};
@@ -0,0 +1,203 @@
+#include "ScheduleExporter.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "Logger.h"
+
+ScheduleExporter::ScheduleExporter(shared_ptr<Instance> instance) : instance_(instance)
+{
+}
+
+/**
+ * @brief Format of an export file by the extension of its path
+ */
+ScheduleExporter::Format ScheduleExporter::GetFormatOfPath(const string &path)
+{
+   string extension = ".csv";
+   if (path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0)
+      return Format::kCsv;
+
+   return Format::kJson;
+}
+
+/**
+ * @brief Calls visit for every transition of a line from the start coil to the end coil
+ */
+template <typename Visitor>
+void ScheduleExporter::VisitTransitions(const SequenceSolution &solution, ProductionLine line, Visitor visit) const
+{
+   auto &sequence = solution.sequences.at(line);
+
+   Transition transition{};
+   transition.line = line;
+   transition.coil_j = instance_->startCoil;
+   transition.mode_j = 0;
+
+   for (size_t position = 0; position <= sequence.size(); position++)
+   {
+      transition.position = position;
+      transition.coil_i = transition.coil_j;
+      transition.mode_i = transition.mode_j;
+      std::tie(transition.coil_j, transition.mode_j) = position < sequence.size() ? sequence[position] : make_tuple(instance_->endCoil, 0);
+
+      transition.setup_time = instance_->GetSetupTime(transition.coil_i, transition.mode_i, transition.coil_j, transition.mode_j, line);
+      transition.stringer_cost = instance_->GetStringerCost(transition.coil_i, transition.mode_i, transition.coil_j, transition.mode_j, line);
+
+      if (position < sequence.size())
+      {
+         transition.start_time = solution.start_times.at(transition.coil_j);
+         transition.end_time = transition.start_time + instance_->GetProcessingTime(transition.coil_j, line, transition.mode_j);
+         transition.due_date = instance_->dueDates.at(transition.coil_j);
+         transition.lateness = std::max(0.0, transition.end_time - transition.due_date);
+         transition.delayed = solution.delayed.at(transition.coil_j);
+      }
+
+      visit(transition);
+   }
+}
+
+/**
+ * @brief Writes a solution to a stream
+ */
+void ScheduleExporter::Write(const SequenceSolution &solution, ostream &os, Format format) const
+{
+   auto precision = os.precision(12);
+
+   switch (format)
+   {
+   case Format::kJson:
+      WriteJson(solution, os);
+      break;
+   case Format::kCsv:
+      WriteCsv(solution, os);
+      break;
+   }
+
+   os.precision(precision);
+}
+
+/**
+ * @brief Writes a solution to a file in the format of its extension, see GetFormatOfPath
+ *
+ * @return true If the file was written
+ */
+bool ScheduleExporter::WriteFile(const SequenceSolution &solution, const string &path) const
+{
+   std::ofstream file(path);
+   if (!file)
+   {
+      PHALS_LOG(kError) << "Could not open " << path << " to export the schedule" << endl;
+      return false;
+   }
+
+   Write(solution, file, GetFormatOfPath(path));
+   file.close();
+
+   if (!file)
+   {
+      PHALS_LOG(kError) << "Could not write the schedule to " << path << endl;
+      return false;
+   }
+
+   PHALS_LOG(kInfo) << "Schedule exported to " << path << endl;
+   return true;
+}
+
+/**
+ * @brief Writes a coil, the sentinel coils as start and end
+ */
+void ScheduleExporter::WriteCoil(ostream &os, Coil coil) const
+{
+   if (coil == instance_->startCoil)
+      os << "start";
+   else if (coil == instance_->endCoil)
+      os << "end";
+   else
+      os << coil;
+}
+
+/**
+ * @brief Writes one object per line with its coils and the stringer cost of the transition to the end coil, followed
+ * by the totals of the solution
+ */
+void ScheduleExporter::WriteJson(const SequenceSolution &solution, ostream &os) const
+{
+   double total_stringer_cost = 0;
+   double total_lateness = 0;
+   double makespan = 0;
+   int delayed_coils = 0;
+
+   os << "{\"lines\":[";
+   bool first_line = true;
+   for (auto &[line, _] : solution.sequences)
+   {
+      os << (first_line ? "" : ",") << "{\"line\":" << line << ",\"coils\":[";
+      first_line = false;
+
+      double line_stringer_cost = 0;
+      double line_end_time = 0;
+      VisitTransitions(solution, line, [&](const Transition &transition)
+                       {
+         line_stringer_cost += transition.stringer_cost;
+         if (transition.coil_j == instance_->endCoil)
+         {
+            os << "],\"end_setup_time\":" << transition.setup_time << ",\"end_stringer_cost\":" << transition.stringer_cost;
+            return;
+         }
+
+         os << (transition.position == 0 ? "" : ",")
+            << "{\"coil\":" << transition.coil_j
+            << ",\"mode\":" << transition.mode_j
+            << ",\"start\":" << transition.start_time
+            << ",\"end\":" << transition.end_time
+            << ",\"due\":" << transition.due_date
+            << ",\"lateness\":" << transition.lateness
+            << ",\"delayed\":" << (transition.delayed ? "true" : "false")
+            << ",\"setup_time\":" << transition.setup_time
+            << ",\"stringer_cost\":" << transition.stringer_cost << "}";
+
+         line_end_time = transition.end_time;
+         total_lateness += transition.lateness;
+         delayed_coils += transition.delayed ? 1 : 0; });
+
+      os << ",\"stringer_cost\":" << line_stringer_cost << ",\"end_time\":" << line_end_time << "}";
+
+      total_stringer_cost += line_stringer_cost;
+      makespan = std::max(makespan, line_end_time);
+   }
+
+   os << "],\"cost\":" << solution.cost
+      << ",\"stringer_cost\":" << total_stringer_cost
+      << ",\"delayed_coils\":" << delayed_coils
+      << ",\"total_lateness\":" << total_lateness
+      << ",\"makespan\":" << makespan << "}" << endl;
+}
+
+/**
+ * @brief Writes one row per transition, the timing columns are empty for the transition to the end coil. Totals follow
+ * by summing the columns.
+ */
+void ScheduleExporter::WriteCsv(const SequenceSolution &solution, ostream &os) const
+{
+   os << "line,position,from_coil,from_mode,coil,mode,setup_time,stringer_cost,start,end,due,lateness,delayed" << endl;
+
+   for (auto &[line, _] : solution.sequences)
+   {
+      VisitTransitions(solution, line, [&](const Transition &transition)
+                       {
+         os << transition.line << "," << transition.position << ",";
+         WriteCoil(os, transition.coil_i);
+         os << "," << transition.mode_i << ",";
+         WriteCoil(os, transition.coil_j);
+         os << "," << transition.mode_j << "," << transition.setup_time << "," << transition.stringer_cost;
+
+         if (transition.coil_j == instance_->endCoil)
+            os << ",,,,," << '\n';
+         else
+            os << "," << transition.start_time << "," << transition.end_time << "," << transition.due_date << ","
+               << transition.lateness << "," << (transition.delayed ? 1 : 0) << '\n'; });
+   }
+
+   os.flush();
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+
+#include "Instance.h"
+#include "SequenceSolution.h"
+
+/**
+ * @brief Writes a solution in a machine-readable format: the sequence of every line with modes, start and end times,
+ * lateness and the setup time and stringer cost of every transition together with totals
+ *
+ * The output is streamed transition by transition, nothing but the solution itself is held in memory. Works for the
+ * solutions of every model, see SequenceSolution.
+ */
+class ScheduleExporter
+{
+public:
+   enum class Format
+   {
+      kJson = 0,
+      kCsv = 1
+   };
+
+   ScheduleExporter(shared_ptr<Instance> instance);
+
+   // csv for paths ending in .csv, json else
+   static Format GetFormatOfPath(const string &path);
+
+   // the timing of the solution has to be computed, see SequenceSolution::ComputeTiming
+   void Write(const SequenceSolution &solution, ostream &os, Format format) const;
+   bool WriteFile(const SequenceSolution &solution, const string &path) const;
+
+private:
+   shared_ptr<Instance> instance_;
+
+   // transition from the previous coil of a line to a coil, the coil is the end coil for the last transition
+   struct Transition
+   {
+      ProductionLine line;
+      size_t position;
+      Coil coil_i;
+      Mode mode_i;
+      Coil coil_j;
+      Mode mode_j;
+      double setup_time;
+      double stringer_cost;
+      // timing of coil j, only set if it is a regular coil
+      double start_time;
+      double end_time;
+      int due_date;
+      double lateness;
+      bool delayed;
+   };
+
+   template <typename Visitor>
+   void VisitTransitions(const SequenceSolution &solution, ProductionLine line, Visitor visit) const;
+
+   void WriteJson(const SequenceSolution &solution, ostream &os) const;
+   void WriteCsv(const SequenceSolution &solution, ostream &os) const;
+   void WriteCoil(ostream &os, Coil coil) const;
+};
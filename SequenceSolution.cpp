@@ -0,0 +1,108 @@
+#include "SequenceSolution.h"
+
+#include "Settings.h"
+
+/**
+ * @brief Computes the earliest start time of every coil and if it is delayed. The first coil of a line starts at time
+ * 0, every other coil as soon as its predecessor is processed and the setup is done. Earlier start times never delay
+ * a coil, thus this timing is feasible whenever any timing of the sequences is.
+ */
+void SequenceSolution::ComputeTiming(const Instance &instance)
+{
+   start_times.clear();
+   delayed.clear();
+
+   for (auto &[line, sequence] : sequences)
+   {
+      double time = 0;
+      for (size_t position = 0; position < sequence.size(); position++)
+      {
+         auto [coil, mode] = sequence[position];
+         start_times[coil] = time;
+         time += instance.GetProcessingTime(coil, line, mode);
+         delayed[coil] = time > instance.dueDates.at(coil) + Settings::kIncumbentExchangeTolerance;
+
+         if (position + 1 < sequence.size())
+         {
+            auto [next_coil, next_mode] = sequence[position + 1];
+            time += instance.GetSetupTime(coil, mode, next_coil, next_mode, line);
+         }
+      }
+   }
+}
+
+/**
+ * @brief Sums the stringer costs of all transitions of the sequences including those from the start coil and to the
+ * end coil
+ */
+void SequenceSolution::ComputeCost(const Instance &instance)
+{
+   cost = 0;
+   for (auto &[line, sequence] : sequences)
+   {
+      Coil coil_i = instance.startCoil;
+      Mode mode_i = 0;
+      for (size_t position = 0; position <= sequence.size(); position++)
+      {
+         auto [coil_j, mode_j] = position < sequence.size() ? sequence[position] : make_tuple(instance.endCoil, 0);
+         cost += instance.GetStringerCost(coil_i, mode_i, coil_j, mode_j, line);
+         coil_i = coil_j;
+         mode_i = mode_j;
+      }
+   }
+}
+
+/**
+ * @brief Reconstructs the sequences of a solution from its selected arcs. The successors of all coils are stored in
+ * an array per line in one pass over the arcs, so every sequence is followed in time linear in its length instead of
+ * searching the successor of every coil among all arc variables of the model.
+ *
+ * @param arcs Arcs with value one in the solution
+ * @param lines Lines of the solution per line of the model. If a line of the model stands for several identical
+ * lines, its k-th successor of the start coil begins the sequence of the k-th of them.
+ */
+SequenceSolution SequenceSolution::FromArcs(const Instance &instance, const vector<Arc> &arcs, const map<ProductionLine, vector<ProductionLine>> &lines)
+{
+   // coils are numbered consecutively from the start coil to the end coil
+   auto index = [&instance](Coil coil)
+   { return static_cast<size_t>(coil - instance.startCoil); };
+   auto number_of_coils = index(instance.endCoil) + 1;
+
+   map<ProductionLine, vector<vector<tuple<Coil, Mode>>>> successors;
+   for (auto &[coil_i, coil_j, line, mode_i, mode_j] : arcs)
+   {
+      auto &line_successors = successors[line];
+      if (line_successors.empty())
+         line_successors.resize(number_of_coils);
+
+      line_successors[index(coil_i)].push_back(make_tuple(coil_j, mode_j));
+   }
+
+   SequenceSolution solution;
+   for (auto &[model_line, solution_lines] : lines)
+   {
+      auto line_successors = successors.find(model_line);
+
+      for (size_t k = 0; k < solution_lines.size(); k++)
+      {
+         auto &sequence = solution.sequences[solution_lines[k]];
+         if (line_successors == successors.end() || k >= line_successors->second[index(instance.startCoil)].size())
+            continue;
+
+         auto &next = line_successors->second;
+         auto [coil, mode] = next[index(instance.startCoil)][k];
+
+         // every regular coil occurs at most once, so a longer sequence can only come from a cycle
+         while (coil != instance.endCoil && sequence.size() < instance.regularCoils.size())
+         {
+            sequence.push_back(make_tuple(coil, mode));
+            if (next[index(coil)].empty())
+               break;
+
+            std::tie(coil, mode) = next[index(coil)].front();
+         }
+      }
+   }
+
+   return solution;
+}
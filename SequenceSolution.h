@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Instance.h"
+
+/**
+ * @brief A solution independent of the model it was found by: the coils produced on every line together with their
+ * modes in production order. Start times and delays follow from the sequences, see ComputeTiming.
+ */
+struct SequenceSolution
+{
+   double cost = 0;
+
+   // regular coils and their modes in production order per line, the sentinel coils are implicit
+   map<ProductionLine, vector<tuple<Coil, Mode>>> sequences;
+
+   // earliest start time of every regular coil and if it is completed after its due date
+   map<Coil, double> start_times;
+   map<Coil, bool> delayed;
+
+   void ComputeTiming(const Instance &instance);
+   void ComputeCost(const Instance &instance);
+
+   // arc (coil i, coil j, line, mode i, mode j) selected by a solution of a model
+   using Arc = tuple<Coil, Coil, ProductionLine, Mode, Mode>;
+
+   // sequences of the selected arcs, the arcs of a line of the model are split onto the given lines
+   static SequenceSolution FromArcs(const Instance &instance, const vector<Arc> &arcs, const map<ProductionLine, vector<ProductionLine>> &lines);
+};
@@ -1,11 +1,75 @@
 #pragma once
 
+#include <cstddef>
+
 namespace Settings
 {
+    // severity of log messages, see Logger.h
+    enum class LogLevel
+    {
+        kDebug = 0,
+        kInfo = 1,
+        kWarning = 2,
+        kError = 3
+    };
+
     constexpr int kSCIPMaxStringLength = 1024;
-    constexpr double kBigM = 1000;
 
     
+    // formulation of the timing constraints, i.e. delay linking and start time linking, in compact model and subproblems
+    enum class TimingFormulation
+    {
+        // all big M constraints are created up front
+        kBigM = 0,
+        // start time linking constraints are only added once a solution selects the corresponding arc and violates
+        // them, see StartTimeLinkingConshdlr
+        kLazy = 1,
+        // implications of arcs and delays are expressed by indicator constraints, no big M
+        kIndicator = 2
+    };
+
+    // used if no formulation is passed on the command line, compare the others with testing/run_all_timing.sh first
+    constexpr TimingFormulation kDefaultTimingFormulation = TimingFormulation::kBigM;
+
+    // which models are built and how they are solved, only the models of the selected mode are built
+    enum class RunMode
+    {
+        // compact model first, then branch and price, each with the full time limit
+        kSequential = 0,
+        // both at once on separate threads, sharing incumbents until one of them proves optimality, see
+        // IncumbentExchange
+        kPortfolio = 1,
+        // compact model only
+        kCompact = 2,
+        // branch and price only
+        kBranchAndPrice = 3
+    };
+
+    // used if no run mode is passed on the command line
+    constexpr RunMode kDefaultRunMode = RunMode::kSequential;
+
+    // minimal improvement of the objective for a solution to be shared between the solvers of the portfolio
+    constexpr double kIncumbentExchangeTolerance = 1e-6;
+
+    // in the sequential run mode, start branch and price with the incumbent of the compact model as initial columns
+    constexpr bool kTransferCompactIncumbent = true;
+
+    // remove dominated modes and infeasible arcs when reading an instance, see Instance::Preprocess
+    constexpr bool kEnablePreprocessing = true;
+
+    // load instances from a binary cache next to the instance file if it matches the file, written on the first read
+    constexpr bool kEnableInstanceCache = true;
+
+    // price identical lines, see Instance::DetectIdenticalLines, by one subproblem whose convexity row sums to the
+    // number of identical lines
+    constexpr bool kAggregateIdenticalLines = true;
+    // order identical lines in the compact model by the first coil assigned to them
+    constexpr bool kBreakLineSymmetry = true;
+
+    // build the compact model, the master problem and the subproblems of all lines on separate threads, each of them
+    // owns its SCIP instance and only reads the instance
+    constexpr bool kEnableParallelModelConstruction = true;
+
     constexpr bool kGenerateInitialTrivialColumn = false;
 
     constexpr double kDynamicGapMaxRounds = 20;
@@ -20,8 +84,71 @@ namespace Settings
     
     constexpr bool kEnableSubproblemInterruption = true;
 
+    // maximum number of columns per line added to the master problem in one pricing round, 0 for no limit
+    constexpr std::size_t kMaxColumnsPerLineAndRound = 10;
+
+    // large neighborhood search (LNS) on the incumbent of the master problem, see LargeNeighborhoodSearchHeur
+    constexpr bool kEnableLns = false;
+    // workers searching at the same time, each on its own thread
+    constexpr std::size_t kLnsThreads = 4;
+    // coils removed and inserted again by one destroy and repair step
+    constexpr std::size_t kLnsFreedCoils = 8;
+    // destroy and repair steps of one worker in one search, the search also stops after a number of steps without a
+    // better schedule or at its time limit in seconds
+    constexpr std::size_t kLnsMaxIterations = 1000;
+    constexpr std::size_t kLnsMaxIterationsWithoutImprovement = 100;
+    constexpr double kLnsTimeLimit = 1;
+
     constexpr double kDefaultTimeLimit = 1e+20;
+
+    // write the models, the master problem and subproblems of every pricing round and the branch and bound tree to the
+    // working directory, only for single runs: batch mode and the service never write them
+    constexpr bool kWriteModelFiles = false;
+
+    // number of instances solved at the same time in batch mode, see BatchRunner
+    constexpr std::size_t kDefaultBatchConcurrency = 1;
+    // memory limit of SCIP in megabytes per instance in batch mode, 0 for no limit
+    constexpr double kDefaultBatchMemoryLimit = 0;
+
+    // number of connections served at the same time by the solver service, see SolverService
+    constexpr std::size_t kDefaultServiceWorkers = 4;
+    // seconds the solver service waits before accepting again if it ran out of file descriptors or memory
+    constexpr double kServiceAcceptBackoff = 0.1;
+
+    // coils per window of the rolling horizon, see RollingHorizon, 0 solves every instance as a whole
+    constexpr std::size_t kDefaultHorizonWindowSize = 0;
+    // coils with the latest due dates of a window that are solved again with the next window
+    constexpr std::size_t kDefaultHorizonOverlap = 5;
+    // every window gets at least this time limit in seconds, even if the time limit of the run is used up
+    constexpr double kMinimumHorizonWindowTimeLimit = 1;
     
+    // price by labeling on a time-bucketed network before solving the subproblem MIP, see BucketPricing
+    // the MIP is only solved if labeling does not find a column with negative reduced cost
+    // not yet measured against pricing by the MIP only
+    constexpr bool kEnableBucketPricing = false;
+    // upper bound on (coil, mode, bucket) nodes per line, determines the bucket width
+    constexpr std::size_t kBucketPricingMaxNodes = 20000;
+    // upper bound in MB on the arcs of a line, lines with more arcs are priced by the MIP only
+    constexpr std::size_t kBucketPricingMaxMemory = 256;
+    // number of non-dominated labels kept per node
+    constexpr std::size_t kBucketPricingLabelsPerNode = 4;
+    // number of columns returned by one labeling run
+    constexpr std::size_t kBucketPricingMaxColumns = 10;
+    constexpr double kBucketPricingReducedCostTolerance = 1e-6;
+
     constexpr bool kReconstructScheduleFromSolution = true;
     constexpr bool kEnableReoptimization = false;
+
+    // inject routes of the previous pricing round and LP-active columns as starting solutions of the subproblems
+    // not used if reoptimization is enabled
+    constexpr bool kEnableWarmStart = true;
+    // number of best routes of the last subproblem solve kept per line for warm starting
+    constexpr std::size_t kWarmStartSolutionsPerLine = 5;
+
+    // messages below this level are removed at compile time, kDebug includes every generated column
+    constexpr LogLevel kMinimumLogLevel = LogLevel::kInfo;
+    // number of messages a single thread can buffer before it has to wait for the drain thread
+    constexpr std::size_t kLogRingBufferCapacity = 1024;
+    // interval in which the drain thread polls the buffers of all threads if it was not woken up
+    constexpr int kLogDrainIntervalInMilliseconds = 5;
 }
\ No newline at end of file
@@ -0,0 +1,621 @@
+#include "SolverService.h"
+
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "InstanceDelta.h"
+#include "Logger.h"
+#include "ScheduleExporter.h"
+#include "compact/CompactModel.h"
+
+/**
+ * @brief Stream buffer writing to a socket, responses are sent in chunks of the buffer size instead of being built
+ * as one string
+ */
+class SocketBuffer : public std::streambuf
+{
+public:
+   SocketBuffer(int fd) : fd_(fd)
+   {
+      setp(buffer_, buffer_ + sizeof(buffer_));
+   }
+
+   ~SocketBuffer()
+   {
+      sync();
+   }
+
+protected:
+   int overflow(int character) override
+   {
+      if (sync() != 0)
+         return traits_type::eof();
+
+      if (character != traits_type::eof())
+      {
+         *pptr() = static_cast<char>(character);
+         pbump(1);
+      }
+      return character;
+   }
+
+   int sync() override
+   {
+      for (char *begin = pbase(); begin < pptr();)
+      {
+         // a closed connection must not raise SIGPIPE
+         auto sent = send(fd_, begin, pptr() - begin, MSG_NOSIGNAL);
+         if (sent <= 0)
+            return -1;
+         begin += sent;
+      }
+
+      setp(buffer_, buffer_ + sizeof(buffer_));
+      return 0;
+   }
+
+private:
+   int fd_;
+   char buffer_[4096];
+};
+
+/**
+ * @brief Takes the next complete line of a connection without the line break
+ *
+ * @param pending Bytes received after the last taken line
+ * @return false If no complete line was received yet
+ */
+static bool TakeLine(string &pending, string &line)
+{
+   auto line_end = pending.find('\n');
+   if (line_end == string::npos)
+      return false;
+
+   line = pending.substr(0, line_end);
+   pending.erase(0, line_end + 1);
+   if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+   return true;
+}
+
+SolverService::SolverService(string socket_path, size_t workers)
+    : socket_path_(std::move(socket_path)), workers_(std::max<size_t>(workers, 1))
+{
+}
+
+SolverService::~SolverService()
+{
+   if (listen_fd_ >= 0)
+      close(listen_fd_);
+   for (auto fd : wake_fds_)
+   {
+      if (fd >= 0)
+         close(fd);
+   }
+}
+
+/**
+ * @brief Listens on the socket until a shutdown request. Accepted connections are idle until they receive a request,
+ * then they are handed to the worker pool. Workers give a connection back after every request.
+ */
+void SolverService::Run()
+{
+   sockaddr_un address{};
+   address.sun_family = AF_UNIX;
+   if (socket_path_.size() >= sizeof(address.sun_path))
+      throw std::invalid_argument("Socket path " + socket_path_ + " is too long");
+   std::strncpy(address.sun_path, socket_path_.c_str(), sizeof(address.sun_path) - 1);
+
+   listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (listen_fd_ < 0)
+      throw std::runtime_error(string("Could not create socket: ") + std::strerror(errno));
+
+   // a socket file left by a previous service would make bind fail
+   unlink(socket_path_.c_str());
+   if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listen_fd_, SOMAXCONN) != 0)
+      throw std::runtime_error("Could not listen on " + socket_path_ + ": " + std::strerror(errno));
+
+   // wake ups are only signals, neither end may block
+   if (pipe(wake_fds_) != 0 || fcntl(wake_fds_[0], F_SETFL, O_NONBLOCK) != 0 || fcntl(wake_fds_[1], F_SETFL, O_NONBLOCK) != 0)
+      throw std::runtime_error(string("Could not create wake up pipe: ") + std::strerror(errno));
+
+   vector<thread> workers;
+   for (size_t worker = 0; worker < workers_; worker++)
+   {
+      workers.emplace_back(&SolverService::ServeRequests, this);
+   }
+
+   PHALS_LOG(kInfo) << "[Service] Listening on " << socket_path_ << " with " << workers_ << " workers" << endl;
+   Logger::Get().Flush();
+
+   while (!stopped_)
+   {
+      vector<shared_ptr<Connection>> idle;
+      {
+         std::lock_guard<std::mutex> lock(connections_mutex_);
+         idle.swap(idle_connections_);
+      }
+
+      vector<pollfd> watched = {{listen_fd_, POLLIN, 0}, {wake_fds_[0], POLLIN, 0}};
+      for (auto &connection : idle)
+      {
+         watched.push_back({connection->fd, POLLIN, 0});
+      }
+
+      if (poll(watched.data(), watched.size(), -1) < 0)
+      {
+         if (errno == EINTR)
+         {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            idle_connections_.insert(idle_connections_.end(), idle.begin(), idle.end());
+            continue;
+         }
+
+         PHALS_LOG(kError) << "[Service] Poll failed: " << std::strerror(errno) << endl;
+         std::lock_guard<std::mutex> lock(connections_mutex_);
+         idle_connections_.insert(idle_connections_.end(), idle.begin(), idle.end());
+         break;
+      }
+
+      // wake ups only interrupt the poll
+      char drained[64];
+      while (read(wake_fds_[0], drained, sizeof(drained)) > 0)
+      {
+      }
+
+      {
+         // readable connections have a request or were closed, the worker finds out which
+         std::lock_guard<std::mutex> lock(connections_mutex_);
+         for (size_t connection = 0; connection < idle.size(); connection++)
+         {
+            if (watched[connection + 2].revents != 0)
+            {
+               ready_connections_.push(idle[connection]);
+               connection_available_.notify_one();
+            }
+            else
+            {
+               idle_connections_.push_back(idle[connection]);
+            }
+         }
+      }
+
+      if (watched[0].revents != 0 && !stopped_)
+         AcceptConnection();
+   }
+   Stop();
+
+   // workers finish their current request, connections are closed afterwards
+   for (auto &worker : workers)
+   {
+      worker.join();
+   }
+
+   for (auto fd : open_connections_)
+   {
+      close(fd);
+   }
+   open_connections_.clear();
+   idle_connections_.clear();
+
+   close(listen_fd_);
+   listen_fd_ = -1;
+   unlink(socket_path_.c_str());
+
+   PHALS_LOG(kInfo) << "[Service] Stopped" << endl;
+   Logger::Get().Flush();
+}
+
+/**
+ * @brief Accepts a connection whose listen socket is readable. Running out of file descriptors or memory is temporary,
+ * the service waits before it accepts again instead of polling the pending connection over and over. Other errors
+ * stop the service.
+ */
+void SolverService::AcceptConnection()
+{
+   int fd = accept(listen_fd_, nullptr, nullptr);
+   if (fd < 0)
+   {
+      // interrupted or aborted by the client before it was accepted
+      if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN || errno == EWOULDBLOCK)
+         return;
+
+      if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+      {
+         PHALS_LOG(kWarning) << "[Service] Could not accept a connection: " << std::strerror(errno) << ", retrying in "
+                             << Settings::kServiceAcceptBackoff << "s" << endl;
+         std::this_thread::sleep_for(std::chrono::duration<double>(Settings::kServiceAcceptBackoff));
+         return;
+      }
+
+      PHALS_LOG(kError) << "[Service] Could not accept a connection: " << std::strerror(errno) << ", stopping" << endl;
+      Stop();
+      return;
+   }
+
+   auto connection = make_shared<Connection>();
+   connection->fd = fd;
+   connection->options.display_solution = false;
+   // concurrent solves would overwrite the model files of each other
+   connection->options.write_model_files = false;
+   // cached instances are solved again, see Instance::ReleasePreprocessingData
+   connection->options.release_preprocessing_data = false;
+
+   std::lock_guard<std::mutex> lock(connections_mutex_);
+   open_connections_.insert(fd);
+   idle_connections_.push_back(connection);
+}
+
+/**
+ * @brief Interrupts the poll of Run
+ */
+void SolverService::WakeUp()
+{
+   char signal = 0;
+   // a full pipe wakes up the poll anyway
+   (void)!write(wake_fds_[1], &signal, 1);
+}
+
+/**
+ * @brief Stops accepting connections and requests. Open connections are shut down, so their clients see the end of
+ * the service and requests being served cannot send further responses. Run returns once the workers finished.
+ */
+void SolverService::Stop()
+{
+   {
+      std::lock_guard<std::mutex> lock(connections_mutex_);
+      stopped_ = true;
+      shutdown(listen_fd_, SHUT_RDWR);
+      for (auto fd : open_connections_)
+      {
+         shutdown(fd, SHUT_RDWR);
+      }
+   }
+   WakeUp();
+   connection_available_.notify_all();
+}
+
+/**
+ * @brief Work loop of a worker: serves one request of a ready connection after the other
+ */
+void SolverService::ServeRequests()
+{
+   while (true)
+   {
+      shared_ptr<Connection> connection;
+      {
+         std::unique_lock<std::mutex> lock(connections_mutex_);
+         connection_available_.wait(lock, [this]
+                                    { return stopped_ || !ready_connections_.empty(); });
+         if (stopped_)
+            return;
+
+         connection = ready_connections_.front();
+         ready_connections_.pop();
+      }
+
+      if (ServeRequest(*connection))
+         ReleaseConnection(connection);
+      else
+         CloseConnection(connection->fd);
+   }
+}
+
+/**
+ * @brief Receives from a readable connection and answers its next request once it is complete. Parameters set by a
+ * connection only apply to its own solves.
+ */
+bool SolverService::ServeRequest(Connection &connection)
+{
+   string request;
+   if (!TakeLine(connection.pending, request))
+   {
+      // readable, thus recv does not block
+      char buffer[4096];
+      auto received = recv(connection.fd, buffer, sizeof(buffer), 0);
+      if (received <= 0)
+         return false;
+      connection.pending.append(buffer, received);
+
+      // the rest of the request follows later
+      if (!TakeLine(connection.pending, request))
+         return true;
+   }
+
+   SocketBuffer buffer(connection.fd);
+   ostream response(&buffer);
+
+   bool keep_open;
+   try
+   {
+      keep_open = HandleRequest(request, connection.options, response);
+   }
+   catch (const std::exception &error)
+   {
+      response << "error " << error.what() << endl;
+      keep_open = true;
+   }
+
+   response.flush();
+   return keep_open && response && !stopped_;
+}
+
+/**
+ * @brief Gives a connection back after a request. A connection with another complete request stays ready, else it
+ * waits in the poll of Run for its next request.
+ */
+void SolverService::ReleaseConnection(shared_ptr<Connection> connection)
+{
+   bool has_request = connection->pending.find('\n') != string::npos;
+   {
+      std::lock_guard<std::mutex> lock(connections_mutex_);
+      if (has_request)
+         ready_connections_.push(connection);
+      else
+         idle_connections_.push_back(connection);
+   }
+
+   if (has_request)
+      connection_available_.notify_one();
+   else
+      WakeUp();
+}
+
+void SolverService::CloseConnection(int fd)
+{
+   {
+      std::lock_guard<std::mutex> lock(connections_mutex_);
+      open_connections_.erase(fd);
+   }
+   close(fd);
+}
+
+/**
+ * @brief Executes one request and writes its response
+ */
+bool SolverService::HandleRequest(const string &request, RunOptions &options, ostream &response)
+{
+   std::istringstream arguments(request);
+   string command;
+   arguments >> command;
+
+   if (command.empty())
+      return true;
+
+   if (command == "quit")
+   {
+      response << "ok bye" << endl;
+      return false;
+   }
+
+   if (command == "shutdown")
+   {
+      response << "ok shutting down" << endl;
+      Stop();
+      return false;
+   }
+
+   if (command == "load")
+   {
+      string name, path;
+      if (!(arguments >> name >> path))
+         throw std::invalid_argument("expected load <name> <path>");
+
+      auto cached = make_shared<CachedInstance>();
+      cached->instance = make_shared<Instance>();
+      auto load_start = std::chrono::steady_clock::now();
+      cached->instance->read(path);
+
+      {
+         std::lock_guard<std::mutex> lock(instances_mutex_);
+         instances_[name] = cached;
+      }
+
+      response << "ok loaded " << name << " with " << cached->instance->regularCoils.size() << " coils in " << SecondsSince(load_start) << "s" << endl;
+      return true;
+   }
+
+   if (command == "set")
+   {
+      string key, value;
+      if (!(arguments >> key >> value))
+         throw std::invalid_argument("expected set <key> <value>");
+
+      if (key == "time_limit")
+         options.time_limit = stod(value);
+      else if (key == "formulation")
+         options.timing_formulation = ParseTimingFormulation(value);
+      else if (key == "run_mode")
+         options.run_mode = ParseRunMode(value);
+      else
+         throw std::invalid_argument("unknown parameter " + key + ", expected time_limit, formulation or run_mode");
+
+      response << "ok " << key << " " << value << endl;
+      return true;
+   }
+
+   if (command == "solve")
+   {
+      string name;
+      if (!(arguments >> name))
+         throw std::invalid_argument("expected solve <name> [deadline]");
+
+      auto solve_options = options;
+      double deadline;
+      if (arguments >> deadline)
+         solve_options.time_limit = deadline;
+
+      auto cached = FindInstance(name);
+      auto result = Solve(*cached, solve_options);
+
+      if (result.has_solution)
+         response << "ok solved " << name << " cost " << result.solution.cost << " in " << result.seconds << "s" << endl;
+      else
+         response << "ok no solution for " << name << " after " << result.seconds << "s" << endl;
+      return true;
+   }
+
+   if (command == "schedule")
+   {
+      string name, format = "json";
+      if (!(arguments >> name))
+         throw std::invalid_argument("expected schedule <name> [json|csv]");
+      arguments >> format;
+
+      auto cached = FindInstance(name);
+      RunResult result;
+      shared_ptr<Instance> instance;
+      {
+         std::lock_guard<std::mutex> lock(cached->mutex);
+         if (!cached->has_result || !cached->result.has_solution)
+            throw std::invalid_argument("no schedule for " + name + ", solve it first");
+         result = cached->result;
+         instance = cached->instance;
+      }
+
+      response << "ok" << endl;
+      ScheduleExporter(instance).Write(result.solution, response, format == "csv" ? ScheduleExporter::Format::kCsv : ScheduleExporter::Format::kJson);
+      response << "end" << endl;
+      return true;
+   }
+
+   if (command == "delta")
+   {
+      string name, path;
+      if (!(arguments >> name >> path))
+         throw std::invalid_argument("expected delta <name> <path> [deadline]");
+
+      auto solve_options = options;
+      double deadline;
+      if (arguments >> deadline)
+         solve_options.time_limit = deadline;
+
+      InstanceDelta delta;
+      delta.Read(path);
+
+      auto cached = FindInstance(name);
+      auto result = SolveDelta(*cached, delta, solve_options);
+
+      if (result.has_solution)
+         response << "ok re-solved " << name << " cost " << result.solution.cost << " in " << result.seconds << "s" << endl;
+      else
+         response << "ok no solution for " << name << " after " << result.seconds << "s" << endl;
+      return true;
+   }
+
+   throw std::invalid_argument("unknown request " + command);
+}
+
+shared_ptr<SolverService::CachedInstance> SolverService::FindInstance(const string &name)
+{
+   std::lock_guard<std::mutex> lock(instances_mutex_);
+   auto cached = instances_.find(name);
+   if (cached == instances_.end())
+      throw std::invalid_argument("unknown instance " + name + ", load it first");
+
+   return cached->second;
+}
+
+/**
+ * @brief Solves a cached instance. The compact model is kept between solves and starts from its previous solutions.
+ * A solve takes the cached compact model and gives it back afterwards, a concurrent solve of the same instance and
+ * formulation builds a model of its own meanwhile. Every other run mode builds its models for the request, see
+ * SolveInstance. The lock of the instance is only held to take and store the cached state, never while solving.
+ */
+RunResult SolverService::Solve(CachedInstance &cached, const RunOptions &options)
+{
+   shared_ptr<Instance> instance;
+   shared_ptr<CompactModel> compact_model;
+   {
+      std::lock_guard<std::mutex> lock(cached.mutex);
+      instance = cached.instance;
+      if (options.run_mode == Settings::RunMode::kCompact)
+      {
+         auto cached_model = cached.compact_models.find(options.timing_formulation);
+         if (cached_model != cached.compact_models.end())
+         {
+            compact_model = cached_model->second;
+            cached.compact_models.erase(cached_model);
+         }
+      }
+   }
+
+   RunResult result;
+   if (options.run_mode == Settings::RunMode::kCompact)
+   {
+      auto solve_start = std::chrono::steady_clock::now();
+      if (!compact_model)
+         compact_model = make_shared<CompactModel>(instance, options.timing_formulation);
+
+      compact_model->Reset();
+      compact_model->Solve(options.time_limit);
+      result.has_solution = compact_model->GetBestSolution(result.solution);
+      result.seconds = SecondsSince(solve_start);
+   }
+   else
+   {
+      result = SolveInstance(instance, options);
+   }
+
+   // a delta applied meanwhile replaced the instance, the result and the model belong to the previous one
+   std::lock_guard<std::mutex> lock(cached.mutex);
+   if (cached.instance == instance)
+   {
+      if (compact_model)
+         cached.compact_models.emplace(options.timing_formulation, compact_model);
+      cached.result = result;
+      cached.has_result = true;
+   }
+   return result;
+}
+
+/**
+ * @brief Applies a delta to a cached instance and solves the changed instance. The models are built again for the
+ * changed instance, the columns and the incumbent of the last result are repaired and start the solve, see
+ * InstanceDelta::Repair. Deltas of the same instance are applied one after the other under the lock of the instance,
+ * their solves run outside of it.
+ */
+RunResult SolverService::SolveDelta(CachedInstance &cached, const InstanceDelta &delta, const RunOptions &options)
+{
+   auto solve_start = std::chrono::steady_clock::now();
+
+   shared_ptr<Instance> instance;
+   bool has_warm_start;
+   RunResult warm_start;
+   {
+      std::lock_guard<std::mutex> lock(cached.mutex);
+
+      // solves running on the previous instance keep their copy
+      instance = make_shared<Instance>(*cached.instance);
+      instance->ApplyDelta(delta);
+
+      has_warm_start = cached.has_result;
+      if (has_warm_start)
+         warm_start = delta.Repair(cached.result, *instance);
+
+      cached.instance = instance;
+      cached.compact_models.clear();
+      cached.has_result = false;
+   }
+
+   PHALS_LOG(kInfo) << "[Service] Delta applied in " << SecondsSince(solve_start) << "s" << endl;
+
+   auto result = SolveInstance(instance, options, has_warm_start ? &warm_start : nullptr);
+   result.seconds = SecondsSince(solve_start);
+
+   // a later delta replaced the instance meanwhile, it keeps its own result
+   std::lock_guard<std::mutex> lock(cached.mutex);
+   if (cached.instance == instance)
+   {
+      cached.result = result;
+      cached.has_result = true;
+   }
+   return result;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <set>
+
+#include "InstanceRun.h"
+
+class CompactModel;
+struct InstanceDelta;
+
+/**
+ * @brief Long-running solver answering requests on a Unix domain socket, so that repeated queries on the same
+ * instances pay neither process startup nor instance loading
+ *
+ * Requests of all connections are served by a fixed pool of workers. A worker answers one request and releases the
+ * connection, idle connections wait for their next request without occupying a worker. Requests and responses are
+ * single lines:
+ *   load <name> <path>             read an instance and keep it under a name
+ *   set <key> <value>              set time_limit, formulation or run_mode for the following solves of the connection
+ *   solve <name> [deadline]        solve an instance, the deadline in seconds overrides the time limit
+ *   schedule <name> [json|csv]     best schedule of the last solve of an instance, followed by a line "end"
+ *   delta <name> <path> [deadline] change an instance, see InstanceDelta, and solve it from the repaired last result
+ *   quit                           close the connection
+ *   shutdown                       stop the service
+ * Responses start with "ok" or "error". Instances and their compact models are cached between requests, solves of the
+ * compact model start from its previous solutions. A delta replaces the cached instance by a changed copy, thus solves
+ * running on the previous instance are not affected.
+ */
+class SolverService
+{
+public:
+   SolverService(string socket_path, size_t workers);
+   ~SolverService();
+
+   // serves connections until a shutdown request
+   void Run();
+
+private:
+   string socket_path_;
+   size_t workers_;
+   int listen_fd_ = -1;
+   std::atomic<bool> stopped_{false};
+
+   // a connection keeps its parameters and the bytes received after its last request between requests
+   struct Connection
+   {
+      int fd;
+      string pending;
+      RunOptions options;
+   };
+
+   // connections with a request waiting for a worker, idle connections watched by Run and all open connections
+   std::queue<shared_ptr<Connection>> ready_connections_;
+   vector<shared_ptr<Connection>> idle_connections_;
+   std::set<int> open_connections_;
+   std::mutex connections_mutex_;
+   std::condition_variable connection_available_;
+
+   // written to wake up the poll of Run when a connection becomes idle or the service stops
+   int wake_fds_[2] = {-1, -1};
+
+   // an instance loaded by a request with its warm compact models per timing formulation and its last result
+   struct CachedInstance
+   {
+      shared_ptr<Instance> instance;
+      std::mutex mutex;
+      map<Settings::TimingFormulation, shared_ptr<CompactModel>> compact_models;
+      bool has_result = false;
+      RunResult result;
+   };
+   map<string, shared_ptr<CachedInstance>> instances_;
+   std::mutex instances_mutex_;
+
+   void AcceptConnection();
+   void WakeUp();
+
+   void ServeRequests();
+   // false if the connection should be closed
+   bool ServeRequest(Connection &connection);
+   void ReleaseConnection(shared_ptr<Connection> connection);
+   void CloseConnection(int fd);
+   // false if the connection should be closed
+   bool HandleRequest(const string &request, RunOptions &options, ostream &response);
+
+   shared_ptr<CachedInstance> FindInstance(const string &name);
+   RunResult Solve(CachedInstance &cached, const RunOptions &options);
+   RunResult SolveDelta(CachedInstance &cached, const InstanceDelta &delta, const RunOptions &options);
+
+   void Stop();
+};
@@ -0,0 +1,325 @@
+#include "StartTimeLinkingConshdlr.h"
+
+#include <scip/scip.h>
+#include <scip/cons_linear.h>
+
+/**
+ * @brief Construct a new constraint handler. The handler does not need constraints, it enforces every linking on its
+ * own.
+ *
+ * @param scip SCIP environment the handler is included in
+ * @param linkings Data of all linking constraints in terms of original variables
+ */
+StartTimeLinkingConshdlr::StartTimeLinkingConshdlr(SCIP *scip, vector<StartTimeLinking> linkings)
+    : ObjConshdlr(scip,
+                  "start_time_linking",                                // name
+                  "lazy big M start time linking of consecutive coils", // description
+                  10,                                                  // priority for separation
+                  -10,                                                 // priority for enforcement, only integral solutions
+                  -10,                                                 // priority for checking, only integral solutions
+                  1,                                                   // frequency for separating cuts
+                  -1,                                                  // frequency for propagating domains, never
+                  1,                                                   // frequency for using all instead of only the useful constraints
+                  0,                                                   // maximal number of presolving rounds
+                  FALSE,                                               // delay separation
+                  FALSE,                                               // delay propagation
+                  FALSE,                                               // handler needs no constraints to be called
+                  SCIP_PROPTIMING_BEFORELP,                            // propagation timing
+                  SCIP_PRESOLTIMING_FAST),                             // presolving timing
+      linkings_(std::move(linkings))
+{
+}
+
+/**
+ * @brief Collects data of the start time linking constraints of all pairs of different regular coils
+ *
+ * @param instance The instance
+ * @param vars_X X variables of the model, arcs without variable are skipped
+ * @param vars_S S variables of the model
+ * @param lines Production lines whose arcs are linked
+ * @param big_M Big M of the linking of coil i and coil j
+ * @return vector<StartTimeLinking> Data of all linking constraints
+ */
+vector<StartTimeLinking> StartTimeLinkingConshdlr::CreateLinkings(shared_ptr<Instance> instance,
+                                                                  map<tuple<Coil, Coil, ProductionLine, Mode, Mode>, SCIP_VAR *> &vars_X,
+                                                                  map<Coil, SCIP_VAR *> &vars_S,
+                                                                  const vector<ProductionLine> &lines,
+                                                                  const std::function<SCIP_Real(Coil, Coil)> &big_M)
+{
+   vector<StartTimeLinking> linkings;
+
+   for (auto &coil_i : instance->regularCoils)
+   {
+      for (auto &coil_j : instance->regularCoils)
+      {
+         // arcs of a coil to itself are fixed to 0
+         if (coil_i == coil_j)
+            continue;
+
+         StartTimeLinking linking{coil_i, coil_j, vars_S.at(coil_i), vars_S.at(coil_j), {}, {}, big_M(coil_i, coil_j)};
+
+         for (auto &line : lines)
+         {
+            for (auto &mode_i : instance->GetModes(coil_i, line))
+            {
+               for (auto &mode_j : instance->GetModes(coil_j, line))
+               {
+                  auto var_X = vars_X.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+                  // arc was removed by preprocessing
+                  if (var_X == vars_X.end())
+                     continue;
+
+                  linking.vars_X.push_back(var_X->second);
+                  linking.durations.push_back(instance->GetProcessingTime(coil_i, line, mode_i) + instance->GetSetupTime(coil_i, mode_i, coil_j, mode_j, line));
+               }
+            }
+         }
+
+         // coils cannot follow each other on these lines
+         if (linking.vars_X.empty())
+            continue;
+
+         linkings.push_back(std::move(linking));
+      }
+   }
+
+   return linkings;
+}
+
+/**
+ * @brief Map the variables of all linkings to the transformed problem at the beginning of the solving process
+ */
+SCIP_RETCODE StartTimeLinkingConshdlr::scip_initsol(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss)
+{
+   transformed_linkings_ = linkings_;
+   for (auto &linking : transformed_linkings_)
+   {
+      SCIP_CALL(SCIPgetTransformedVar(scip, linking.var_S_i, &linking.var_S_i));
+      SCIP_CALL(SCIPgetTransformedVar(scip, linking.var_S_j, &linking.var_S_j));
+      for (auto &var_X : linking.vars_X)
+      {
+         SCIP_CALL(SCIPgetTransformedVar(scip, var_X, &var_X));
+      }
+   }
+
+   added_.assign(linkings_.size(), false);
+   pending_.clear();
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Forget added linkings, they are freed together with the transformed problem
+ */
+SCIP_RETCODE StartTimeLinkingConshdlr::scip_exitsol(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, SCIP_Bool restart)
+{
+   transformed_linkings_.clear();
+   added_.clear();
+   pending_.clear();
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Checks if a solution selects an arc from coil i to coil j and violates their linking
+ *
+ * @param sol Solution to check, NULL for the current LP or pseudo solution
+ */
+bool StartTimeLinkingConshdlr::IsViolated(SCIP *scip, SCIP_SOL *sol, const StartTimeLinking &linking)
+{
+   SCIP_Real arc_value = 0;
+   SCIP_Real activity = SCIPgetSolVal(scip, sol, linking.var_S_i) - SCIPgetSolVal(scip, sol, linking.var_S_j) - linking.big_M;
+
+   for (size_t arc = 0; arc < linking.vars_X.size(); arc++)
+   {
+      auto value = SCIPgetSolVal(scip, sol, linking.vars_X[arc]);
+      arc_value += value;
+      activity += (linking.durations[arc] + linking.big_M) * value;
+   }
+
+   // without an active arc, the linking is implied by the upper bound of S_i
+   if (!SCIPisFeasPositive(scip, arc_value))
+      return false;
+
+   return SCIPisFeasGT(scip, activity, 0);
+}
+
+/**
+ * @brief Add a linking as linear constraint to the transformed problem
+ */
+SCIP_RETCODE StartTimeLinkingConshdlr::AddLinking(SCIP *scip, size_t index)
+{
+   assert(!added_[index]);
+   auto &linking = transformed_linkings_[index];
+
+   char cons_name[Settings::kSCIPMaxStringLength];
+   SCIPsnprintf(cons_name, Settings::kSCIPMaxStringLength, "start_time_linking_CI%d_CJ%d", linking.coil_i, linking.coil_j);
+
+   SCIP_CONS *cons;
+   SCIP_CALL(SCIPcreateConsBasicLinear(scip,                // scip
+                                       &cons,               // cons
+                                       cons_name,           // name
+                                       0,                   // nvar
+                                       0,                   // vars
+                                       0,                   // coeffs
+                                       -SCIPinfinity(scip), // lhs
+                                       linking.big_M));     // rhs
+
+   SCIP_CALL(SCIPaddCoefLinear(scip, cons, linking.var_S_i, 1));
+   SCIP_CALL(SCIPaddCoefLinear(scip, cons, linking.var_S_j, -1));
+   for (size_t arc = 0; arc < linking.vars_X.size(); arc++)
+   {
+      SCIP_CALL(SCIPaddCoefLinear(scip, cons, linking.vars_X[arc], linking.durations[arc] + linking.big_M));
+   }
+
+   SCIP_CALL(SCIPaddCons(scip, cons));
+   SCIP_CALL(SCIPreleaseCons(scip, &cons));
+
+   added_[index] = true;
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Adds every linking that is violated by a solution or was found violated by the check callback
+ *
+ * @param sol Solution to separate, NULL for the current LP or pseudo solution
+ * @param result SCIP_CONSADDED if any linking was added, SCIP_FEASIBLE else
+ */
+SCIP_RETCODE StartTimeLinkingConshdlr::SeparateSolution(SCIP *scip, SCIP_SOL *sol, SCIP_RESULT *result)
+{
+   *result = SCIP_FEASIBLE;
+
+   for (auto index : pending_)
+   {
+      if (!added_[index])
+      {
+         SCIP_CALL(AddLinking(scip, index));
+         *result = SCIP_CONSADDED;
+      }
+   }
+   pending_.clear();
+
+   for (size_t index = 0; index < transformed_linkings_.size(); index++)
+   {
+      if (added_[index])
+         continue;
+
+      if (IsViolated(scip, sol, transformed_linkings_[index]))
+      {
+         SCIP_CALL(AddLinking(scip, index));
+         *result = SCIP_CONSADDED;
+      }
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Separate the current LP solution
+ */
+SCIP_RETCODE StartTimeLinkingConshdlr::scip_sepalp(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, int nusefulconss, SCIP_RESULT *result)
+{
+   SCIP_CALL(SeparateSolution(scip, NULL, result));
+
+   if (*result != SCIP_CONSADDED)
+      *result = SCIP_DIDNOTFIND;
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Separate a given primal solution
+ */
+SCIP_RETCODE StartTimeLinkingConshdlr::scip_sepasol(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, int nusefulconss, SCIP_SOL *sol, SCIP_RESULT *result)
+{
+   SCIP_CALL(SeparateSolution(scip, sol, result));
+
+   if (*result != SCIP_CONSADDED)
+      *result = SCIP_DIDNOTFIND;
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Enforce the linkings on an integral LP solution
+ */
+SCIP_RETCODE StartTimeLinkingConshdlr::scip_enfolp(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, int nusefulconss, SCIP_Bool solinfeasible, SCIP_RESULT *result)
+{
+   return SeparateSolution(scip, NULL, result);
+}
+
+/**
+ * @brief Enforce the linkings on an integral pseudo solution
+ */
+SCIP_RETCODE StartTimeLinkingConshdlr::scip_enfops(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, int nusefulconss, SCIP_Bool solinfeasible, SCIP_Bool objinfeasible, SCIP_RESULT *result)
+{
+   return SeparateSolution(scip, NULL, result);
+}
+
+/**
+ * @brief Check a solution against every linking that was not added yet. Added linkings are checked by the linear
+ * constraint handler. Violated linkings are remembered and added at the next separation.
+ */
+SCIP_RETCODE StartTimeLinkingConshdlr::scip_check(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, SCIP_SOL *sol, SCIP_Bool checkintegrality, SCIP_Bool checklprows, SCIP_Bool printreason, SCIP_Bool completely, SCIP_RESULT *result)
+{
+   *result = SCIP_FEASIBLE;
+
+   // solutions may be checked before solving, e.g. starting solutions, then use the original variables
+   bool solving = !transformed_linkings_.empty();
+   auto &linkings = solving ? transformed_linkings_ : linkings_;
+
+   for (size_t index = 0; index < linkings.size(); index++)
+   {
+      if (solving && added_[index])
+         continue;
+
+      if (IsViolated(scip, sol, linkings[index]))
+      {
+         *result = SCIP_INFEASIBLE;
+
+         if (printreason)
+         {
+            SCIPinfoMessage(scip, NULL, "violation: start time linking of coil %d and coil %d\n", linkings[index].coil_i, linkings[index].coil_j);
+         }
+
+         if (solving)
+            pending_.insert(index);
+
+         if (!completely)
+            break;
+      }
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Lock the variables of all linkings. Since the handler needs no constraints, SCIP calls this once for the
+ * whole handler with cons == NULL.
+ *
+ * Rounding up X or S_i and rounding down S_j may violate a linking.
+ */
+SCIP_RETCODE StartTimeLinkingConshdlr::scip_lock(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS *cons, SCIP_LOCKTYPE locktype, int nlockspos, int nlocksneg)
+{
+   for (auto &linking : linkings_)
+   {
+      SCIP_VAR *var_S_i;
+      SCIP_VAR *var_S_j;
+      SCIP_CALL(SCIPgetTransformedVar(scip, linking.var_S_i, &var_S_i));
+      SCIP_CALL(SCIPgetTransformedVar(scip, linking.var_S_j, &var_S_j));
+
+      // argument order: down locks, up locks
+      SCIP_CALL(SCIPaddVarLocksType(scip, var_S_i, locktype, nlocksneg, nlockspos));
+      SCIP_CALL(SCIPaddVarLocksType(scip, var_S_j, locktype, nlockspos, nlocksneg));
+
+      for (auto &original_var_X : linking.vars_X)
+      {
+         SCIP_VAR *var_X;
+         SCIP_CALL(SCIPgetTransformedVar(scip, original_var_X, &var_X));
+         SCIP_CALL(SCIPaddVarLocksType(scip, var_X, locktype, nlocksneg, nlockspos));
+      }
+   }
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "objscip/objscip.h"
+
+#include "Instance.h"
+#include "Settings.h"
+
+using namespace scip;
+
+/**
+ * @brief Data of a single start time linking constraint
+ *
+ * S_i - S_j + sum((p_ikm + t_ijkmn + M) * X_ijkmn) <= M
+ */
+struct StartTimeLinking
+{
+   Coil coil_i;
+   Coil coil_j;
+   SCIP_VAR *var_S_i;
+   SCIP_VAR *var_S_j;
+
+   // all arcs from coil_i to coil_j, i.e. every line and mode pair, with processing time of coil_i plus setup time
+   vector<SCIP_VAR *> vars_X;
+   vector<SCIP_Real> durations;
+
+   SCIP_Real big_M;
+};
+
+/**
+ * @brief Constraint handler adding start time linking constraints lazily
+ *
+ * Instead of creating all I^2 big M start time linking constraints up front, a linking constraint of coils i and j is
+ * only added to the problem once a solution selects an arc from i to j and violates it. If no arc from i to j is
+ * selected, the constraint is implied by the upper bound of S_i, see Instance::ComputeBigM. Thus, only the linking of
+ * active arcs has to be checked.
+ *
+ * Added constraints are ordinary linear constraints of the transformed problem, i.e. they are dropped when the
+ * transformed problem is freed and separated again in the next solve.
+ */
+class StartTimeLinkingConshdlr : public ObjConshdlr
+{
+public:
+   StartTimeLinkingConshdlr(SCIP *scip, vector<StartTimeLinking> linkings);
+
+   // collect data of all linking constraints of regular coils on the given lines
+   static vector<StartTimeLinking> CreateLinkings(shared_ptr<Instance> instance,
+                                                  map<tuple<Coil, Coil, ProductionLine, Mode, Mode>, SCIP_VAR *> &vars_X,
+                                                  map<Coil, SCIP_VAR *> &vars_S,
+                                                  const vector<ProductionLine> &lines,
+                                                  const std::function<SCIP_Real(Coil, Coil)> &big_M);
+
+   virtual SCIP_RETCODE scip_initsol(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss) override;
+
+   virtual SCIP_RETCODE scip_exitsol(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, SCIP_Bool restart) override;
+
+   virtual SCIP_RETCODE scip_sepalp(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, int nusefulconss, SCIP_RESULT *result) override;
+
+   virtual SCIP_RETCODE scip_sepasol(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, int nusefulconss, SCIP_SOL *sol, SCIP_RESULT *result) override;
+
+   virtual SCIP_RETCODE scip_enfolp(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, int nusefulconss, SCIP_Bool solinfeasible, SCIP_RESULT *result) override;
+
+   virtual SCIP_RETCODE scip_enfops(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, int nusefulconss, SCIP_Bool solinfeasible, SCIP_Bool objinfeasible, SCIP_RESULT *result) override;
+
+   virtual SCIP_RETCODE scip_check(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS **conss, int nconss, SCIP_SOL *sol, SCIP_Bool checkintegrality, SCIP_Bool checklprows, SCIP_Bool printreason, SCIP_Bool completely, SCIP_RESULT *result) override;
+
+   virtual SCIP_RETCODE scip_lock(SCIP *scip, SCIP_CONSHDLR *conshdlr, SCIP_CONS *cons, SCIP_LOCKTYPE locktype, int nlockspos, int nlocksneg) override;
+
+private:
+   // linking constraints in terms of original variables
+   vector<StartTimeLinking> linkings_;
+
+   // same constraints in terms of transformed variables, valid during solving
+   vector<StartTimeLinking> transformed_linkings_;
+
+   // indices of linkings already added to the transformed problem
+   vector<bool> added_;
+
+   // indices of linkings violated by solutions in the check callback, added at the next separation
+   std::set<size_t> pending_;
+
+   bool IsViolated(SCIP *scip, SCIP_SOL *sol, const StartTimeLinking &linking);
+   SCIP_RETCODE AddLinking(SCIP *scip, size_t index);
+   SCIP_RETCODE SeparateSolution(SCIP *scip, SCIP_SOL *sol, SCIP_RESULT *result);
+};
@@ -1,7 +1,12 @@
+#include <algorithm>
+
 #include "CompactModel.h"
 #include "../Settings.h"
+#include "../StartTimeLinkingConshdlr.h"
 #include <scip/scip_general.h>
 #include <scip/scip_prob.h>
+#include <scip/cons_indicator.h>
+#include <scip/cons_linear.h>
 /**
     Creates and adds a Z variable for the specified coil.
 
@@ -24,7 +29,7 @@ void CompactModel::CreateZVariable(Coil coil_i)
                       0,                     // lower bound
                       1,                     // upper bound
                       0,                     // objective function coefficient, equal to 0 according to model
-                      SCIP_VARTYPE_INTEGER); // variable type
+                      SCIP_VARTYPE_BINARY);  // variable type, binary since it may be used as indicator
 
    SCIPaddVar(scip_, *z_var_pointer);
 }
@@ -37,9 +42,12 @@ void CompactModel::CreateZVariable(Coil coil_i)
 void CompactModel::CreateSVariable(Coil coil_i)
 {
    assert(vars_S_.count(coil_i) == 0);
-   // bounds of variable: if this is start coil, variable should be equal to 0, else 0 <= var <= +infty
+   // bounds of variable: if this is start coil, variable should be equal to 0, else 0 <= var <= latest start on any line
+   // the end coil has no start time restrictions
    SCIP_Real lb = instance_->IsStartCoil(coil_i) ? 0 : 0;
-   SCIP_Real ub = instance_->IsStartCoil(coil_i) ? 0 : SCIPinfinity(scip_);
+   SCIP_Real ub = instance_->IsStartCoil(coil_i)   ? 0
+                  : instance_->IsEndCoil(coil_i) ? SCIPinfinity(scip_)
+                                                 : instance_->GetStartTimeUpperBound(coil_i);
 
    char var_cons_name[Settings::kSCIPMaxStringLength];
 
@@ -81,22 +89,210 @@ void CompactModel::CreateXVariable(Coil coil_i, Coil coil_j, ProductionLine line
                       var_cons_name,                                                              // name
                       lb,                                                                         // lower bound
                       ub,                                                                         // upper bound
-                      instance_->stringerCosts[make_tuple(coil_i, mode_i, coil_j, mode_j, line)], // objective function coefficient, this is equal to c_ijkmn. If c_ijkmn is not presented, c_ijkmn is initialized with 0 and 0 is returned, i.e. coefficient is 0
-                      SCIP_VARTYPE_INTEGER);                                                      // variable type
+                      instance_->GetStringerCost(coil_i, mode_i, coil_j, mode_j, line), // objective function coefficient, this is equal to c_ijkmn. If c_ijkmn is not presented, c_ijkmn is initialized with 0 and 0 is returned, i.e. coefficient is 0
+                      SCIP_VARTYPE_BINARY);                                                       // variable type, binary since it may be used as indicator
 
    SCIPaddVar(scip_, *x_var_pointer);
 }
 
+/**
+ * @brief Create delay linking constraints as indicator constraints: if coil_i is not delayed, it is completed until its
+ * due date on the line it is produced on, i.e.
+ * Z_i = 0 -> S_i + sum(line k, coil_j, mode_i, mode_j, p_ikm * X_ijkmn) <= d_i
+ */
+void CompactModel::CreateIndicatorDelayLinking()
+{
+   char cons_name[Settings::kSCIPMaxStringLength];
+
+   for (auto &coil_i : instance_->regularCoils)
+   {
+      vector<SCIP_VAR *> vars = {vars_S_[coil_i]};
+      vector<SCIP_Real> coefficients = {1};
+
+      for (auto &line : instance_->productionLines)
+      {
+         for (auto &coil_j : instance_->coilsWithoutStartCoil)
+         {
+            for (auto &mode_j : instance_->GetModes(coil_j, line))
+            {
+               for (auto &mode_i : instance_->GetModes(coil_i, line))
+               {
+                  auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+                  if (var_X == vars_X_.end())
+                     continue;
+
+                  vars.push_back(var_X->second);
+                  coefficients.push_back(instance_->GetProcessingTime(coil_i, line, mode_i));
+               }
+            }
+         }
+      }
+
+      // indicator is active if Z_i = 0
+      SCIP_VAR *not_delayed;
+      SCIPgetNegatedVar(scip_, vars_Z_[coil_i], &not_delayed);
+
+      SCIPsnprintf(cons_name, Settings::kSCIPMaxStringLength, "delay_linking_C%d", coil_i);
+
+      SCIP_CONS *cons;
+      SCIPcreateConsBasicIndicator(scip_,                        // scip
+                                   &cons,                        // cons
+                                   cons_name,                    // name
+                                   not_delayed,                  // binary indicator variable
+                                   vars.size(),                  // nvar
+                                   vars.data(),                  // vars
+                                   coefficients.data(),          // coeffs
+                                   instance_->dueDates.at(coil_i)); // rhs
+      SCIPaddCons(scip_, cons);
+      cons_indicator_.push_back(cons);
+   }
+}
+
+/**
+ * @brief Create start time linking constraints as indicator constraints: if an arc is selected, its successor starts
+ * after the processing and setup time, i.e. for every arc of regular coils on every line
+ * X_ijkmn = 1 -> S_i - S_j <= -(p_ikm + t_ijkmn)
+ */
+void CompactModel::CreateIndicatorStartTimeLinking()
+{
+   char cons_name[Settings::kSCIPMaxStringLength];
+
+   for (auto &line : instance_->productionLines)
+   {
+      for (auto &coil_i : instance_->regularCoils)
+      {
+         for (auto &coil_j : instance_->regularCoils)
+         {
+            // arcs of a coil to itself are fixed to 0
+            if (coil_i == coil_j)
+               continue;
+
+            for (auto &mode_i : instance_->GetModes(coil_i, line))
+            {
+               for (auto &mode_j : instance_->GetModes(coil_j, line))
+               {
+                  auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+                  if (var_X == vars_X_.end())
+                     continue;
+
+                  SCIP_VAR *vars[] = {vars_S_[coil_i], vars_S_[coil_j]};
+                  SCIP_Real coefficients[] = {1, -1};
+                  SCIP_Real duration = instance_->GetProcessingTime(coil_i, line, mode_i) + instance_->GetSetupTime(coil_i, mode_i, coil_j, mode_j, line);
+
+                  SCIPsnprintf(cons_name, Settings::kSCIPMaxStringLength, "start_time_linking_CI%d_CJ%d_L%d_MI%d_MJ%d", coil_i, coil_j, line, mode_i, mode_j);
+
+                  SCIP_CONS *cons;
+                  SCIPcreateConsBasicIndicator(scip_,                                                   // scip
+                                               &cons,                                                   // cons
+                                               cons_name,                                               // name
+                                               var_X->second,                                           // binary indicator variable
+                                               2,                                                       // nvar
+                                               vars,                                                    // vars
+                                               coefficients,                                            // coeffs
+                                               -duration);                                              // rhs
+                  SCIPaddCons(scip_, cons);
+                  cons_indicator_.push_back(cons);
+               }
+            }
+         }
+      }
+   }
+}
+
+/**
+ * @brief Create symmetry breaking constraints for identical lines, see Instance::DetectIdenticalLines. Identical lines
+ * l_0, ..., l_m-1 are ordered by the smallest regular coil produced on them, i.e. a coil i can only be produced on l_k if
+ * some coil before i is produced on l_k-1. With A_ikl = number of coils among the regular coils up to i on line l
+ * A_ikl - A_i-1kl = sum(coil_j, mode_i, mode_j, X_ijlmn)
+ * A_ikl - A_i-1kl <= A_i-1k(l-1)
+ */
+void CompactModel::CreateLineSymmetryBreaking()
+{
+   char cons_name[Settings::kSCIPMaxStringLength];
+
+   for (auto &[_, lines] : instance_->identicalLines)
+   {
+      if (lines.size() < 2)
+         continue;
+
+      // prefix count of the assigned coils of every line
+      for (auto &line : lines)
+      {
+         SCIP_VAR *previous_count = nullptr;
+         for (auto &coil_i : instance_->regularCoils)
+         {
+            SCIP_VAR *&count = vars_assigned_coils_[make_tuple(coil_i, line)];
+            SCIPsnprintf(cons_name, Settings::kSCIPMaxStringLength, "A_C%d_L%d", coil_i, line);
+            SCIPcreateVarBasic(scip_, &count, cons_name, 0, instance_->regularCoils.size(), 0, SCIP_VARTYPE_CONTINUOUS);
+            SCIPaddVar(scip_, count);
+
+            SCIP_CONS *cons;
+            SCIPsnprintf(cons_name, Settings::kSCIPMaxStringLength, "assigned_coils_C%d_L%d", coil_i, line);
+            SCIPcreateConsBasicLinear(scip_, &cons, cons_name, 0, 0, 0, 0, 0);
+            SCIPaddCoefLinear(scip_, cons, count, 1);
+            if (previous_count != nullptr)
+               SCIPaddCoefLinear(scip_, cons, previous_count, -1);
+
+            for (auto &coil_j : instance_->coilsWithoutStartCoil)
+            {
+               for (auto &mode_i : instance_->GetModes(coil_i, line))
+               {
+                  for (auto &mode_j : instance_->GetModes(coil_j, line))
+                  {
+                     auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+                     if (var_X == vars_X_.end())
+                        continue;
+
+                     SCIPaddCoefLinear(scip_, cons, var_X->second, -1);
+                  }
+               }
+            }
+
+            SCIPaddCons(scip_, cons);
+            cons_line_symmetry_.push_back(cons);
+            previous_count = count;
+         }
+      }
+
+      // coil i is produced on l_k only if a previous coil is produced on l_k-1
+      for (size_t k = 1; k < lines.size(); k++)
+      {
+         SCIP_VAR *previous_count = nullptr;
+         SCIP_VAR *previous_count_of_previous_line = nullptr;
+         for (auto &coil_i : instance_->regularCoils)
+         {
+            auto count = vars_assigned_coils_[make_tuple(coil_i, lines[k])];
+
+            SCIP_CONS *cons;
+            SCIPsnprintf(cons_name, Settings::kSCIPMaxStringLength, "line_symmetry_C%d_L%d", coil_i, lines[k]);
+            SCIPcreateConsBasicLinear(scip_, &cons, cons_name, 0, 0, 0, -SCIPinfinity(scip_), 0);
+            SCIPaddCoefLinear(scip_, cons, count, 1);
+            if (previous_count != nullptr)
+               SCIPaddCoefLinear(scip_, cons, previous_count, -1);
+            if (previous_count_of_previous_line != nullptr)
+               SCIPaddCoefLinear(scip_, cons, previous_count_of_previous_line, -1);
+
+            SCIPaddCons(scip_, cons);
+            cons_line_symmetry_.push_back(cons);
+
+            previous_count = count;
+            previous_count_of_previous_line = vars_assigned_coils_[make_tuple(coil_i, lines[k - 1])];
+         }
+      }
+   }
+}
+
 /**
  * @brief Construct a new Compact Model:: Compact Model object
  *
  * @param instance pointer to problem-instance
+ * @param timing_formulation formulation of delay linking and start time linking constraints
  *
  * @note This code is a constructor for the CompactModel class. It creates a SCIP environment and sets the specific
  * parameters. It then creates and adds all variables to the model, including binary variables X_ijkmn, Z_i and S_i
  * Finally, it adds all restrictions to the model and writes the final LP-model into a file.
  */
-CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
+CompactModel::CompactModel(shared_ptr<Instance> instance, Settings::TimingFormulation timing_formulation) : instance_(instance), timing_formulation_(timing_formulation)
 {
    // create a SCIP environment and load all defaults
    SCIPcreate(&scip_);
@@ -141,13 +337,17 @@ CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
             {
                continue;
             }
-            auto &modes_i = instance_->modes[make_tuple(coil_i, line)];
-            auto &modes_j = instance_->modes[make_tuple(coil_j, line)];
+            auto &modes_i = instance_->GetModes(coil_i, line);
+            auto &modes_j = instance_->GetModes(coil_j, line);
 
             for (auto &mode_i : modes_i)
             {
                for (auto &mode_j : modes_j)
                {
+                  // no variable for arcs removed by preprocessing
+                  if (instance_->IsArcEliminated(coil_i, mode_i, coil_j, mode_j, line))
+                     continue;
+
                   CreateXVariable(coil_i, coil_j, line, mode_i, mode_j);
                }
             }
@@ -185,13 +385,16 @@ CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
          // skip start coil since it may occur at multiple lines
          for (auto &coil_j : instance_->coilsWithoutStartCoil)
          {
-            for (auto &mode_i : instance_->modes[make_tuple(coil_i, line)])
+            for (auto &mode_i : instance_->GetModes(coil_i, line))
             {
-               for (auto &mode_j : instance_->modes[make_tuple(coil_j, line)])
+               for (auto &mode_j : instance_->GetModes(coil_j, line))
                {
-                  auto tuple = make_tuple(coil_i, coil_j, line, mode_i, mode_j);
-                  auto &var_X = vars_X_[make_tuple(coil_i, coil_j, line, mode_i, mode_j)];
-                  SCIPaddCoefLinear(scip_, cons_coil_partitioning_[coil_i], var_X, 1);
+                  auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+                  // skip variables that don't exist
+                  if (var_X == vars_X_.end())
+                     continue;
+
+                  SCIPaddCoefLinear(scip_, cons_coil_partitioning_[coil_i], var_X->second, 1);
                }
             }
          }
@@ -220,11 +423,15 @@ CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
       // skip sentinel coils, only regular coils
       for (auto &coil_j : instance_->regularCoils)
       {  
-         for (auto &mode_i : instance_->modes[make_tuple(coil_i, line)])
+         for (auto &mode_i : instance_->GetModes(coil_i, line))
          {
-            for (auto &mode_j : instance_->modes[make_tuple(coil_j, line)])
+            for (auto &mode_j : instance_->GetModes(coil_j, line))
             {
-               SCIPaddCoefLinear(scip_, cons_production_line_start_[line], vars_X_[make_tuple(coil_i, coil_j, line, mode_i, mode_j)], 1);
+               auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+               if (var_X == vars_X_.end())
+                  continue;
+
+               SCIPaddCoefLinear(scip_, cons_production_line_start_[line], var_X->second, 1);
             }
          }
       }
@@ -250,13 +457,15 @@ CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
       // skip sentinel coils, only regular coils
       for (auto &coil_i : instance_->regularCoils)
       {
-         for (auto &mode_i : instance_->modes[make_tuple(coil_i, line)])
+         for (auto &mode_i : instance_->GetModes(coil_i, line))
          {
-            for (auto &mode_j : instance_->modes[make_tuple(coil_j, line)])
+            for (auto &mode_j : instance_->GetModes(coil_j, line))
             {
-               auto tuple = make_tuple(coil_i, coil_j, line, mode_i, mode_j);
-               auto &var_X = vars_X_[tuple];
-               SCIPaddCoefLinear(scip_, cons_production_line_end_[line], var_X, 1);
+               auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+               if (var_X == vars_X_.end())
+                  continue;
+
+               SCIPaddCoefLinear(scip_, cons_production_line_end_[line], var_X->second, 1);
             }
          }
       }
@@ -270,9 +479,7 @@ CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
       // skip sentinel coils, only regular coils
       for (auto &coil_j : instance_->regularCoils)
       {
-
-         auto coil_j_line_tuple = make_tuple(coil_j, line);
-         for (auto &mode_j : instance_->modes[coil_j_line_tuple])
+         for (auto &mode_j : instance_->GetModes(coil_j, line))
          {
             auto cons_tuple = make_tuple(line, coil_j, mode_j);
             SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "cons_flow_conservation_L%d_C%d_M%d", line, coil_j, mode_j);
@@ -292,9 +499,13 @@ CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
             // skip end coil and include start coil
             for (auto &coil_i : instance_->coilsWithoutEndCoil)
             {
-               for (auto &mode_i : instance_->modes[make_tuple(coil_i, line)])
+               for (auto &mode_i : instance_->GetModes(coil_i, line))
                {
-                  SCIPaddCoefLinear(scip_, cons_flow_conservation_[cons_tuple], vars_X_[make_tuple(coil_i, coil_j, line, mode_i, mode_j)], 1);
+                  auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+                  if (var_X == vars_X_.end())
+                     continue;
+
+                  SCIPaddCoefLinear(scip_, cons_flow_conservation_[cons_tuple], var_X->second, 1);
                }
             }
 
@@ -305,9 +516,13 @@ CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
                if (instance_->IsStartCoil(coil_i))
                   continue;
 
-               for (auto &mode_i : instance_->modes[make_tuple(coil_i, line)])
+               for (auto &mode_i : instance_->GetModes(coil_i, line))
                {
-                  SCIPaddCoefLinear(scip_, cons_flow_conservation_[cons_tuple], vars_X_[make_tuple(coil_j, coil_i, line, mode_j, mode_i)], -1);
+                  auto var_X = vars_X_.find(make_tuple(coil_j, coil_i, line, mode_j, mode_i));
+                  if (var_X == vars_X_.end())
+                     continue;
+
+                  SCIPaddCoefLinear(scip_, cons_flow_conservation_[cons_tuple], var_X->second, -1);
                }
             }
 
@@ -322,50 +537,61 @@ CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
    // for all regular coils i:
    // -infty <= S_i + sum(line k, non-starting coil_j, mode m of coil i on line k, mode n of coil j on line k) X_ijkmn*p_ikm
    //            - due_i - M*Z_i <= 0
-   for (auto &coil_i : instance_->regularCoils)
+   if (timing_formulation_ == Settings::TimingFormulation::kIndicator)
    {
-      SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "delay_linking_C%d", coil_i);
+      CreateIndicatorDelayLinking();
+   }
+   else
+   {
+      for (auto &coil_i : instance_->regularCoils)
+      {
+         SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "delay_linking_C%d", coil_i);
 
-      SCIPcreateConsBasicLinear(scip_,                        // scip
-                                &cons_delay_linking_[coil_i], // cons
-                                var_cons_name,                // name
-                                0,                            // nvar
-                                0,                            // vars
-                                0,                            // coeffs
-                                -SCIPinfinity(scip_),         // lhs
-                                0);                           // rhs
+         SCIPcreateConsBasicLinear(scip_,                        // scip
+                                   &cons_delay_linking_[coil_i], // cons
+                                   var_cons_name,                // name
+                                   0,                            // nvar
+                                   0,                            // vars
+                                   0,                            // coeffs
+                                   -SCIPinfinity(scip_),         // lhs
+                                   0);                           // rhs
 
-      // add coefficients
-      // add S_i
-      SCIPaddCoefLinear(scip_, cons_delay_linking_[coil_i], vars_S_[coil_i], 1);
+         // add coefficients
+         // add S_i
+         SCIPaddCoefLinear(scip_, cons_delay_linking_[coil_i], vars_S_[coil_i], 1);
 
-      // other
-      for (auto &line : instance_->productionLines)
-      {
-         // if coil_j is start coil, skip
-         for (auto &coil_j : instance_->coilsWithoutStartCoil)
+         // other
+         for (auto &line : instance_->productionLines)
          {
-            for (auto &mode_j : instance_->modes[make_tuple(coil_j, line)])
+            // if coil_j is start coil, skip
+            for (auto &coil_j : instance_->coilsWithoutStartCoil)
             {
-               for (auto &mode_i : instance_->modes[make_tuple(coil_i, line)])
+               for (auto &mode_j : instance_->GetModes(coil_j, line))
                {
-                  auto processing_time = instance_->processingTimes[make_tuple(coil_i, line, mode_i)];
+                  for (auto &mode_i : instance_->GetModes(coil_i, line))
+                  {
+                     auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+                     if (var_X == vars_X_.end())
+                        continue;
 
-                  SCIPaddCoefLinear(scip_, cons_delay_linking_[coil_i], vars_X_[make_tuple(coil_i, coil_j, line, mode_i, mode_j)], processing_time);
+                     auto processing_time = instance_->GetProcessingTime(coil_i, line, mode_i);
+
+                     SCIPaddCoefLinear(scip_, cons_delay_linking_[coil_i], var_X->second, processing_time);
+                  }
                }
             }
          }
-      }
 
-      // RHS
-      // due date d_i
-      SCIPaddCoefLinear(scip_, cons_delay_linking_[coil_i], var_constant_one_, -instance_->dueDates[coil_i]);
+         // RHS
+         // due date d_i
+         SCIPaddCoefLinear(scip_, cons_delay_linking_[coil_i], var_constant_one_, -instance_->dueDates.at(coil_i));
 
-      // big M linearization
-      SCIP_Real big_M = Settings::kBigM; // TODO: !!!!
-      SCIPaddCoefLinear(scip_, cons_delay_linking_[coil_i], vars_Z_[coil_i], -big_M);
+         // big M linearization, latest completion of coil_i on any line minus its due date
+         SCIP_Real big_M = instance_->GetDelayBigM(coil_i);
+         SCIPaddCoefLinear(scip_, cons_delay_linking_[coil_i], vars_Z_[coil_i], -big_M);
 
-      SCIPaddCons(scip_, cons_delay_linking_[coil_i]);
+         SCIPaddCons(scip_, cons_delay_linking_[coil_i]);
+      }
    }
 
    // (7) start time linking: link S_i and X_..
@@ -373,57 +599,81 @@ CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
    // is equivalent to 
    // for all regulra coils i and j: 
    // -infty <= S_i - S_j - M + sum(line k, mode m of coil i on line k, mode n of coil j on line k, (p_ikm + t_ijkmn + M)*X_ijkmn)
-   for (auto &coil_i : instance_->regularCoils)
+   if (timing_formulation_ == Settings::TimingFormulation::kLazy)
    {
-      for (auto &coil_j : instance_->regularCoils)
+      // linking constraints are added by the constraint handler once an arc is selected
+      auto linkings = StartTimeLinkingConshdlr::CreateLinkings(instance_, vars_X_, vars_S_, instance_->productionLines, [this](Coil coil_i, Coil coil_j)
+                                                               { return instance_->GetStartTimeBigM(coil_i, coil_j); });
+      SCIPincludeObjConshdlr(scip_, new StartTimeLinkingConshdlr(scip_, std::move(linkings)), TRUE);
+   }
+   else if (timing_formulation_ == Settings::TimingFormulation::kIndicator)
+   {
+      CreateIndicatorStartTimeLinking();
+   }
+   else
+   {
+      for (auto &coil_i : instance_->regularCoils)
       {
+         for (auto &coil_j : instance_->regularCoils)
+         {
 
-         auto con_tuple = make_tuple(coil_i, coil_j);
+            auto con_tuple = make_tuple(coil_i, coil_j);
 
-         SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "start_time_linking_CI%d_CJ%d", coil_i, coil_j);
+            SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "start_time_linking_CI%d_CJ%d", coil_i, coil_j);
 
-         SCIPcreateConsBasicLinear(scip_,                                // scip
-                                   &cons_start_time_linking_[con_tuple], // cons
-                                   var_cons_name,                        // name
-                                   0,                                    // nvar
-                                   0,                                    // vars
-                                   0,                                    // coeffs
-                                   -SCIPinfinity(scip_),                 // lhs
-                                   0);                                   // rhs
+            SCIPcreateConsBasicLinear(scip_,                                // scip
+                                      &cons_start_time_linking_[con_tuple], // cons
+                                      var_cons_name,                        // name
+                                      0,                                    // nvar
+                                      0,                                    // vars
+                                      0,                                    // coeffs
+                                      -SCIPinfinity(scip_),                 // lhs
+                                      0);                                   // rhs
 
-         // add coefficients
-         // add S_i
-         SCIPaddCoefLinear(scip_, cons_start_time_linking_[con_tuple], vars_S_[coil_i], 1);
+            // add coefficients
+            // add S_i
+            SCIPaddCoefLinear(scip_, cons_start_time_linking_[con_tuple], vars_S_[coil_i], 1);
 
-         // add -S_j
-         SCIPaddCoefLinear(scip_, cons_start_time_linking_[con_tuple], vars_S_[coil_j], -1);
+            // add -S_j
+            SCIPaddCoefLinear(scip_, cons_start_time_linking_[con_tuple], vars_S_[coil_j], -1);
 
-         // add -M
-         SCIP_Real big_M = Settings::kBigM;
-         SCIPaddCoefLinear(scip_, cons_start_time_linking_[con_tuple], var_constant_one_, -big_M);
+            // add -M, latest start of coil_i on any line minus earliest start of coil_j
+            SCIP_Real big_M = instance_->GetStartTimeBigM(coil_i, coil_j);
+            SCIPaddCoefLinear(scip_, cons_start_time_linking_[con_tuple], var_constant_one_, -big_M);
 
-         for (auto &line : instance_->productionLines)
-         {
-            for (auto &mode_i : instance_->modes[make_tuple(coil_i, line)])
+            for (auto &line : instance_->productionLines)
             {
-               for (auto &mode_j : instance_->modes[make_tuple(coil_j, line)])
+               for (auto &mode_i : instance_->GetModes(coil_i, line))
                {
-                  // (p_ikm+tijkmn)*X_ijkmn
-                  auto processing_time = instance_->processingTimes[make_tuple(coil_i, line, mode_i)];
-                  auto setup_time = instance_->setupTimes[make_tuple(coil_i, mode_i, coil_j, mode_j, line)];
-                  SCIP_Real coefficient = processing_time + setup_time;
-
-                  SCIPaddCoefLinear(scip_, cons_start_time_linking_[con_tuple], vars_X_[make_tuple(coil_i, coil_j, line, mode_i, mode_j)], coefficient);
-
-                  // M*X_ijkmn
-                  SCIPaddCoefLinear(scip_, cons_start_time_linking_[con_tuple], vars_X_[make_tuple(coil_i, coil_j, line, mode_i, mode_j)], big_M);
+                  for (auto &mode_j : instance_->GetModes(coil_j, line))
+                  {
+                     auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+                     if (var_X == vars_X_.end())
+                        continue;
+
+                     // (p_ikm+tijkmn)*X_ijkmn
+                     auto processing_time = instance_->GetProcessingTime(coil_i, line, mode_i);
+                     auto setup_time = instance_->GetSetupTime(coil_i, mode_i, coil_j, mode_j, line);
+                     SCIP_Real coefficient = processing_time + setup_time;
+
+                     SCIPaddCoefLinear(scip_, cons_start_time_linking_[con_tuple], var_X->second, coefficient);
+
+                     // M*X_ijkmn
+                     SCIPaddCoefLinear(scip_, cons_start_time_linking_[con_tuple], var_X->second, big_M);
+                  }
                }
             }
+            SCIPaddCons(scip_, cons_start_time_linking_[con_tuple]);
          }
-         SCIPaddCons(scip_, cons_start_time_linking_[con_tuple]);
       }
    }
 
+   // order identical lines by their first coil
+   if (Settings::kBreakLineSymmetry)
+   {
+      CreateLineSymmetryBreaking();
+   }
+
    // (8) max number of delayed columns
    // no equivalence transformation needed, see README
    SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "max_delayed_coils");
@@ -443,9 +693,6 @@ CompactModel::CompactModel(shared_ptr<Instance> instance) : instance_(instance)
    }
 
    SCIPaddCons(scip_, cons_max_delayed_coils_);
-
-   // Generate a file to show the LP-Program, that is build. "FALSE" = we get our specific choosen names.
-   SCIPwriteOrigProblem(scip_, "compact_model_PHALS.lp", "lp", FALSE);
 }
 
 /**
@@ -483,6 +730,16 @@ CompactModel::~CompactModel()
       SCIPreleaseCons(scip_, &cons);
    }
 
+   for (auto &cons : this->cons_indicator_)
+   {
+      SCIPreleaseCons(scip_, &cons);
+   }
+
+   for (auto &cons : this->cons_line_symmetry_)
+   {
+      SCIPreleaseCons(scip_, &cons);
+   }
+
    SCIPreleaseCons(scip_, &cons_max_delayed_coils_);
 
    for (auto &[_, var] : this->vars_X_)
@@ -500,6 +757,11 @@ CompactModel::~CompactModel()
       SCIPreleaseVar(scip_, &var);
    }
 
+   for (auto &[_, var] : this->vars_assigned_coils_)
+   {
+      SCIPreleaseVar(scip_, &var);
+   }
+
    SCIPreleaseVar(scip_, &var_constant_one_);
 
    SCIPfree(&scip_);
@@ -517,6 +779,41 @@ void CompactModel::SetSCIPParameters()
    SCIPsetBoolParam(scip_, "display/lpinfo", FALSE); // default FALSE
 };
 
+/**
+ * @brief Frees the search of the last Solve, so the model can be solved again, e.g. with another time limit. Found
+ * solutions are kept and start the next solve.
+ */
+void CompactModel::Reset()
+{
+   SCIPfreeTransform(scip_);
+}
+
+/**
+ * @brief Limits the memory SCIP may use for this model, the solve stops once it is reached
+ */
+void CompactModel::SetMemoryLimit(double megabytes)
+{
+   SCIPsetRealParam(scip_, "limits/memory", megabytes);
+}
+
+/**
+ * @brief Memory currently used by SCIP for this model, the memory that limits/memory refers to
+ */
+double CompactModel::GetMemoryUsed()
+{
+   return SCIPgetMemTotal(scip_) / 1048576.0;
+}
+
+/**
+ * @brief Writes the model to the working directory for debugging. Only for single runs, runs in the same process would
+ * overwrite the file of each other.
+ */
+void CompactModel::WriteModelFile()
+{
+   // Generate a file to show the LP-Program, that is build. "FALSE" = we get our specific choosen names.
+   SCIPwriteOrigProblem(scip_, "compact_model_PHALS.lp", "lp", FALSE);
+}
+
 /**
  * @brief solve the compact model
  *
@@ -530,49 +827,17 @@ void CompactModel::Solve(double time_limit = 1e+20)
    SCIPsetRealParam(scip_, "limits/time", time_limit);    // default 1e+20 s
 
    SCIPsolve(scip_);
-};
-
 
-
-/**
- * @brief Given an optimal SCIP solution, finds the successor coil of coil i on
- * line k
- *
- * @param solution SCIP solution on which the successor coil should be searched
- * for
- * @param coil_i 
- * @param line 
- * @return tuple<bool, Coil, Mode, Mode> First entry of tuple specifies if
- * sucessor coil was found. If yes, the second entry specifies successor coil j
- * of coil i. The third entry then specifies the mode of coil i. The fourth
- * entry specifies the mode of successor coil j.
- */
-tuple<bool, Coil, Mode, Mode> CompactModel::FindSucessorCoil(SCIP_Sol *solution, Coil coil_i, ProductionLine line)
-{
-   for (auto &mode_i : instance_->modes[make_tuple(coil_i, line)])
+   if (incumbent_exchange_heur_ != nullptr)
    {
-      for (auto &coil_j : instance_->coils)
-      {
-         for (auto &mode_j : instance_->modes[make_tuple(coil_j, line)])
-         {
-            auto var_tuple = make_tuple(coil_i, coil_j, line, mode_i, mode_j);
-            // skip variables that don't exist
-            if (vars_X_.count(var_tuple) == 0)
-               continue;
+      incumbent_exchange_heur_->Finish(scip_);
+   }
 
-            auto &var = vars_X_[var_tuple];
-            auto var_value = SCIPgetSolVal(scip_, solution, var);
+   // print measured time, used to compare formulations
+   cout << "=== TOTAL TIME IN COMPACT MODEL === " << std::fixed << SCIPgetSolvingTime(scip_) << endl;
+};
 
-            if (var_value > 0.5)
-            { // TODO: use SCIP epsilon methods
-               return make_tuple(true, coil_j, mode_i, mode_j);
-            }
-         }
-      }
-   }
 
-   return make_tuple(false, 0, 0, 0);
-}
 
 /**
  * @brief Display every Value of the variables in the optimal solution and reconstruct a schedule for every line
@@ -587,43 +852,202 @@ void CompactModel::DisplaySolution()
    SCIPprintBestSol(scip_, NULL, FALSE);
 
    SCIP_SOL *solution = SCIPgetBestSol(scip_);
+   if (solution == nullptr)
+      return;
 
    cout << endl
         << endl;
    cout << "==== Coil Assignment ====" << endl;
-   for (auto &line : instance_->productionLines)
+   for (auto &[line, sequence] : ExtractSolution(solution).sequences)
    {
       cout << "Line " << line << endl;
-      Coil coil_i = instance_->startCoil;
-      auto [found, coil_j, mode_i, mode_j] = FindSucessorCoil(solution, coil_i, line);
+      cout << "Start -> ";
+      for (auto &[coil, mode] : sequence)
+      {
+         cout << "C" << coil << "M" << mode;
+         cout << " t=" << SCIPgetSolVal(scip_, solution, vars_S_[coil]);
+         if (SCIPgetSolVal(scip_, solution, vars_Z_[coil]) > 0.5)
+            cout << " delayed";
+         cout << " -> ";
+      }
+      cout << "End" << endl;
 
-      assert(found);
+      cout << "==== Coil Assignment ====" << endl;
+   }
+};
 
-      while (coil_i != instance_->endCoil)
+/**
+ * @brief Shares incumbents of this model with other solvers by including an IncumbentExchangeHeur. The solve is
+ * interrupted once another solver finishes the search.
+ */
+void CompactModel::IncludeIncumbentExchange(shared_ptr<IncumbentExchange> exchange)
+{
+   incumbent_exchange_heur_ = new IncumbentExchangeHeur(
+       scip_,
+       exchange,
+       IncumbentExchange::Solver::kCompact,
+       [this](SCIP_SOL *solution)
+       { return ExtractSolution(solution); },
+       [this](const SequenceSolution &solution, SCIP_HEUR *heur)
+       { return ImportSolution(solution, heur); });
+
+   SCIPincludeObjHeur(scip_, incumbent_exchange_heur_, TRUE);
+
+   exchange->RegisterInterrupt(IncumbentExchange::Solver::kCompact, [this]
+                               { SCIPinterruptSolve(scip_); });
+}
+
+/**
+ * @brief Reconstructs the coil sequence of every line of a solution from its selected arcs
+ */
+SequenceSolution CompactModel::ExtractSolution(SCIP_SOL *solution)
+{
+   vector<SequenceSolution::Arc> arcs;
+   for (auto &[arc, var] : vars_X_)
+   {
+      if (SCIPgetSolVal(scip_, solution, var) > 0.5)
+         arcs.push_back(arc);
+   }
+
+   map<ProductionLine, vector<ProductionLine>> lines;
+   for (auto &line : instance_->productionLines)
+   {
+      lines[line] = {line};
+   }
+
+   return SequenceSolution::FromArcs(*instance_, arcs, lines);
+}
+
+/**
+ * @brief Sequences, cost and timing of the incumbent after Solve, e.g. to start branch and price from it
+ *
+ * @return true If the model has a solution
+ */
+bool CompactModel::GetBestSolution(SequenceSolution &solution)
+{
+   auto best_solution = SCIPgetBestSol(scip_);
+   if (best_solution == nullptr)
+      return false;
+
+   solution = ExtractSolution(best_solution);
+   solution.cost = SCIPgetSolOrigObj(scip_, best_solution);
+   solution.ComputeTiming(*instance_);
+   return true;
+}
+
+/**
+ * @brief Tries a solution of another solver in this model, or adds a known solution before solving. X, S and Z follow
+ * from the sequences and their timing, the auxiliary variables of symmetry breaking and the slack variables of
+ * indicator constraints from those.
+ *
+ * @return SCIP_RESULT SCIP_FOUNDSOL if the solution was stored, SCIP_DIDNOTFIND else
+ */
+SCIP_RESULT CompactModel::ImportSolution(const SequenceSolution &solution, SCIP_HEUR *heur)
+{
+   auto sequences = solution.sequences;
+
+   // identical lines are ordered by the smallest regular coil produced on them in this model, regular coils are sorted,
+   // see CreateLineSymmetryBreaking. Empty lines come last.
+   if (Settings::kBreakLineSymmetry)
+   {
+      auto smallest_coil = [](const vector<tuple<Coil, Mode>> &sequence)
       {
-         if (coil_i == instance_->startCoil)
+         return get<0>(*std::min_element(sequence.begin(), sequence.end()));
+      };
+
+      for (auto &[_, lines] : instance_->identicalLines)
+      {
+         vector<vector<tuple<Coil, Mode>>> group;
+         for (auto &line : lines)
          {
-            cout << "Start";
+            group.push_back(sequences[line]);
          }
-         else
+
+         std::stable_sort(group.begin(), group.end(), [&smallest_coil](const vector<tuple<Coil, Mode>> &lhs, const vector<tuple<Coil, Mode>> &rhs)
+                          { return !lhs.empty() && (rhs.empty() || smallest_coil(lhs) < smallest_coil(rhs)); });
+
+         for (size_t k = 0; k < lines.size(); k++)
          {
-            cout << "C" << coil_i << "M" << mode_i;
-            cout << " t=" << SCIPgetSolVal(scip_, solution, vars_S_[coil_i]);
-            if (SCIPgetSolVal(scip_, solution, vars_Z_[coil_i]) > 0.5)
-               cout << " delayed";
+            sequences[lines[k]] = group[k];
          }
-         cout << " -> ";
+      }
+   }
+
+   // solution of the original problem, there are no variables that exist only in the transformed problem
+   SCIP_SOL *sol;
+   SCIPcreateOrigSol(scip_, &sol, heur);
+   SCIPsetSolVal(scip_, sol, var_constant_one_, 1);
+
+   map<Coil, ProductionLine> line_of_coil;
+   for (auto &[line, sequence] : sequences)
+   {
+      Coil coil_i = instance_->startCoil;
+      Mode mode_i = 0;
+      for (size_t position = 0; position <= sequence.size(); position++)
+      {
+         auto [coil_j, mode_j] = position < sequence.size() ? sequence[position] : make_tuple(instance_->endCoil, 0);
+
+         auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
+         if (var_X == vars_X_.end())
+         {
+            // the arc was removed by preprocessing, the solution cannot be optimal for this model
+            SCIPfreeSol(scip_, &sol);
+            return SCIP_DIDNOTFIND;
+         }
+         SCIPsetSolVal(scip_, sol, var_X->second, 1);
+
+         if (position < sequence.size())
+         {
+            line_of_coil[coil_j] = line;
+            SCIPsetSolVal(scip_, sol, vars_S_[coil_j], solution.start_times.at(coil_j));
+            SCIPsetSolVal(scip_, sol, vars_Z_[coil_j], solution.delayed.at(coil_j) ? 1 : 0);
+         }
+
          coil_i = coil_j;
+         mode_i = mode_j;
+      }
+   }
+
+   // number of coils up to coil i on every line
+   map<ProductionLine, int> assigned_coils;
+   for (auto &coil_i : instance_->regularCoils)
+   {
+      auto line = line_of_coil.find(coil_i);
+      if (line != line_of_coil.end())
+         assigned_coils[line->second]++;
 
-         auto [found_new, coil_j_new, mode_i_new, mode_j_new] = FindSucessorCoil(solution, coil_i, line);
-         found = found_new;
-         coil_j = coil_j_new;
-         mode_i = mode_i_new;
-         mode_j = mode_j_new;
+      for (auto &line : instance_->productionLines)
+      {
+         auto var_count = vars_assigned_coils_.find(make_tuple(coil_i, line));
+         if (var_count != vars_assigned_coils_.end())
+            SCIPsetSolVal(scip_, sol, var_count->second, assigned_coils[line]);
       }
+   }
 
-      cout << "End" << endl;
+   // slack variables absorb the violation of indicator constraints that are not active
+   for (auto &cons : cons_indicator_)
+   {
+      auto linear_cons = SCIPgetLinearConsIndicator(cons);
+      auto violation = SCIPgetActivityLinear(scip_, linear_cons, sol) - SCIPgetRhsLinear(scip_, linear_cons);
+      SCIPsetSolVal(scip_, sol, SCIPgetSlackVarIndicator(cons), std::max(0.0, violation));
+   }
 
-      cout << "==== Coil Assignment ====" << endl;
+   // before solving, SCIP checks the solution only once the problem is transformed and drops it silently if it is
+   // infeasible, thus it is checked here
+   SCIP_Bool stored;
+   if (SCIPgetStage(scip_) == SCIP_STAGE_PROBLEM)
+   {
+      SCIP_Bool feasible;
+      SCIPcheckSolOrig(scip_, sol, &feasible, FALSE, TRUE);
+      if (!feasible)
+      {
+         SCIPfreeSol(scip_, &sol);
+         return SCIP_DIDNOTFIND;
+      }
+      SCIPaddSolFree(scip_, &sol, &stored);
    }
-};
+   else
+      SCIPtrySolFree(scip_, &sol, FALSE, FALSE, TRUE, TRUE, TRUE, &stored);
+
+   return stored ? SCIP_FOUNDSOL : SCIP_DIDNOTFIND;
+}
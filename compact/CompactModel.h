@@ -3,6 +3,7 @@
 
 #include "../Instance.h"
 #include "../Settings.h"
+#include "../IncumbentExchangeHeur.h"
 
 /* scip includes */
 #include "objscip/objscip.h"
@@ -16,7 +17,7 @@ class CompactModel
 
 public:
    // constructor
-   CompactModel(shared_ptr<Instance> instance);
+   CompactModel(shared_ptr<Instance> instance, Settings::TimingFormulation timing_formulation = Settings::kDefaultTimingFormulation);
 
    // destructor
    ~CompactModel();
@@ -24,12 +25,34 @@ public:
    // solve the problem
    void Solve(double time_limit);
 
+   // memory limit of SCIP in megabytes
+   void SetMemoryLimit(double megabytes);
+
+   // memory currently used by SCIP in megabytes
+   double GetMemoryUsed();
+
+   // write the model to the working directory for debugging
+   void WriteModelFile();
+
+   // prepare another Solve of the model
+   void Reset();
+
    // display the solution
    void DisplaySolution();
 
    // set all optional SCIP-Parameters
    void SetSCIPParameters();
 
+   // share incumbents with other solvers during Solve, see IncumbentExchangeHeur
+   void IncludeIncumbentExchange(shared_ptr<IncumbentExchange> exchange);
+
+   // translation between solutions of this model and sequences
+   SequenceSolution ExtractSolution(SCIP_SOL *solution);
+   SCIP_RESULT ImportSolution(const SequenceSolution &solution, SCIP_HEUR *heur);
+
+   // incumbent after Solve, false if there is none
+   bool GetBestSolution(SequenceSolution &solution);
+
 private:
    shared_ptr<Instance> instance_;
    SCIP *scip_;
@@ -57,8 +80,22 @@ private:
 
    SCIP_CONS *cons_max_delayed_coils_;
 
+   // timing constraints of the indicator formulation
+   Settings::TimingFormulation timing_formulation_;
+   vector<SCIP_CONS *> cons_indicator_;
+   void CreateIndicatorDelayLinking();
+   void CreateIndicatorStartTimeLinking();
+
+   // symmetry breaking of identical lines, see Settings::kBreakLineSymmetry
+   // number of coils among the first regular coils up to coil i that are produced on a line
+   map<tuple<Coil, ProductionLine>, SCIP_VAR *> vars_assigned_coils_;
+   vector<SCIP_CONS *> cons_line_symmetry_;
+   void CreateLineSymmetryBreaking();
+
    void CreateZVariable(Coil coil_i);
    void CreateSVariable(Coil coil_i);
    void CreateXVariable(Coil coil_i, Coil coil_j, ProductionLine line, Mode mode_i, Mode mode_j);
-   tuple<bool, Coil, Mode, Mode> FindSucessorCoil(SCIP_Sol *solution, Coil coil_i, ProductionLine line);
+
+   // owned by SCIP, nullptr if no incumbents are shared
+   IncumbentExchangeHeur *incumbent_exchange_heur_ = nullptr;
 };
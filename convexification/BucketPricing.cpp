@@ -0,0 +1,428 @@
+#include "BucketPricing.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "../Logger.h"
+
+/**
+ * @brief Looks up a value in a map without inserting, since dual values are read by all pricing threads concurrently
+ */
+template <typename Map, typename Key>
+static double GetOrZero(const Map &map, const Key &key)
+{
+  auto entry = map.find(key);
+  return entry != map.end() ? entry->second : 0;
+}
+
+/**
+ * @brief Builds the nodes of the network and chooses the bucket width
+ *
+ * @param instance The instance
+ * @param line Production line of this pricing problem
+ */
+void BucketPricing::Setup(shared_ptr<Instance> instance, ProductionLine line)
+{
+  instance_ = instance;
+  line_ = line;
+
+  for (size_t coil_index = 0; coil_index < instance_->regularCoils.size(); coil_index++)
+  {
+    auto coil = instance_->regularCoils[coil_index];
+    for (auto &mode : instance_->GetModes(coil, line_))
+    {
+      nodes_.push_back({coil, mode, coil_index, instance_->GetProcessingTime(coil, line_, mode), instance_->dueDates.at(coil)});
+    }
+  }
+
+  auto number_of_nodes = nodes_.size();
+  // memory of an arc, its successor entry and its reduced cost
+  const size_t arc_bytes = sizeof(Arc) + sizeof(double);
+  const size_t max_arcs = Settings::kBucketPricingMaxMemory * 1048576 / arc_bytes;
+  successor_begin_.assign(1, 0);
+  start_allowed_.assign(number_of_nodes, false);
+  end_allowed_.assign(number_of_nodes, false);
+  for (size_t from = 0; from < number_of_nodes; from++)
+  {
+    auto &node_i = nodes_[from];
+    start_allowed_[from] = !instance_->IsArcEliminated(instance_->startCoil, 0, node_i.coil, node_i.mode, line_);
+    end_allowed_[from] = !instance_->IsArcEliminated(node_i.coil, node_i.mode, instance_->endCoil, 0, line_);
+
+    for (size_t to = 0; to < number_of_nodes; to++)
+    {
+      auto &node_j = nodes_[to];
+      if (node_i.coil == node_j.coil || instance_->IsArcEliminated(node_i.coil, node_i.mode, node_j.coil, node_j.mode, line_))
+        continue;
+
+      successors_.push_back({to, node_i.processing_time + instance_->GetSetupTime(node_i.coil, node_i.mode, node_j.coil, node_j.mode, line_)});
+    }
+    successor_begin_.push_back(successors_.size());
+
+    if (successors_.size() > max_arcs)
+    {
+      PHALS_LOG(kWarning) << "[Subproblem L" << line_ << "]: Arcs of bucket pricing exceed " << Settings::kBucketPricingMaxMemory
+                          << " MB, the line is priced by the MIP only" << endl;
+      successor_begin_ = vector<size_t>();
+      successors_ = vector<Arc>();
+      return;
+    }
+  }
+  successor_costs_.resize(successors_.size());
+  available_ = true;
+
+  // no coil is completed after the horizon of the line, see Instance::ComputeBigM
+  double horizon = std::max(1.0, instance_->bigM.count(line_) > 0 ? instance_->bigM.at(line_) : 1.0);
+
+  // smallest integral bucket width that keeps the number of nodes below the limit
+  double max_buckets = std::max(1.0, std::floor((double)Settings::kBucketPricingMaxNodes / std::max<size_t>(1, number_of_nodes)));
+  bucket_width_ = std::max(1.0, std::ceil(horizon / max_buckets));
+  number_of_buckets_ = (size_t)std::ceil(horizon / bucket_width_) + 1;
+}
+
+/**
+ * @brief Bucket of a start time, times after the horizon share the last bucket
+ */
+size_t BucketPricing::Bucket(double time) const
+{
+  return std::min(number_of_buckets_ - 1, (size_t)(time / bucket_width_));
+}
+
+/**
+ * @brief Checks if a label dominates another label of the same node, i.e. every extension of rhs is also feasible
+ * for lhs and not cheaper
+ */
+bool BucketPricing::Dominates(const Label &lhs, const Label &rhs)
+{
+  return lhs.reduced_cost <= rhs.reduced_cost &&
+         lhs.start_time <= rhs.start_time &&
+         lhs.delayed_coils <= rhs.delayed_coils &&
+         lhs.visited.is_subset_of(rhs.visited);
+}
+
+/**
+ * @brief Searches schedules with negative reduced cost by labeling on the time-bucketed network. The reduced cost of a
+ * schedule is computed exactly as the objective of SubProblem, see SubProblem::UpdateObjective.
+ *
+ * @param dual_values Dual values or Farkas multipliers of the master problem
+ * @param is_farkas If true, stringer costs are not part of the reduced cost
+ * @return vector<shared_ptr<ProductionLineSchedule>> Schedules with negative reduced cost, best first
+ */
+vector<shared_ptr<ProductionLineSchedule>> BucketPricing::Solve(shared_ptr<DualValues> dual_values, const bool is_farkas)
+{
+  vector<shared_ptr<ProductionLineSchedule>> schedules;
+
+  auto number_of_nodes = nodes_.size();
+  auto number_of_coils = instance_->regularCoils.size();
+  if (!available_ || number_of_nodes == 0)
+    return schedules;
+
+  // ############################################################################################################
+  //  reduced cost of every arc and every delayed coil
+  // ############################################################################################################
+
+  auto start_coil = instance_->startCoil;
+  auto end_coil = instance_->endCoil;
+
+  auto arc_cost = [&](Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j)
+  {
+    auto tuple = make_tuple(coil_i, coil_j, line_, mode_i, mode_j);
+    double cost = GetOrZero(dual_values->pi_original_var_X, tuple);
+    if (instance_->IsRegularCoil(coil_i))
+    {
+      cost -= GetOrZero(dual_values->pi_partitioning_, coil_i);
+      if (!instance_->IsEndCoil(coil_j) && !is_farkas)
+        cost += instance_->GetStringerCost(coil_i, mode_i, coil_j, mode_j, line_);
+    }
+    return cost;
+  };
+
+  vector<double> start_cost(number_of_nodes);
+  vector<double> end_cost(number_of_nodes);
+  for (size_t from = 0; from < number_of_nodes; from++)
+  {
+    auto &node_i = nodes_[from];
+    start_cost[from] = arc_cost(start_coil, 0, node_i.coil, node_i.mode);
+    end_cost[from] = arc_cost(node_i.coil, node_i.mode, end_coil, 0);
+    for (auto arc = successor_begin_[from]; arc < successor_begin_[from + 1]; arc++)
+    {
+      auto &node_j = nodes_[successors_[arc].to];
+      successor_costs_[arc] = arc_cost(node_i.coil, node_i.mode, node_j.coil, node_j.mode);
+    }
+  }
+
+  // reduced cost of Z_i = 1
+  vector<double> delay_cost(number_of_coils);
+  for (size_t coil_index = 0; coil_index < number_of_coils; coil_index++)
+  {
+    auto coil = instance_->regularCoils[coil_index];
+    delay_cost[coil_index] = -dual_values->pi_max_delayed_coils_ + GetOrZero(dual_values->pi_original_var_Z, coil);
+  }
+
+  // coils whose Z may be set to 1 voluntarily since it decreases the reduced cost, most negative first
+  vector<size_t> voluntarily_delayed;
+  for (size_t coil_index = 0; coil_index < number_of_coils; coil_index++)
+  {
+    if (delay_cost[coil_index] < 0)
+      voluntarily_delayed.push_back(coil_index);
+  }
+  std::sort(voluntarily_delayed.begin(), voluntarily_delayed.end(), [&delay_cost](size_t lhs, size_t rhs)
+            { return delay_cost[lhs] < delay_cost[rhs]; });
+
+  double constant_cost = -GetOrZero(dual_values->pi_convexity_, line_);
+
+  // Z of sentinel coils is not bound to a delay, it is set to 1 in every column if its coefficient is negative
+  vector<Coil> delayed_sentinels;
+  for (auto coil : {start_coil, end_coil})
+  {
+    if (GetOrZero(dual_values->pi_original_var_Z, coil) < 0)
+    {
+      constant_cost += GetOrZero(dual_values->pi_original_var_Z, coil);
+      delayed_sentinels.push_back(coil);
+    }
+  }
+
+  // ############################################################################################################
+  //  labeling
+  // ############################################################################################################
+
+  vector<Label> labels;
+  // labels of every (node, bucket)
+  vector<vector<size_t>> node_labels(number_of_nodes * number_of_buckets_);
+  // labels to be extended per bucket, start times never decrease along a path
+  vector<vector<size_t>> bucket_queue(number_of_buckets_);
+
+  // tries to add a label, returns false if it was dominated or the node is full
+  auto insert_label = [&](Label &&label)
+  {
+    if (label.delayed_coils > instance_->maximumDelayedCoils)
+      return false;
+
+    auto bucket = Bucket(label.start_time);
+    auto &existing = node_labels[label.node * number_of_buckets_ + bucket];
+
+    for (auto index : existing)
+    {
+      if (Dominates(labels[index], label))
+        return false;
+    }
+
+    existing.erase(std::remove_if(existing.begin(), existing.end(), [&](size_t index)
+                                  {
+                                    if (!Dominates(label, labels[index]))
+                                      return false;
+                                    labels[index].dominated = true;
+                                    return true; }),
+                   existing.end());
+
+    // node full: replace most expensive label if new label is cheaper
+    if (existing.size() >= Settings::kBucketPricingLabelsPerNode)
+    {
+      auto worst = std::max_element(existing.begin(), existing.end(), [&](size_t lhs, size_t rhs)
+                                    { return labels[lhs].reduced_cost < labels[rhs].reduced_cost; });
+      if (labels[*worst].reduced_cost <= label.reduced_cost)
+        return false;
+
+      labels[*worst].dominated = true;
+      existing.erase(worst);
+    }
+
+    existing.push_back(labels.size());
+    bucket_queue[bucket].push_back(labels.size());
+    labels.push_back(std::move(label));
+    return true;
+  };
+
+  // creates the label of a path entering node at start_time
+  auto arrive = [&](size_t node, double start_time, double reduced_cost, const Label *predecessor, long predecessor_index)
+  {
+    auto &node_j = nodes_[node];
+
+    Label label;
+    label.node = node;
+    label.start_time = start_time;
+    label.reduced_cost = reduced_cost;
+    label.predecessor = predecessor_index;
+    label.visited = predecessor ? predecessor->visited : boost::dynamic_bitset<>(number_of_coils);
+    label.delayed = predecessor ? predecessor->delayed : boost::dynamic_bitset<>(number_of_coils);
+    label.delayed_coils = predecessor ? predecessor->delayed_coils : 0;
+    label.visited.set(node_j.coil_index);
+
+    // delay is determined by the arc entering the coil
+    if (start_time + node_j.processing_time > node_j.due_date)
+    {
+      label.delayed.set(node_j.coil_index);
+      label.delayed_coils++;
+      label.reduced_cost += delay_cost[node_j.coil_index];
+    }
+
+    return label;
+  };
+
+  for (size_t node = 0; node < number_of_nodes; node++)
+  {
+    if (start_allowed_[node])
+      insert_label(arrive(node, 0, start_cost[node], nullptr, -1));
+  }
+
+  // best closed paths: (reduced cost, label index)
+  vector<pair<double, size_t>> closed_paths;
+
+  // reduced cost of closing a label, including voluntarily delayed coils
+  auto closing_cost = [&](const Label &label)
+  {
+    double reduced_cost = label.reduced_cost + end_cost[label.node] + constant_cost;
+    int free_slots = instance_->maximumDelayedCoils - label.delayed_coils;
+    for (auto coil_index : voluntarily_delayed)
+    {
+      if (free_slots <= 0)
+        break;
+      if (label.delayed.test(coil_index))
+        continue;
+
+      reduced_cost += delay_cost[coil_index];
+      free_slots--;
+    }
+    return reduced_cost;
+  };
+
+  for (size_t bucket = 0; bucket < number_of_buckets_; bucket++)
+  {
+    // queue may grow while processing if transitions take no time
+    for (size_t position = 0; position < bucket_queue[bucket].size(); position++)
+    {
+      auto label_index = bucket_queue[bucket][position];
+      if (labels[label_index].dominated)
+        continue;
+
+      // close path at end coil
+      auto reduced_cost = closing_cost(labels[label_index]);
+      if (end_allowed_[labels[label_index].node] && reduced_cost < -Settings::kBucketPricingReducedCostTolerance)
+      {
+        closed_paths.emplace_back(reduced_cost, label_index);
+      }
+
+      // extend to every unvisited successor
+      auto node = labels[label_index].node;
+      for (auto arc = successor_begin_[node]; arc < successor_begin_[node + 1]; arc++)
+      {
+        // labels may be reallocated by insert_label
+        const Label &label = labels[label_index];
+        auto &successor = successors_[arc];
+        if (label.visited.test(nodes_[successor.to].coil_index))
+          continue;
+
+        auto label_extended = arrive(successor.to, label.start_time + successor.transition_time, label.reduced_cost + successor_costs_[arc], &label, label_index);
+        insert_label(std::move(label_extended));
+      }
+    }
+  }
+
+  // ############################################################################################################
+  //  restore best schedules
+  // ############################################################################################################
+
+  std::sort(closed_paths.begin(), closed_paths.end());
+
+  for (auto &[reduced_cost, label_index] : closed_paths)
+  {
+    if (schedules.size() >= Settings::kBucketPricingMaxColumns)
+      break;
+
+    auto schedule = make_shared<ProductionLineSchedule>();
+    schedule->line = line_;
+    schedule->reduced_cost = reduced_cost;
+    schedule->reduced_cost_negative = true;
+
+    auto &last = labels[label_index];
+    auto add_edge = [&](Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j)
+    {
+      schedule->edges[make_tuple(coil_i, coil_j, line_, mode_i, mode_j)] = true;
+      schedule->schedule_cost += instance_->GetStringerCost(coil_i, mode_i, coil_j, mode_j, line_);
+    };
+
+    // walk back from the last coil to the start coil
+    add_edge(nodes_[last.node].coil, nodes_[last.node].mode, end_coil, 0);
+    long current = label_index;
+    while (current >= 0)
+    {
+      auto &label = labels[current];
+      auto &node_j = nodes_[label.node];
+      if (label.predecessor >= 0)
+      {
+        auto &node_i = nodes_[labels[label.predecessor].node];
+        add_edge(node_i.coil, node_i.mode, node_j.coil, node_j.mode);
+      }
+      else
+      {
+        add_edge(start_coil, 0, node_j.coil, node_j.mode);
+      }
+      current = label.predecessor;
+    }
+
+    // delayed coils of the path and voluntarily delayed coils, see closing_cost
+    int free_slots = instance_->maximumDelayedCoils - last.delayed_coils;
+    for (size_t coil_index = 0; coil_index < number_of_coils; coil_index++)
+    {
+      if (last.delayed.test(coil_index))
+        schedule->delayedness[instance_->regularCoils[coil_index]] = true;
+    }
+    for (auto coil_index : voluntarily_delayed)
+    {
+      if (free_slots <= 0)
+        break;
+      if (last.delayed.test(coil_index))
+        continue;
+
+      schedule->delayedness[instance_->regularCoils[coil_index]] = true;
+      free_slots--;
+    }
+    for (auto coil : delayed_sentinels)
+    {
+      schedule->delayedness[coil] = true;
+    }
+
+    // the labels have to price the column like the master problem does
+    assert(std::abs(ComputeReducedCost(*schedule, *dual_values, is_farkas) - reduced_cost) <=
+           Settings::kBucketPricingReducedCostTolerance * std::max(1.0, std::abs(reduced_cost)));
+
+    // several labels may describe the same path with different modes of delay, keep each path once
+    bool duplicate = std::any_of(schedules.begin(), schedules.end(), [&schedule](const shared_ptr<ProductionLineSchedule> &other)
+                                 { return other->edges == schedule->edges; });
+    if (!duplicate)
+      schedules.push_back(schedule);
+  }
+
+  return schedules;
+}
+
+/**
+ * @brief Reduced cost of a column from its coefficients in the master problem, see MyPricer::ComputeColumnCoefficients:
+ * its stringer cost, 0 for Farkas pricing, minus the duals of the constraints it appears in
+ */
+double BucketPricing::ComputeReducedCost(const ProductionLineSchedule &schedule, const DualValues &dual_values, const bool is_farkas) const
+{
+  double reduced_cost = is_farkas ? 0 : schedule.schedule_cost;
+  for (auto &[tuple, incidence] : schedule.edges)
+  {
+    if (!incidence)
+      continue;
+
+    auto coil_i = get<0>(tuple);
+    if (instance_->IsRegularCoil(coil_i))
+      reduced_cost -= GetOrZero(dual_values.pi_partitioning_, coil_i);
+    reduced_cost += GetOrZero(dual_values.pi_original_var_X, tuple);
+  }
+
+  for (auto &[coil, delayed] : schedule.delayedness)
+  {
+    if (!delayed)
+      continue;
+
+    if (instance_->IsRegularCoil(coil))
+      reduced_cost -= dual_values.pi_max_delayed_coils_;
+    reduced_cost += GetOrZero(dual_values.pi_original_var_Z, coil);
+  }
+
+  return reduced_cost - GetOrZero(dual_values.pi_convexity_, schedule.line);
+}
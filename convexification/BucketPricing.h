@@ -0,0 +1,85 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "../Settings.h"
+#include "../Instance.h"
+#include "ProductionLineSchedule.h"
+#include "DualValues.h"
+
+/**
+ * @brief Heuristic pricing of a single production line on a time-bucketed network
+ *
+ * Nodes of the network are (coil, mode, time bucket), arcs are transitions from a coil to its successor. The start
+ * time of a coil follows from the path, so whether a coil is delayed is a property of the arc entering it. Pricing is
+ * a resource constrained shortest path problem, solved by labeling: every label carries its reduced cost, start time,
+ * number of delayed coils and the set of visited coils. Only a bounded number of non-dominated labels is kept per
+ * node, thus the result is heuristic and the MIP of SubProblem remains the exact fallback.
+ *
+ * The bucket width is chosen such that the number of nodes stays below Settings::kBucketPricingMaxNodes. Since times
+ * are small integers, buckets of width 1 give a time-indexed network whenever memory allows. Only arcs not eliminated
+ * by preprocessing are stored, lines whose arcs exceed Settings::kBucketPricingMaxMemory are left to the MIP.
+ */
+class BucketPricing
+{
+public:
+  void Setup(shared_ptr<Instance> instance, ProductionLine line);
+
+  // find up to Settings::kBucketPricingMaxColumns schedules with negative reduced cost
+  vector<shared_ptr<ProductionLineSchedule>> Solve(shared_ptr<DualValues> dual_values, const bool is_farkas);
+
+  double bucket_width_ = 1;
+  size_t number_of_buckets_ = 1;
+  // false if the arcs of the line exceed the memory limit, Solve finds no schedule then
+  bool available_ = false;
+
+private:
+  shared_ptr<Instance> instance_;
+  ProductionLine line_;
+
+  // (coil, mode) pairs of regular coils that can be produced on this line
+  struct Node
+  {
+    Coil coil;
+    Mode mode;
+    size_t coil_index;
+    ProcessingTime processing_time;
+    DueDate due_date;
+  };
+  vector<Node> nodes_;
+
+  struct Arc
+  {
+    size_t to;
+    // time between start of the node and start of node to if it directly follows
+    double transition_time;
+  };
+  // arcs of node i not removed by preprocessing are successors_[successor_begin_[i]] to successors_[successor_begin_[i + 1] - 1]
+  vector<size_t> successor_begin_;
+  vector<Arc> successors_;
+  // reduced cost of every arc of successors_, reused by every call of Solve
+  vector<double> successor_costs_;
+  vector<bool> start_allowed_;
+  vector<bool> end_allowed_;
+
+  struct Label
+  {
+    double reduced_cost;
+    double start_time;
+    int delayed_coils;
+    boost::dynamic_bitset<> visited;
+    boost::dynamic_bitset<> delayed;
+    size_t node;
+    // index of label this label was extended from, -1 if its predecessor is the start coil
+    long predecessor;
+    bool dominated = false;
+  };
+
+  size_t Bucket(double time) const;
+  static bool Dominates(const Label &lhs, const Label &rhs);
+
+  // reduced cost of a column as the master problem computes it, checks the labels of returned columns
+  double ComputeReducedCost(const ProductionLineSchedule &schedule, const DualValues &dual_values, const bool is_farkas) const;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "../Instance.h"
+#include "ProductionLineSchedule.h"
+
+/**
+ * @brief Lock-free multi-producer/single-consumer queue
+ *
+ * Any number of threads may push concurrently without blocking each other. A single consumer takes all queued
+ * elements at once. Since the consumer never removes single nodes, the queue is not affected by the ABA problem.
+ *
+ * @tparam T Type of queued elements
+ */
+template <typename T>
+class MPSCQueue
+{
+public:
+   MPSCQueue() = default;
+   MPSCQueue(const MPSCQueue &) = delete;
+   MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+   ~MPSCQueue()
+   {
+      // free remaining nodes
+      TakeAll();
+   }
+
+   /**
+    * @brief Push an element, may be called by any thread
+    *
+    * @param value The element to be pushed
+    */
+   void Push(T value)
+   {
+      auto node = new Node{std::move(value), head_.load(std::memory_order_relaxed)};
+
+      // on failure, node->next is updated to the current head and pushing is retried
+      while (!head_.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+      {
+      }
+   }
+
+   /**
+    * @brief Take every element pushed so far, may only be called by the consumer thread
+    *
+    * @return std::vector<T> Elements in the order they were pushed
+    */
+   std::vector<T> TakeAll()
+   {
+      Node *node = head_.exchange(nullptr, std::memory_order_acquire);
+
+      std::vector<T> values;
+      while (node != nullptr)
+      {
+         values.push_back(std::move(node->value));
+         Node *next = node->next;
+         delete node;
+         node = next;
+      }
+
+      // nodes form a stack, restore push order
+      std::reverse(values.begin(), values.end());
+      return values;
+   }
+
+   bool Empty() const
+   {
+      return head_.load(std::memory_order_acquire) == nullptr;
+   }
+
+private:
+   struct Node
+   {
+      T value;
+      Node *next;
+   };
+
+   std::atomic<Node *> head_{nullptr};
+};
+
+// candidate columns found by pricing threads, drained by the pricer in the SCIP thread
+using ColumnQueue = MPSCQueue<shared_ptr<ProductionLineSchedule>>;
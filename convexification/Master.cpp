@@ -1,6 +1,8 @@
 #include "Master.h"
 #include "../Settings.h"
 #include <scip/scip_cons.h>
+#include <algorithm>
+#include <cmath>
 #include <numeric>
 /**
  * @brief Create a original binary Z_i variable and create/add it to the original variable constraint
@@ -245,8 +247,16 @@ Master::Master(shared_ptr<Instance> instance) : instance_(instance), initial_col
 
    SCIPaddVar(scipRMP_, var_constant_one_);
 
+   // identical lines share one subproblem, their schedules are columns of the representative line
+   for (auto &line : Settings::kAggregateIdenticalLines ? instance_->GetRepresentativeLines() : instance_->productionLines)
+   {
+      lines_.push_back(line);
+      line_multiplicity_[line] = Settings::kAggregateIdenticalLines ? instance_->identicalLines.at(line).size() : 1;
+   }
+
    // create X_ijkmn variables
-   for (auto &line : instance_->productionLines)
+   // for aggregated lines X_ijkmn is the sum over all identical lines, still binary since every coil is produced once
+   for (auto &line : lines_)
    {
       for (auto &coil_i : instance_->coilsWithoutEndCoil)
       {
@@ -260,13 +270,17 @@ Master::Master(shared_ptr<Instance> instance) : instance_(instance), initial_col
             // if (coil_i != coil_j)
             // {
             // TODO: check this!
-            auto &modes_i = instance_->modes[make_tuple(coil_i, line)];
-            auto &modes_j = instance_->modes[make_tuple(coil_j, line)];
+            auto &modes_i = instance_->GetModes(coil_i, line);
+            auto &modes_j = instance_->GetModes(coil_j, line);
 
             for (auto &mode_i : modes_i)
             {
                for (auto &mode_j : modes_j)
                {
+                  // no variable for arcs removed by preprocessing
+                  if (instance_->IsArcEliminated(coil_i, mode_i, coil_j, mode_j, line))
+                     continue;
+
                   CreateXVariable(coil_i, coil_j, line, mode_i, mode_j);
                }
             }
@@ -350,10 +364,13 @@ Master::Master(shared_ptr<Instance> instance) : instance_(instance), initial_col
    // (A) convexity constraints
    // for every production line, sum of lambda variables = 1
    // i.e. 1<= sum(production line k, lambdas, 1*lambda) <= 1
+   // for aggregated lines the sum equals the number of identical lines
    // currently 0 = 1 since no lambda variable are available yet
 
-   for (auto &line : instance_->productionLines)
+   for (auto &line : lines_)
    {
+      auto multiplicity = line_multiplicity_[line];
+
       SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "convexity_L%d", line);
 
       SCIPcreateConsLinear(scipRMP_,               // scip
@@ -362,8 +379,8 @@ Master::Master(shared_ptr<Instance> instance) : instance_(instance), initial_col
                            0,                      // nvar
                            0,                      // vars
                            0,                      // coeffs
-                           1,                      // lhs
-                           1,                      // rhs
+                           multiplicity,           // lhs
+                           multiplicity,           // rhs
                            TRUE,                   // initial
                            FALSE,                  // separate
                            TRUE,                   // enforce
@@ -380,9 +397,6 @@ Master::Master(shared_ptr<Instance> instance) : instance_(instance), initial_col
       SCIPaddCons(scipRMP_, cons_convexity_[line]);
    }
 
-   // generate a file to show the LP-Program that is build. "FALSE" = we get our specific choosen names.
-   SCIPwriteOrigProblem(scipRMP_, "original_RMP_PHALS.lp", "lp", FALSE);
-
    // create timer for measuring
    SCIPcreateClock(scipRMP_, &master_round_clock);
 }
@@ -455,6 +469,38 @@ Master::~Master()
    SCIPfree(&scipRMP_);
 }
 
+/**
+ * @brief Limits the memory SCIP may use for the master problem, the solve stops once it is reached
+ */
+void Master::SetMemoryLimit(double megabytes)
+{
+   SCIPsetRealParam(scipRMP_, "limits/memory", megabytes);
+}
+
+/**
+ * @brief Memory currently used by SCIP for the master problem, the memory that limits/memory refers to
+ */
+double Master::GetMemoryUsed()
+{
+   return SCIPgetMemTotal(scipRMP_) / 1048576.0;
+}
+
+/**
+ * @brief Writes the original master problem and the branch and bound tree for vbc-tool to the working directory, the
+ * pricer writes the transformed master problem of every pricing round. Only for single runs, runs in the same process
+ * would overwrite the files of each other.
+ */
+void Master::EnableModelFiles()
+{
+   write_model_files_ = true;
+
+   // generate a file to show the LP-Program that is build. "FALSE" = we get our specific choosen names.
+   SCIPwriteOrigProblem(scipRMP_, "original_RMP_PHALS.lp", "lp", FALSE);
+
+   // write a file for vbc-tool, so that later the branch&bound tree can be visualized
+   SCIPsetStringParam(scipRMP_, "visual/vbcfilename", "tree.vbc");
+}
+
 // solve the problem
 /**
  * @brief Solve the Master problem using Branch&Price algorithm
@@ -476,6 +522,11 @@ void Master::Solve(double time_limit)
    // trigger B&P algorithm
    SCIPsolve(scipRMP_);
 
+   if (incumbent_exchange_heur_ != nullptr)
+   {
+      incumbent_exchange_heur_->Finish(scipRMP_);
+   }
+
    // measure time after solution
    auto last_measure = MeasureTime("Master Last Measure");
 
@@ -511,9 +562,6 @@ void Master::SetSCIPParameters()
    SCIPsetIntParam(scipRMP_, "display/verblevel", 4);   // default 4
    SCIPsetBoolParam(scipRMP_, "display/lpinfo", FALSE); // default FALSE
 
-   // write a file for vbc-tool, so that later the branch&bound tree can be visualized
-   SCIPsetStringParam(scipRMP_, "visual/vbcfilename", "tree.vbc");
-
    // modify some parameters so that the pricing can work properly
 
    // http://scip.zib.de : "known bug : If one uses column generation and restarts, a solution that contains
@@ -533,54 +581,11 @@ void Master::SetSCIPParameters()
    SCIPsetSeparating(scipRMP_, SCIP_PARAMSETTING_OFF, TRUE);
 }
 
-/**
- * @brief Given an optimal SCIP solution, finds the successor coil of coil i on
- * line k
- *
- * @param solution SCIP solution on which the successor coil should be searched
- * for
- * @param coil_i 
- * @param line 
- * @return tuple<bool, Coil, Mode, Mode> First entry of tuple specifies if
- * sucessor coil was found. If yes, the second entry specifies successor coil j
- * of coil i. The third entry then specifies the mode of coil i. The fourth
- * entry specifies the mode of successor coil j.
- */
-tuple<bool, Coil, Mode, Mode> Master::FindSucessorCoil(SCIP_Sol *solution, Coil coil_i, ProductionLine line)
-{
-   // check every possible X_ijkmn for given i and k (line)
-   for (auto &mode_i : instance_->modes[make_tuple(coil_i, line)])
-   {
-      for (auto &coil_j : instance_->coils)
-      {
-         for (auto &mode_j : instance_->modes[make_tuple(coil_j, line)])
-         {
-            auto var_tuple = make_tuple(coil_i, coil_j, line, mode_i, mode_j);
-            // skip variables that don't exist
-            if (vars_X_.count(var_tuple) == 0)
-               continue;
-
-            auto &var = vars_X_[var_tuple];
-
-            // get variable value
-            auto var_value = SCIPgetSolVal(scipRMP_, solution, var);
-            // if variable value is sufficiently large, here at least 1/2, variable value of binry variable is interpreted as true
-            if (var_value > 0.5)
-            { // TODO: use SCIP epsilon methods
-               return make_tuple(true, coil_j, mode_i, mode_j);
-            }
-         }
-      }
-   }
-
-   return make_tuple(false, 0, 0, 0);
-}
-
 /**
  * @brief Displays the yet best found solution and statistics of solving
- * process. If reconstruction of production schedules is enabled, the method
- * FindSucessorCoil(..) is iteratively used to reconstruct production schedule
- * for every production line
+ * process. If reconstruction of production schedules is enabled, the
+ * production schedule of every production line is reconstructed from the
+ * selected arcs, see ExtractSolution
  *
  */
 void Master::DisplaySolution()
@@ -592,7 +597,7 @@ void Master::DisplaySolution()
 
    SCIP_SOL *solution = SCIPgetBestSol(scipRMP_);
 
-   if (Settings::kReconstructScheduleFromSolution)
+   if (Settings::kReconstructScheduleFromSolution && solution != nullptr)
    {
 
       cout << endl
@@ -601,39 +606,32 @@ void Master::DisplaySolution()
       cout << "==== Coil Assignment ====" << endl;
 
       double total_cost = 0;
-      for (auto &line : instance_->productionLines)
+      // an aggregated line is split into the schedules of its identical lines
+      for (auto &[line, sequence] : ExtractSolution(solution).sequences)
       {
-         // calculate total cost and find successor coils, starting from coil_i=0, mode=0
+         auto model_line = Settings::kAggregateIdenticalLines ? instance_->lineRepresentative.at(line) : line;
+
+         // calculate total cost along the sequence, starting from the start coil in mode 0
          double line_cost = 0;
          cout << "Line " << line << endl;
-         Coil coil_i = instance_->startCoil;
-         auto [found, coil_j, mode_i, mode_j] = FindSucessorCoil(solution, coil_i, line);
-
-         assert(found);
+         cout << "Start -> ";
 
-         while (coil_i != instance_->endCoil)
+         Coil coil_i = instance_->startCoil;
+         Mode mode_i = 0;
+         for (auto &[coil_j, mode_j] : sequence)
          {
-            line_cost += instance_->stringerCosts[make_tuple(coil_i, mode_i, coil_j, mode_j, line)];
-            if (coil_i == instance_->startCoil)
-            {
-               cout << "Start";
-            }
-            else
-            {
-               cout << "C" << coil_i << "M" << mode_i;
-               // cout << " t=" << SCIPgetSolVal(scipRMP_, solution, vars_S_[coil_i]);
-               if (SCIPgetSolVal(scipRMP_, solution, vars_Z_[coil_i]) > 0.5)
-                  cout << " delayed";
-            }
+            line_cost += instance_->GetStringerCost(coil_i, mode_i, coil_j, mode_j, model_line);
+
+            cout << "C" << coil_j << "M" << mode_j;
+            // cout << " t=" << SCIPgetSolVal(scipRMP_, solution, vars_S_[coil_j]);
+            if (SCIPgetSolVal(scipRMP_, solution, vars_Z_[coil_j]) > 0.5)
+               cout << " delayed";
             cout << " -> ";
-            coil_i = coil_j;
 
-            auto [found_new, coil_j_new, mode_i_new, mode_j_new] = FindSucessorCoil(solution, coil_i, line);
-            found = found_new;
-            coil_j = coil_j_new;
-            mode_i = mode_i_new;
-            mode_j = mode_j_new;
+            coil_i = coil_j;
+            mode_i = mode_j;
          }
+         line_cost += instance_->GetStringerCost(coil_i, mode_i, instance_->endCoil, 0, model_line);
 
          // update total cost
          total_cost += line_cost;
@@ -646,6 +644,252 @@ void Master::DisplaySolution()
    }
 };
 
+/**
+ * @brief Shares incumbents of branch and price with other solvers by including an IncumbentExchangeHeur. The solve is
+ * interrupted once another solver finishes the search.
+ */
+void Master::IncludeIncumbentExchange(shared_ptr<IncumbentExchange> exchange)
+{
+   incumbent_exchange_heur_ = new IncumbentExchangeHeur(
+       scipRMP_,
+       exchange,
+       IncumbentExchange::Solver::kBranchAndPrice,
+       [this](SCIP_SOL *solution)
+       { return ExtractSolution(solution); },
+       [this](const SequenceSolution &solution, SCIP_HEUR *heur)
+       { return ImportSolution(solution, heur); });
+
+   SCIPincludeObjHeur(scipRMP_, incumbent_exchange_heur_, TRUE);
+
+   exchange->RegisterInterrupt(IncumbentExchange::Solver::kBranchAndPrice, [this]
+                               { SCIPinterruptSolve(scipRMP_); });
+}
+
+/**
+ * @brief Includes the large neighborhood search. Its schedules only use arcs with an X variable, so the master problem
+ * can express them once the pricer added their columns.
+ */
+void Master::IncludeLargeNeighborhoodSearch()
+{
+   auto heuristic = new LargeNeighborhoodSearchHeur(
+       scipRMP_,
+       instance_,
+       [this](SCIP_SOL *solution)
+       { return ExtractSolution(solution); },
+       [this](const SequenceSolution &solution, SCIP_HEUR *heur)
+       { return ImportSolution(solution, heur); },
+       [this](Coil coil_i, Mode mode_i, Coil coil_j, Mode mode_j, ProductionLine line)
+       {
+          auto model_line = Settings::kAggregateIdenticalLines ? instance_->lineRepresentative.at(line) : line;
+          return vars_X_.count(make_tuple(coil_i, coil_j, model_line, mode_i, mode_j)) > 0;
+       });
+
+   SCIPincludeObjHeur(scipRMP_, heuristic, TRUE);
+}
+
+/**
+ * @brief Reconstructs the coil sequence of every line from the original variables of a solution. An aggregated line
+ * is split into one sequence per identical line by the distinct first coils, see DisplaySolution.
+ */
+SequenceSolution Master::ExtractSolution(SCIP_SOL *solution)
+{
+   vector<SequenceSolution::Arc> arcs;
+   for (auto &[arc, var] : vars_X_)
+   {
+      // an aggregated line uses an arc once per identical line
+      auto count = std::lround(SCIPgetSolVal(scipRMP_, solution, var));
+      for (long k = 0; k < count; k++)
+      {
+         arcs.push_back(arc);
+      }
+   }
+
+   map<ProductionLine, vector<ProductionLine>> lines;
+   for (auto &line : lines_)
+   {
+      lines[line] = Settings::kAggregateIdenticalLines ? instance_->identicalLines.at(line) : vector<ProductionLine>{line};
+   }
+
+   return SequenceSolution::FromArcs(*instance_, arcs, lines);
+}
+
+/**
+ * @brief Sequences, cost and timing of the incumbent after Solve
+ *
+ * @return true If the master problem has a solution
+ */
+bool Master::GetBestSolution(SequenceSolution &solution)
+{
+   auto best_solution = SCIPgetBestSol(scipRMP_);
+   if (best_solution == nullptr)
+      return false;
+
+   solution = ExtractSolution(best_solution);
+   solution.cost = SCIPgetSolOrigObj(scipRMP_, best_solution);
+   solution.ComputeTiming(*instance_);
+   return true;
+}
+
+/**
+ * @brief Sequences of all columns of the master problem
+ */
+vector<tuple<ProductionLine, vector<tuple<Coil, Mode>>>> Master::GetColumnSequences()
+{
+   vector<tuple<ProductionLine, vector<tuple<Coil, Mode>>>> columns;
+   for (auto &[line, schedules] : schedules_)
+   {
+      for (auto &schedule : schedules)
+      {
+         vector<SequenceSolution::Arc> arcs;
+         for (auto &[edge, _] : schedule->edges)
+         {
+            arcs.push_back(edge);
+         }
+
+         auto route = SequenceSolution::FromArcs(*instance_, arcs, {{line, {line}}});
+         columns.emplace_back(line, route.sequences.at(line));
+      }
+   }
+
+   return columns;
+}
+
+/**
+ * @brief Tries a solution of another solver in the master problem. Every sequence is a column of its line, the
+ * solution selects each of them once. Columns that are not in the master problem yet are handed to the pricer.
+ *
+ * @return SCIP_RESULT SCIP_FOUNDSOL if the solution was stored, SCIP_DELAYED if columns are missing, SCIP_DIDNOTFIND
+ * else
+ */
+SCIP_RESULT Master::ImportSolution(const SequenceSolution &solution, SCIP_HEUR *heur)
+{
+   auto columns = CreateColumns(solution);
+   if (columns.empty())
+      return SCIP_DIDNOTFIND;
+
+   bool columns_missing = false;
+   for (auto &column : columns)
+   {
+      if (FindColumn(*column) < 0)
+      {
+         pending_columns_.push_back(column);
+         columns_missing = true;
+      }
+   }
+
+   if (columns_missing)
+      return SCIP_DELAYED;
+
+   SCIP_SOL *sol;
+   SCIPcreateSol(scipRMP_, &sol, heur);
+   SetColumnSolution(sol, columns);
+
+   SCIP_Bool stored;
+   SCIPtrySolFree(scipRMP_, &sol, FALSE, FALSE, TRUE, TRUE, TRUE, &stored);
+
+   return stored ? SCIP_FOUNDSOL : SCIP_DIDNOTFIND;
+}
+
+/**
+ * @brief Translates every sequence of a solution into a column of its line in the master problem. The timing of the
+ * solution has to be computed.
+ *
+ * @return vector<shared_ptr<ProductionLineSchedule>> One column per line, empty if a sequence uses an arc that was
+ * removed by preprocessing
+ */
+vector<shared_ptr<ProductionLineSchedule>> Master::CreateColumns(const SequenceSolution &solution)
+{
+   vector<shared_ptr<ProductionLineSchedule>> columns;
+   for (auto &[line, sequence] : solution.sequences)
+   {
+      auto column = make_shared<ProductionLineSchedule>();
+      column->line = Settings::kAggregateIdenticalLines ? instance_->lineRepresentative.at(line) : line;
+
+      Coil coil_i = instance_->startCoil;
+      Mode mode_i = 0;
+      for (size_t position = 0; position <= sequence.size(); position++)
+      {
+         auto [coil_j, mode_j] = position < sequence.size() ? sequence[position] : make_tuple(instance_->endCoil, 0);
+
+         auto edge = make_tuple(coil_i, coil_j, column->line, mode_i, mode_j);
+         // the arc was removed by preprocessing, the solution cannot be optimal for this model
+         if (vars_X_.count(edge) == 0)
+            return {};
+
+         column->edges[edge] = true;
+         column->schedule_cost += instance_->GetStringerCost(coil_i, mode_i, coil_j, mode_j, column->line);
+         if (position < sequence.size() && solution.delayed.at(coil_j))
+            column->delayedness[coil_j] = true;
+
+         coil_i = coil_j;
+         mode_i = mode_j;
+      }
+
+      columns.push_back(column);
+   }
+
+   return columns;
+}
+
+/**
+ * @brief Sets the values of a solution that selects every given column once. The original variables are linked to
+ * the lambda variables, their values follow from the columns. Every column has to be in the master problem.
+ *
+ * @param sol A solution of the original problem before solving, a solution of the transformed problem else
+ */
+void Master::SetColumnSolution(SCIP_SOL *sol, const vector<shared_ptr<ProductionLineSchedule>> &columns)
+{
+   // the variables are replaced by their transformed variables once solving starts, see MyPricer::scip_init
+   bool transformed = SCIPgetStage(scipRMP_) != SCIP_STAGE_PROBLEM;
+
+   map<SCIP_VAR *, SCIP_Real> values;
+   auto add_value = [&](SCIP_VAR *var, SCIP_Real value)
+   {
+      if (transformed)
+         SCIPgetTransformedVar(scipRMP_, var, &var);
+      values[var] += value;
+   };
+
+   add_value(var_constant_one_, 1);
+   for (auto &column : columns)
+   {
+      // identical lines may select the same column several times
+      add_value(vars_lambda_[column->line][FindColumn(*column)], 1);
+
+      for (auto &[edge, _] : column->edges)
+      {
+         add_value(vars_X_.at(edge), 1);
+      }
+
+      for (auto &[coil, _] : column->delayedness)
+      {
+         add_value(vars_Z_.at(coil), 1);
+      }
+   }
+
+   for (auto &[var, value] : values)
+   {
+      SCIPsetSolVal(scipRMP_, sol, var, value);
+   }
+}
+
+/**
+ * @brief Finds a column with the same edges and delayed coils as a schedule
+ *
+ * @return long Index of the lambda variable of the column on the line of the schedule, -1 if there is none
+ */
+long Master::FindColumn(const ProductionLineSchedule &schedule)
+{
+   auto schedules = schedules_.find(schedule.line);
+   if (schedules == schedules_.end())
+      return -1;
+
+   auto existing = std::find_if(schedules->second.begin(), schedules->second.end(), [&schedule](const shared_ptr<ProductionLineSchedule> &column)
+                                { return column->edges == schedule.edges && column->delayedness == schedule.delayedness; });
+
+   return existing == schedules->second.end() ? -1 : existing - schedules->second.begin();
+}
+
 /**
  * @brief Stop the SCIP clock and write a log entry of measured time
  * 
@@ -5,6 +5,8 @@
 #include <mutex>
 
 #include "../Instance.h"
+#include "../IncumbentExchangeHeur.h"
+#include "../LargeNeighborhoodSearchHeur.h"
 
 // scip includes
 #include "objscip/objbenders.h"
@@ -33,15 +35,18 @@ public:
 
    ~Master(); // destructor
 
-   // Mutex for synchronisation of concurrent access
-   std::mutex mutex_;
-
    // pointer to the scip environment for the restricted master-problem
    SCIP *scipRMP_;      
 
    // pointer to the instance
    shared_ptr<Instance> instance_; 
 
+   // lines that have a convexity constraint and a subproblem, only representative lines if identical lines are
+   // aggregated, see Settings::kAggregateIdenticalLines
+   vector<ProductionLine> lines_;
+   // number of identical lines represented by every line of lines_, i.e. rhs of its convexity constraint
+   map<ProductionLine, int> line_multiplicity_;
+
    // List of schedules per production line, i.e. column coefficients
    map<ProductionLine, vector<shared_ptr<ProductionLineSchedule>>> schedules_; // TODO: refactor into one combined map with lambda vars
    
@@ -81,6 +86,16 @@ public:
    // solve the problem void solve();
    void Solve(double time_limit);
 
+   // memory limit of SCIP in megabytes
+   void SetMemoryLimit(double megabytes);
+
+   // memory currently used by SCIP in megabytes, without the subproblems
+   double GetMemoryUsed();
+
+   // write model files for debugging, see EnableModelFiles
+   bool write_model_files_ = false;
+   void EnableModelFiles();
+
    // display the solution
    void DisplaySolution();
 
@@ -92,8 +107,34 @@ public:
    void CreateSVariable(Coil coil_i);
    void CreateXVariable(Coil coil_i, Coil coil_j, ProductionLine line, Mode mode_i, Mode mode_j);
 
-   // Find successor coil
-   tuple<bool, Coil, Mode, Mode> FindSucessorCoil(SCIP_Sol *solution, Coil coil_i, ProductionLine line);
+   // share incumbents with other solvers during Solve, see IncumbentExchangeHeur
+   void IncludeIncumbentExchange(shared_ptr<IncumbentExchange> exchange);
+
+   // improve incumbents during Solve by destroying and repairing their sequences, see LargeNeighborhoodSearchHeur
+   void IncludeLargeNeighborhoodSearch();
+
+   // translation between solutions of the master problem and sequences
+   SequenceSolution ExtractSolution(SCIP_SOL *solution);
+   SCIP_RESULT ImportSolution(const SequenceSolution &solution, SCIP_HEUR *heur);
+
+   // incumbent after Solve, false if there is none
+   bool GetBestSolution(SequenceSolution &solution);
+
+   // every column as (line, sequence), e.g. to start a later solve from them
+   vector<tuple<ProductionLine, vector<tuple<Coil, Mode>>>> GetColumnSequences();
+
+   // columns of the sequences of a solution and a solution selecting them, see MyPricer::AddInitialSolution
+   vector<shared_ptr<ProductionLineSchedule>> CreateColumns(const SequenceSolution &solution);
+   void SetColumnSolution(SCIP_SOL *sol, const vector<shared_ptr<ProductionLineSchedule>> &columns);
+
+   long FindColumn(const ProductionLineSchedule &schedule);
+
+   // columns of imported solutions that are not in the master problem yet, added by the pricer at its next call
+   vector<shared_ptr<ProductionLineSchedule>> pending_columns_;
+
+   // owned by SCIP, nullptr if no incumbents are shared
+   IncumbentExchangeHeur *incumbent_exchange_heur_ = nullptr;
+
 
    // Experiment: try to find most covering production plan, disabled
    bool initial_column_heuristic_tried_ = false;
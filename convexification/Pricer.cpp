@@ -1,11 +1,13 @@
 #include <memory>
 #include <tuple>
 #include "Pricer.h"
+#include "../Logger.h"
 #include "SubProblem.h"
 #include "scip/scip.h"
 #include <thread>
 #include <condition_variable>
 #include <mutex>
+#include <chrono>
 
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/range/adaptor/filtered.hpp>
@@ -22,11 +24,11 @@ bool map_compare(Map const &lhs, Map const &rhs)
                                                 rhs.begin());
 }
 /**
- * @brief Checks if a solution is already present in the master problem, i.e. if it was already generated 
+ * @brief Checks if a schedule with the same edges is contained in a list of schedules
 */
-bool MyPricer::CheckSolutionAlreadyPresent(ProductionLine &line, shared_ptr<ProductionLineSchedule> &solution)
+bool MyPricer::ScheduleContained(const vector<shared_ptr<ProductionLineSchedule>> &schedules, const shared_ptr<ProductionLineSchedule> &solution)
 {
-  for (auto &existing_schedule : master_problem_->schedules_[line])
+  for (auto &existing_schedule : schedules)
   {
     if (map_compare(existing_schedule->edges, solution->edges))
     {
@@ -38,20 +40,63 @@ bool MyPricer::CheckSolutionAlreadyPresent(ProductionLine &line, shared_ptr<Prod
 }
 
 /**
- * @brief Constructs the pricer. Initializes dual values pointer and initialize every subproblem
+ * @brief Checks if a solution is already present in the master problem, i.e. if it was already generated 
+ * 
+ * @note Called by pricing threads without any lock. This is safe since schedules of the master problem are only
+ * modified by the SCIP thread while no pricing thread is running, see AddQueuedColumns
 */
-MyPricer::MyPricer(shared_ptr<Master> master_problem, const char *pricer_name, const char *pricer_desc, int pricer_priority, SCIP_Bool pricer_delay)
+bool MyPricer::CheckSolutionAlreadyPresent(ProductionLine &line, shared_ptr<ProductionLineSchedule> &solution)
+{
+  // don't use operator[] here since it may insert into the map
+  auto schedules = master_problem_->schedules_.find(line);
+  if (schedules == master_problem_->schedules_.end())
+  {
+    return false;
+  }
+
+  return ScheduleContained(schedules->second, solution);
+}
+
+/**
+ * @brief Constructs the pricer. Initializes dual values pointer and initialize every subproblem with the given
+ * formulation of timing constraints
+*/
+MyPricer::MyPricer(shared_ptr<Master> master_problem, const char *pricer_name, const char *pricer_desc, int pricer_priority, SCIP_Bool pricer_delay, Settings::TimingFormulation timing_formulation)
     : ObjPricer(master_problem->scipRMP_, pricer_name, pricer_desc, pricer_priority, pricer_delay), // TRUE : LP is re-optimized each time a variable is added
       pricer_name_(pricer_name), pricer_desc_(pricer_desc), master_problem_(master_problem), scipRMP_(master_problem->scipRMP_), instance_(master_problem->instance_)
 {
   // Initialize dual values object
   this->dual_values_ = make_shared<DualValues>(instance_);
 
-  // Initialize each subproblem
-  for (auto &line : instance_->productionLines)
+  // Initialize each subproblem, identical lines share the subproblem of their representative
+  // every subproblem has its own SCIP instance, so they are built concurrently with one thread per line
+  // entries are created before starting the threads so that no thread inserts into the maps
+  auto setup_start = std::chrono::steady_clock::now();
+  map<ProductionLine, thread> setup_threads;
+  for (auto &line : master_problem_->lines_)
+  {
+    auto &subproblem = this->subproblems_[line];
+    auto *bucket_pricing = Settings::kEnableBucketPricing ? &this->bucket_pricings_[line] : nullptr;
+    auto setup = [this, line, &subproblem, bucket_pricing, timing_formulation]
+    {
+      subproblem.Setup(instance_, line, timing_formulation);
+      if (bucket_pricing != nullptr)
+        bucket_pricing->Setup(instance_, line);
+    };
+
+    if (Settings::kEnableParallelModelConstruction)
+      setup_threads[line] = thread(setup);
+    else
+      setup();
+  }
+
+  for (auto &[line, thread] : setup_threads)
   {
-    this->subproblems_[line].Setup(instance_, line);
+    thread.join();
   }
+
+  PHALS_LOG(kInfo) << "Subproblems of " << master_problem_->lines_.size() << " lines built in "
+                   << std::chrono::duration<double>(std::chrono::steady_clock::now() - setup_start).count() << "s" << endl;
 }
 /**
   * @brief Print the current master bounds and stop master scip clock to capture elapsed time until method call
@@ -63,24 +108,26 @@ void MyPricer::PrintMasterBoundsAndMeasure(bool is_farkas)
   auto dual_bound = SCIPgetDualbound(scipRMP_);
   auto avg_dual_bound = SCIPgetAvgDualbound(scipRMP_);
   auto primal_bound = SCIPgetPrimalbound(scipRMP_);
-  cout << "=======================================================" << endl;
-  cout << "MyPricer::" << (is_farkas ? "scip_farkas" : "scip_redcost") << " was called" << endl
-       << "Pricer Iteration total: \t" << (redcost_iteration_ + farkas_iteration_) << "" << endl
-       << "\t current farkas: \t" << farkas_iteration_ << "" << endl
-       << "\t current redcost:\t" << redcost_iteration_ << "" << endl
-       << endl
-       << "Amount of solutions" << endl;
-  for (auto &line : instance_->productionLines)
-  {
-    cout << "Line " << line << ": " << master_problem_->schedules_[line].size() << endl;
-  }
-
-  cout << "Current Bounds" << endl
-       << "Primal (objective current incumbent): \t" << primal_bound << endl
-       << "Dual (best global dual bound):        \t" << dual_bound << endl
-       << "Avg Dual (Avg best global dual bound):\t" << avg_dual_bound << endl
-       << "=======================================================" << endl
-       << endl;
+
+  LogLine log_line(LogLevel::kInfo);
+  log_line << "=======================================================" << endl;
+  log_line << "MyPricer::" << (is_farkas ? "scip_farkas" : "scip_redcost") << " was called" << endl
+           << "Pricer Iteration total: \t" << (redcost_iteration_ + farkas_iteration_) << "" << endl
+           << "\t current farkas: \t" << farkas_iteration_ << "" << endl
+           << "\t current redcost:\t" << redcost_iteration_ << "" << endl
+           << endl
+           << "Amount of solutions" << endl;
+  for (auto &line : master_problem_->lines_)
+  {
+    log_line << "Line " << line << ": " << master_problem_->schedules_[line].size() << endl;
+  }
+
+  log_line << "Current Bounds" << endl
+           << "Primal (objective current incumbent): \t" << primal_bound << endl
+           << "Dual (best global dual bound):        \t" << dual_bound << endl
+           << "Avg Dual (Avg best global dual bound):\t" << avg_dual_bound << endl
+           << "=======================================================" << endl
+           << endl;
 }
 MyPricer::~MyPricer()
 {
@@ -125,6 +172,15 @@ SCIP_RETCODE MyPricer::scip_init(SCIP *scip, SCIP_PRICER *pricer)
     SCIPgetTransformedVar(scipRMP_, master_problem_->vars_S_[coil], &(master_problem_->vars_S_[coil]));
   }
 
+  // lambda, only initial columns exist before solving, see AddInitialSolution
+  for (auto &[line, vars] : master_problem_->vars_lambda_)
+  {
+    for (auto &var : vars)
+    {
+      SCIPgetTransformedVar(scipRMP_, var, &var);
+    }
+  }
+
   // ###########################################################################################################
   // get transformed constraints:
   // to get all transformed constraints, use the same loops, as in generation in the master-problem
@@ -167,11 +223,59 @@ SCIP_RETCODE MyPricer::scip_init(SCIP *scip, SCIP_PRICER *pricer)
   return SCIP_OKAY;
 }
 
+/**
+ * @brief Stores the dual bound of the last solve of a subproblem in the result of its line. Every solve of a pricing
+ * round uses the same objective, so the largest bound is kept.
+ */
+void MyPricer::RecordDualBound(SubProblem &subproblem, LinePricingResult &line_result)
+{
+  auto dual_bound = subproblem.GetDualBound();
+
+  // interrupted before the root node was solved
+  if (SCIPisInfinity(subproblem.scipSP_, -dual_bound))
+    return;
+
+  if (!line_result.dual_bound_valid || dual_bound > line_result.dual_bound)
+  {
+    line_result.dual_bound = dual_bound;
+    line_result.dual_bound_valid = true;
+  }
+}
+
 /**
  * @brief Solves a subproblem for a given line. Performs heuristic if enabled,
+ * found columns, dual bounds and interruption of the line are stored in line_result
 */
-SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproblem, bool is_farkas, vector<shared_ptr<ProductionLineSchedule>> solutions, condition_variable &search_terminated, bool &termination_flag)
+SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproblem, bool is_farkas, LinePricingResult &line_result, condition_variable &search_terminated, bool &termination_flag)
 {
+  // run labeling on the bucketed network first, the subproblem MIP is the exact fallback
+  if (Settings::kEnableBucketPricing)
+  {
+    auto &bucket_pricing = bucket_pricings_.at(line);
+    auto bucket_solutions = bucket_pricing.Solve(dual_values_, is_farkas);
+
+    bool bucket_column_found = false;
+    for (auto &bucket_solution : bucket_solutions)
+    {
+      if (CheckSolutionAlreadyPresent(line, bucket_solution) || ScheduleContained(line_result.columns, bucket_solution))
+        continue;
+
+      column_queue_.Push(bucket_solution);
+      line_result.columns.push_back(bucket_solution);
+      bucket_column_found = true;
+    }
+
+    PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Bucket pricing (width " << bucket_pricing.bucket_width_ << ") found " << line_result.columns.size() << " unique columns" << endl;
+
+    if (bucket_column_found)
+    {
+      // terminate other
+      termination_flag = true;
+      search_terminated.notify_all();
+      return SCIP_SUCCESS;
+    }
+  }
+
   // run exact pricing if needed
   if (Settings::kInitialSolveEnabled)
   {
@@ -180,18 +284,11 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
     subproblem.SetTimeLimit(Settings::kInitialSolveTimeTimeLimitInSeconds);
     subproblem.UpdateObjective(dual_values_, is_farkas);
 
-    {
-      // acquire lock to protect cout
-      std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-      cout << "[Subproblem L" << line << "]: Initial Solving. Trying to solve subproblem with gap " << Settings::kInitialSolveGap << " and time limit " << Settings::kInitialSolveTimeTimeLimitInSeconds << endl;
-    }
+    PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Initial Solving. Trying to solve subproblem with gap " << Settings::kInitialSolveGap << " and time limit " << Settings::kInitialSolveTimeTimeLimitInSeconds << endl;
 
     auto subproblem_solutions = subproblem.Solve();
-    {
-      // acquire lock to protect cout
-      std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-      cout << "[Subproblem L" << line << "]: Initial Solving. Subproblem solved with " << subproblem_solutions.size() << " feasible solutions" << endl;
-    }
+    RecordDualBound(subproblem, line_result);
+    PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Initial Solving. Subproblem solved with " << subproblem_solutions.size() << " feasible solutions" << endl;
 
     bool initial_solving_column_found = false;
     // iterate over all solutions
@@ -201,28 +298,24 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
 
       if (subproblem_solution->reduced_cost_negative)
       {
-        // acquire lock to protect master problem, see RAII
-        std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-
-        // check if solution is already contained in our generated schedules
-        bool schedule_contained = CheckSolutionAlreadyPresent(line, subproblem_solution);
+        // check if solution is already contained in our generated schedules or was already found by this thread
+        bool schedule_contained = CheckSolutionAlreadyPresent(line, subproblem_solution) || ScheduleContained(line_result.columns, subproblem_solution);
 
         if (!schedule_contained)
         {
-          // add schedule and corresponding variable if it wasn't generated previously
-          cout << "[Subproblem L" << line << "]: Initial Solving. One unique column found and added" << endl;
+          // queue schedule if it wasn't generated previously, it is added to the master problem at the end of the pricing round
+          PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Initial Solving. One unique column found and queued" << endl;
 
-          DisplaySchedule(subproblem_solution);
-          AddNewVar(subproblem_solution);
+          column_queue_.Push(subproblem_solution);
 
           // add to output vector
-          solutions.push_back(subproblem_solution);
+          line_result.columns.push_back(subproblem_solution);
 
           initial_solving_column_found = true;
         }
         else
         {
-          cout << "[Subproblem L" << line << "]: Initial Solving. One solution column with rc=" << subproblem_solution->reduced_cost << " already present" << endl;
+          PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Initial Solving. One solution column with rc=" << subproblem_solution->reduced_cost << " already present" << endl;
         }
       }
     }
@@ -258,28 +351,21 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
   while (!terminate && round_counter < Settings::kDynamicGapMaxRounds && not_interrupted)
   {
     round_counter++;
-    {
-      // acquire lock to protect cout
-      std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-      cout << "[Subproblem L" << line << "]: Solving subproblem with dynamic gap of " << subproblem.dynamic_gap_ << endl;
-    }
+    PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Solving subproblem with dynamic gap of " << subproblem.dynamic_gap_ << endl;
 
     subproblem.UpdateObjective(dual_values_, is_farkas);
     auto subproblem_solutions = subproblem.Solve();
     auto dual_bound = subproblem.GetDualBound();
+    RecordDualBound(subproblem, line_result);
 
-    {
-      // acquire lock to protect cout
-      std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-      cout << "[Subproblem L" << line << "]: Subproblem solved with " << subproblem_solutions.size() << " feasible solutions" << endl;
-      cout << "[Subproblem L" << line << "]: Dual Bound of subproblem: " << dual_bound << endl;
+    PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Subproblem solved with " << subproblem_solutions.size() << " feasible solutions" << endl
+                     << "[Subproblem L" << line << "]: Dual Bound of subproblem: " << dual_bound << endl;
 
-      if (!subproblem.IsDualBoundNegative())
-      {
-        cout << "[Subproblem L" << line << "]: Dual Bound of subproblem is not negative. Terminating." << endl;
+    if (!subproblem.IsDualBoundNegative())
+    {
+      PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Dual Bound of subproblem is not negative. Terminating." << endl;
 
-        return SCIP_DIDNOTFIND;
-      }
+      return SCIP_DIDNOTFIND;
     }
 
     bool unique_column_with_negative_reduced_cost_found = false;
@@ -290,22 +376,18 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
 
       if (subproblem_solution->reduced_cost_negative)
       {
-        // acquire lock to protect master problem, see RAII
-        std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-
-        // check if solution is already contained in our generated schedules
-        bool schedule_contained = CheckSolutionAlreadyPresent(line, subproblem_solution);
+        // check if solution is already contained in our generated schedules or was already found by this thread
+        bool schedule_contained = CheckSolutionAlreadyPresent(line, subproblem_solution) || ScheduleContained(line_result.columns, subproblem_solution);
 
         if (!schedule_contained)
         {
-          // add schedule and corresponding variable if it wasn't generated previously
-          cout << "[Subproblem L" << line << "]: One unique column found and added" << endl;
+          // queue schedule if it wasn't generated previously, it is added to the master problem at the end of the pricing round
+          PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: One unique column found and queued" << endl;
 
-          DisplaySchedule(subproblem_solution);
-          AddNewVar(subproblem_solution);
+          column_queue_.Push(subproblem_solution);
 
           // add to output vector
-          solutions.push_back(subproblem_solution);
+          line_result.columns.push_back(subproblem_solution);
 
           terminate = true;
           column_found = true;
@@ -314,21 +396,18 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
         }
         else
         {
-          cout << "[Subproblem L" << line << "]: One solution column with rc=" << subproblem_solution->reduced_cost << " already present" << endl;
+          PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: One solution column with rc=" << subproblem_solution->reduced_cost << " already present" << endl;
         }
       }
     }
 
     if (!unique_column_with_negative_reduced_cost_found)
     {
-      // acquire lock to protect cout
-      std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-
       // if dynamic gap is below cutoff, terminate search
       auto old_gap = subproblem.dynamic_gap_;
       if (old_gap <= Settings::kDynamicGapLowerBound)
       {
-        cout << "[Subproblem L" << line << "]: No unique columns found. Dynamic gap of " << subproblem.dynamic_gap_ << " reached cut-off of " << Settings::kDynamicGapLowerBound << ". Terminating search for this subproblem." << endl;
+        PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: No unique columns found. Dynamic gap of " << subproblem.dynamic_gap_ << " reached cut-off of " << Settings::kDynamicGapLowerBound << ". Terminating search for this subproblem." << endl;
         column_found = false;
 
         terminate = true;
@@ -338,14 +417,14 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
         // reduce dynamic gap
         subproblem.dynamic_gap_ /= 2;
         column_found = false;
-        cout << "[Subproblem L" << line << "]: No unique columns found. Max rounds reached of " << Settings::kDynamicGapMaxRounds << " rounds" << endl;
+        PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: No unique columns found. Max rounds reached of " << Settings::kDynamicGapMaxRounds << " rounds" << endl;
       }
       else
       {
         // reduce dynamic gap
         subproblem.dynamic_gap_ /= 2;
         column_found = false;
-        cout << "[Subproblem L" << line << "]: No unique columns found. Trying with lower dynamic gap from " << old_gap << " to " << subproblem.dynamic_gap_ << endl;
+        PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: No unique columns found. Trying with lower dynamic gap from " << old_gap << " to " << subproblem.dynamic_gap_ << endl;
       }
     }
 
@@ -353,18 +432,11 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
     {
       // if it was interrupted, cancel here
       not_interrupted = false;
-      // acquire lock to protect cout
-      {
-        std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-        cout << "[Subproblem L" << line << "]: Further solution process was interrupted. Stopping here." << endl;
-      }
+      line_result.interrupted = true;
+      PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Further solution process was interrupted. Stopping here." << endl;
     }
   }
-  // acquire lock to protect cout
-  {
-    std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-    cout << "[Subproblem L" << line << "]: Total of " << columns_added << " number of columns added to subproblem" << endl;
-  }
+  PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Total of " << columns_added << " number of columns added to subproblem" << endl;
 
   if (column_found)
   {
@@ -376,6 +448,8 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
 
   if (termination_flag)
   {
+    // another line found a column, the exact solve of this line is skipped
+    line_result.interrupted = true;
     return SCIP_DIDNOTFIND;
   }
 
@@ -383,18 +457,11 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
   subproblem.SetTimeLimit(Settings::kInitialSolveTimeTimeLimitInSeconds);
   subproblem.UpdateObjective(dual_values_, is_farkas);
 
-  {
-    // acquire lock to protect cout
-    std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-    cout << "[Subproblem L" << line << "]: Exact Solving. Trying to solve subproblem with gap " << Settings::kInitialSolveGap << " and time limit " << Settings::kInitialSolveTimeTimeLimitInSeconds << endl;
-  }
+  PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Exact Solving. Trying to solve subproblem with gap " << Settings::kInitialSolveGap << " and time limit " << Settings::kInitialSolveTimeTimeLimitInSeconds << endl;
 
   auto subproblem_solutions = subproblem.Solve();
-  {
-    // acquire lock to protect cout
-    std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-    cout << "[Subproblem L" << line << "]: Exact Solving. Subproblem solved with " << subproblem_solutions.size() << " feasible solutions" << endl;
-  }
+  RecordDualBound(subproblem, line_result);
+  PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Exact Solving. Subproblem solved with " << subproblem_solutions.size() << " feasible solutions" << endl;
 
   column_found = false;
   // iterate over all solutions
@@ -403,28 +470,24 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
     // add variable if it could happen that selecting it improves the objective
     if (subproblem_solution->reduced_cost_negative)
     {
-      // acquire lock to protect master problem, see RAII
-      std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-
-      // check if solution is already contained in our generated schedules
-      bool schedule_contained = CheckSolutionAlreadyPresent(line, subproblem_solution);
+      // check if solution is already contained in our generated schedules or was already found by this thread
+      bool schedule_contained = CheckSolutionAlreadyPresent(line, subproblem_solution) || ScheduleContained(line_result.columns, subproblem_solution);
 
       if (!schedule_contained)
       {
-        // add schedule and corresponding variable if it wasn't generated previously
-        cout << "[Subproblem L" << line << "]: Exact Solving. One unique column found and added" << endl;
+        // queue schedule if it wasn't generated previously, it is added to the master problem at the end of the pricing round
+        PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Exact Solving. One unique column found and queued" << endl;
 
-        DisplaySchedule(subproblem_solution);
-        AddNewVar(subproblem_solution);
+        column_queue_.Push(subproblem_solution);
 
         // add to output vector
-        solutions.push_back(subproblem_solution);
+        line_result.columns.push_back(subproblem_solution);
 
         column_found = true;
       }
       else
       {
-        cout << "[Subproblem L" << line << "]: Exact Solving. One solution column with rc=" << subproblem_solution->reduced_cost << " already present" << endl;
+        PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Exact Solving. One solution column with rc=" << subproblem_solution->reduced_cost << " already present" << endl;
       }
     }
   }
@@ -439,8 +502,8 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
   // if the solution process was interrupted, stop here
   if (subproblem.WasInterrupted() && Settings::kEnableSubproblemInterruption)
   {
-    std::lock_guard<std::mutex> guard(master_problem_->mutex_);
-    cout << "[Subproblem L" << line << "]: Exact Solving. Further solution process was interrupted. Stopping here." << endl;
+    line_result.interrupted = true;
+    PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: Exact Solving. Further solution process was interrupted. Stopping here." << endl;
   }
 
   return SCIP_DIDNOTFIND;
@@ -450,10 +513,11 @@ SCIP_RESULT MyPricer::SolveSubProblem(ProductionLine line, SubProblem &subproble
  *
  * @param isFarkas perform farkas whether the master problem is LP-infeasible
  *
- * @return SCIP_RESULT
+ * @return PricingRoundResult columns, dual bounds and timings of every line, SCIP_SUCCESS if any column was added
  */
-SCIP_RESULT MyPricer::Pricing(const bool is_farkas)
+PricingRoundResult MyPricer::Pricing(const bool is_farkas)
 {
+  auto round_start = std::chrono::steady_clock::now();
 
   // ############################################################################################################
   //  define the dual variables
@@ -496,10 +560,36 @@ SCIP_RESULT MyPricer::Pricing(const bool is_farkas)
                                                       : SCIPgetDualsolLinear(scipRMP_, cons);
   }
 
+  // columns in the current LP solution are good starting points of the subproblems
+  // in farkas pricing the LP is infeasible and there is no LP solution
+  if (Settings::kEnableWarmStart)
+  {
+    for (auto &[line, subproblem] : subproblems_)
+    {
+      vector<shared_ptr<ProductionLineSchedule>> active_columns;
+      if (!is_farkas)
+      {
+        auto &vars_lambda = master_problem_->vars_lambda_[line];
+        for (size_t lambda_index = 0; lambda_index < vars_lambda.size(); lambda_index++)
+        {
+          if (SCIPisPositive(scipRMP_, SCIPgetSolVal(scipRMP_, NULL, vars_lambda[lambda_index])))
+          {
+            active_columns.push_back(master_problem_->schedules_[line][lambda_index]);
+          }
+        }
+      }
+      subproblem.SetWarmStartColumns(active_columns);
+    }
+  }
+
   // thread per subproblem
-  // solutions per subproblem
+  // result per subproblem, created before starting the threads so that no thread inserts into the map
   map<ProductionLine, thread> subproblem_threads;
-  map<ProductionLine, vector<shared_ptr<ProductionLineSchedule>>> subproblem_solutions;
+  PricingRoundResult round_result;
+  for (auto &[line, _] : subproblems_)
+  {
+    round_result.lines[line].line = line;
+  }
 
   // termination signaling see https://stackoverflow.com/a/43617125
   std::mutex termination_mutex;
@@ -510,8 +600,13 @@ SCIP_RESULT MyPricer::Pricing(const bool is_farkas)
 
   for (auto &[line, subproblem] : subproblems_)
   {
-    subproblem_threads[line] = thread([&]
-                                      { SolveSubProblem(line, subproblem, is_farkas, subproblem_solutions[line], search_terminated, termination_flag); });
+    auto &line_result = round_result.lines.at(line);
+    subproblem_threads[line] = thread([&, line = line]
+                                      {
+                                        auto line_start = std::chrono::steady_clock::now();
+                                        line_result.result = SolveSubProblem(line, subproblem, is_farkas, line_result, search_terminated, termination_flag);
+                                        line_result.solving_time_in_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - line_start).count();
+                                      });
   }
 
   if (Settings::kEnableSubproblemInterruption)
@@ -555,17 +650,33 @@ SCIP_RESULT MyPricer::Pricing(const bool is_farkas)
     }
   }
 
-  // check if any columns were found
-  // for this, check every vector of solutions
-  for (auto &[line, solution] : subproblem_solutions)
+  // every pricing thread has finished, add the found columns to the master problem in this thread
+  round_result.columns_added = AddQueuedColumns();
+  round_result.solving_time_in_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - round_start).count();
+
+  LogPricingRoundResult(round_result);
+
+  return round_result;
+}
+
+/**
+ * @brief Logs status, dual bound and time of every line of a pricing round
+ */
+void MyPricer::LogPricingRoundResult(const PricingRoundResult &round_result)
+{
+  LogLine log_line(LogLevel::kInfo);
+  log_line << "Pricing round: " << round_result.columns_added << " columns added in " << round_result.solving_time_in_seconds << "s"
+           << (round_result.AllLinesComplete() ? "" : ", some lines were interrupted") << endl;
+  for (auto &[line, line_result] : round_result.lines)
   {
-    if (solution.size() > 0)
-    {
-      return SCIP_SUCCESS;
-    }
+    log_line << "\tLine L" << line << ": " << line_result.columns.size() << " columns found, "
+             << (line_result.interrupted ? "interrupted" : "complete") << ", dual bound ";
+    if (line_result.dual_bound_valid)
+      log_line << line_result.dual_bound;
+    else
+      log_line << "unknown";
+    log_line << ", " << line_result.solving_time_in_seconds << "s" << endl;
   }
-
-  return SCIP_DIDNOTFIND;
 }
 
 /**
@@ -593,13 +704,33 @@ SCIP_RETCODE MyPricer::scip_redcost(SCIP *scip,
   // start measure pricing round
   StartMeasurePricingRound(false);
 
+  AddPendingColumns();
+
   // start dual-pricing with isFarkas-Flag = false
-  *result = Pricing(false);
+  auto round_result = Pricing(false);
+  *result = round_result.Result();
+
+  // Lagrangian bound: the LP value plus the minimal reduced cost of every line times the rhs of its convexity
+  // constraint is a lower bound of the current node. Only valid if every line provided a dual bound
+  if (round_result.AllDualBoundsValid())
+  {
+    auto lagrangian_bound = SCIPgetLPObjval(scipRMP_);
+    for (auto &[line, line_result] : round_result.lines)
+    {
+      lagrangian_bound += master_problem_->line_multiplicity_.at(line) * std::min(0.0, line_result.dual_bound);
+    }
+
+    *lowerbound = lagrangian_bound;
+    PHALS_LOG(kInfo) << "Lagrangian bound: " << lagrangian_bound << endl;
+  }
 
   // stop measure pricing round
   StopMeasurePricingRound(false);
 
-  cout << endl;
+  PHALS_LOG(kInfo) << endl;
+
+  // write all messages of this round before SCIP continues with its own output
+  Logger::Get().Flush();
 
   redcost_iteration_++;
 
@@ -625,18 +756,20 @@ SCIP_RETCODE MyPricer::scip_farkas(SCIP *scip, SCIP_PRICER *pricer, SCIP_RESULT
   // start measure pricing round
   StartMeasurePricingRound(true);
 
+  AddPendingColumns();
+
   // check if trivial column generation is enabled
   if (Settings::kGenerateInitialTrivialColumn)
   {
-    cout << "Generating initial trivial column for feasibility" << endl;
+    PHALS_LOG(kInfo) << "Generating initial trivial column for feasibility" << endl;
     // generate initial trivial column that is very expensive
     // for each coil find lines and modes it may be scheduled on
     map<Coil, map<ProductionLine, Mode>> modes_and_lines_per_coil;
     for (auto &coil_i : instance_->regularCoils)
     {
-      for (auto &line : instance_->productionLines)
+      for (auto &line : master_problem_->lines_)
       {
-        auto &modes_i = instance_->modes[make_tuple(coil_i, line)];
+        auto &modes_i = instance_->GetModes(coil_i, line);
         if (modes_i.size() > 0)
         {
           modes_and_lines_per_coil[coil_i][line] = modes_i[0];
@@ -660,6 +793,10 @@ SCIP_RETCODE MyPricer::scip_farkas(SCIP *scip, SCIP_PRICER *pricer, SCIP_RESULT
           if (lines_and_modes_j.count(line) > 0)
           {
             auto mode_j = lines_and_modes_j[line];
+            // arcs removed by preprocessing have no variable in the master problem
+            if (master_problem_->vars_X_.count(make_tuple(coil_i, coil_j, line, mode_i, mode_j)) == 0)
+              continue;
+
             // found a matching coil, add it to list
             coil_j_found = true;
             matched_coils[line].push_back(make_tuple(coil_i, coil_j, line, mode_i, mode_j));
@@ -675,7 +812,7 @@ SCIP_RETCODE MyPricer::scip_farkas(SCIP *scip, SCIP_PRICER *pricer, SCIP_RESULT
 
       if (!coil_j_found)
       {
-        cout << "No matching coil found";
+        PHALS_LOG(kWarning) << "No matching coil found" << endl;
       }
     }
 
@@ -686,7 +823,8 @@ SCIP_RETCODE MyPricer::scip_farkas(SCIP *scip, SCIP_PRICER *pricer, SCIP_RESULT
       cost_upper_bound += cost;
     }
 
-    for (auto &line : instance_->productionLines)
+    vector<shared_ptr<ProductionLineSchedule>> schedules;
+    for (auto &line : master_problem_->lines_)
     {
       auto schedule = make_shared<ProductionLineSchedule>();
       schedule->line = line;
@@ -699,23 +837,28 @@ SCIP_RETCODE MyPricer::scip_farkas(SCIP *scip, SCIP_PRICER *pricer, SCIP_RESULT
       }
 
       DisplaySchedule(schedule);
-      AddNewVar(schedule);
+      schedules.push_back(schedule);
     }
 
+    AddNewVars(schedules);
+
     *result = SCIP_SUCCESS;
   }
   else
   {
-    cout << "Farkas-Pricing: " << endl;
+    PHALS_LOG(kInfo) << "Farkas-Pricing: " << endl;
     // start farkas pricing
-    *result = Pricing(true);
+    *result = Pricing(true).Result();
   }
 
-  cout << endl;
+  PHALS_LOG(kInfo) << endl;
 
   // stop measure pricing round
   StopMeasurePricingRound(true);
 
+  // write all messages of this round before SCIP continues with its own output
+  Logger::Get().Flush();
+
   farkas_iteration_++;
 
   // start measuring master again
@@ -724,133 +867,357 @@ SCIP_RETCODE MyPricer::scip_farkas(SCIP *scip, SCIP_PRICER *pricer, SCIP_RESULT
 }
 
 /**
- * @brief add a new variable (a new possible production schedule of a line) to the master problem.
+ * @brief Drains the queue of columns found by the pricing threads. Removes duplicates, keeps the
+ * Settings::kMaxColumnsPerLineAndRound columns with the most negative reduced cost per line and adds them to the
+ * master problem. Must be called from the SCIP thread while no pricing thread is running.
  *
- * @param solution a pointer to a production schedule
+ * @return int Number of columns added to the master problem
  */
-void MyPricer::AddNewVar(shared_ptr<ProductionLineSchedule> schedule)
+int MyPricer::AddQueuedColumns()
 {
-  auto line = schedule->line;
+  map<ProductionLine, vector<shared_ptr<ProductionLineSchedule>>> candidates_per_line;
 
-  char var_name[Settings::kSCIPMaxStringLength];
+  for (auto &column : column_queue_.TakeAll())
+  {
+    auto &candidates = candidates_per_line[column->line];
 
-  // create the new variable
-  SCIP_VAR *new_variable;
+    // same schedule may have been found in several rounds of dynamic gap solving
+    if (!ScheduleContained(candidates, column) && !CheckSolutionAlreadyPresent(column->line, column))
+    {
+      candidates.push_back(column);
+    }
+  }
 
-  auto lambda_index = master_problem_->vars_lambda_[schedule->line].size();
+  vector<shared_ptr<ProductionLineSchedule>> columns;
+  for (auto &[line, candidates] : candidates_per_line)
+  {
+    // best columns first, i.e. most negative reduced cost
+    std::stable_sort(candidates.begin(), candidates.end(), [](const shared_ptr<ProductionLineSchedule> &lhs, const shared_ptr<ProductionLineSchedule> &rhs)
+                     { return lhs->reduced_cost < rhs->reduced_cost; });
 
-  schedule->lambda_index = lambda_index;
+    if (Settings::kMaxColumnsPerLineAndRound > 0 && candidates.size() > Settings::kMaxColumnsPerLineAndRound)
+    {
+      candidates.resize(Settings::kMaxColumnsPerLineAndRound);
+    }
 
-  (void)SCIPsnprintf(var_name, Settings::kSCIPMaxStringLength, "lambda_L%d_%d", schedule->line, schedule->lambda_index); // create name
+    for (auto &column : candidates)
+    {
+      DisplaySchedule(column);
+      columns.push_back(column);
+    }
 
-  SCIPcreateVar(scipRMP_,                // scip-env
-                &new_variable,           // connect with the new variable
-                var_name,                // set name
-                0.0,                     // lower bound
-                SCIPinfinity(scipRMP_),  // upper bound
-                schedule->schedule_cost, // objective
-                SCIP_VARTYPE_CONTINUOUS, // continouus since we are using convexification
-                false,
-                false,
-                NULL,
-                NULL,
-                NULL,
-                NULL,
-                NULL);
+    PHALS_LOG(kInfo) << "[Subproblem L" << line << "]: " << candidates.size() << " columns added to master problem" << endl;
+  }
 
-  // add the new variable and resume the simplex-algorithm with the reducedCosts
-  // TODO: find out why this is negative here
-  SCIPaddPricedVar(scipRMP_, new_variable, -schedule->reduced_cost);
+  // commit columns of all lines together
+  AddNewVars(columns);
 
-  // add variable to list of lambda variable per line
-  master_problem_->vars_lambda_[schedule->line].push_back(new_variable);
+  return columns.size();
+}
 
-  // add schedule to list of schedules per line
-  master_problem_->schedules_[schedule->line].push_back(schedule);
+/**
+ * @brief Adds the columns of solutions imported from other solvers, see Master::ImportSolution. Priced variables can
+ * only be added by the pricer, so the import waits for the next pricing round.
+ */
+void MyPricer::AddPendingColumns()
+{
+  // the heuristic hands over the same columns until they are added, so duplicates are dropped here
+  // delayed coils are compared as well since imported columns must match the timing of the imported solution
+  vector<shared_ptr<ProductionLineSchedule>> columns;
+  for (auto &column : master_problem_->pending_columns_)
+  {
+    auto duplicate = std::any_of(columns.begin(), columns.end(), [&column](const shared_ptr<ProductionLineSchedule> &added)
+                                 { return added->line == column->line && added->edges == column->edges && added->delayedness == column->delayedness; });
+    if (duplicate || master_problem_->FindColumn(*column) >= 0)
+      continue;
 
-  // ############################################################################################################
+    columns.push_back(column);
+  }
+  master_problem_->pending_columns_.clear();
 
-  //  add coefficients to the constraints
+  if (columns.empty())
+    return;
 
-  // partitioning constraint
-  // TODO: rethink this loop since it is not efficient, at least not as it could be ;-)
-  for (auto coil_i : instance_->coilsWithoutStartCoil)
+  PHALS_LOG(kInfo) << "Adding " << columns.size() << " columns of imported solutions" << endl;
+  AddNewVars(columns);
+}
+
+/**
+ * @brief Computes the sparse column of a schedule in the master problem, i.e. every constraint the lambda variable
+ * of the schedule occurs in together with its nonzero coefficient. Only the edges and delayed coils of the schedule
+ * are visited.
+ *
+ * @param schedule The schedule
+ * @return SparseColumn List of (constraint, coefficient) pairs
+ */
+MyPricer::SparseColumn MyPricer::ComputeColumnCoefficients(const ProductionLineSchedule &schedule)
+{
+  SparseColumn column;
+  column.reserve(2 * schedule.edges.size() + 2 * schedule.delayedness.size() + 1);
+
+  // edges of schedule
+  for (auto &[tuple, incidence] : schedule.edges)
   {
-    for (auto &[tuple, incidence] : schedule->edges)
-    {
-      const auto &[tuple_coil_i, tuple_coil_j, tuple_line, tuple_mode_i, tuple_mode_j] = tuple;
+    if (!incidence)
+      continue;
 
-      if (tuple_coil_i != coil_i)
-      {
-        // skip this variable since it does not occur in this constraint
-        continue;
-      }
+    auto coil_i = get<0>(tuple);
 
-      // TODO: decide whether to add to constraint if incidence == false
-      SCIP_Real column_coefficient = incidence ? 1 : 0;
-      SCIPaddCoefLinear(scipRMP_, master_problem_->cons_coil_partitioning_[coil_i], new_variable, column_coefficient);
+    // partitioning constraint: coil i is scheduled on this line since it has an outgoing edge
+    // start coil has no partitioning constraint
+    if (instance_->IsRegularCoil(coil_i))
+    {
+      column.emplace_back(master_problem_->cons_coil_partitioning_.at(coil_i), 1);
     }
+
+    // original variable reconstruction X
+    column.emplace_back(master_problem_->cons_original_var_X.at(tuple), -1);
   }
 
-  // max delay constraint
-  for (auto &[coil, delayed] : schedule->delayedness)
+  // delayed coils of schedule
+  for (auto &[coil, delayed] : schedule.delayedness)
   {
-    // TODO: decide whether to add if incidence == false
-    SCIP_Real column_coefficient = delayed ? 1 : 0;
-    SCIPaddCoefLinear(scipRMP_, master_problem_->cons_max_delayed_coils_, new_variable, column_coefficient);
+    if (!delayed)
+      continue;
+
+    // max delay constraint only counts regular coils
+    if (instance_->IsRegularCoil(coil))
+    {
+      column.emplace_back(master_problem_->cons_max_delayed_coils_, 1);
+    }
+
+    // original variable reconstruction Z
+    column.emplace_back(master_problem_->cons_original_var_Z.at(coil), -1);
   }
 
   // convexity constraint
-  SCIPaddCoefLinear(scipRMP_, master_problem_->cons_convexity_[schedule->line], new_variable, 1);
+  column.emplace_back(master_problem_->cons_convexity_.at(schedule.line), 1);
+
+  return column;
+}
+
+/**
+ * @brief add new variables (new possible production schedules of lines) to the master problem.
+ *
+ * @note All variables are created first, then the coefficients of all columns are added constraint by constraint.
+ * Each column is computed once from its edges and only nonzero coefficients are added.
+ *
+ * @param schedules pointers to production schedules
+ */
+void MyPricer::AddNewVars(const vector<shared_ptr<ProductionLineSchedule>> &schedules)
+{
+  if (schedules.empty())
+    return;
+
+  char var_name[Settings::kSCIPMaxStringLength];
+
+  // initial columns are regular variables of the original problem, see AddInitialSolution
+  bool before_solving = SCIPgetStage(scipRMP_) == SCIP_STAGE_PROBLEM;
 
-  // original variable reconstruction
-  // var X
-  for (auto &[tuple, incidence] : schedule->edges)
+  // rows of all new columns, in order of first occurence to keep coefficient order deterministic
+  map<SCIP_CONS *, size_t> row_index;
+  vector<tuple<SCIP_CONS *, vector<SCIP_VAR *>, vector<SCIP_Real>>> rows;
+
+  for (auto &schedule : schedules)
   {
-    // TODO: decide whether to add to constraint if incidence == false
-    SCIP_Real column_coefficient = incidence ? 1 : 0;
-    SCIPaddCoefLinear(scipRMP_, master_problem_->cons_original_var_X[tuple], new_variable, -column_coefficient);
+    // create the new variable
+    SCIP_VAR *new_variable;
+
+    auto lambda_index = master_problem_->vars_lambda_[schedule->line].size();
+
+    schedule->lambda_index = lambda_index;
+
+    (void)SCIPsnprintf(var_name, Settings::kSCIPMaxStringLength, "lambda_L%d_%d", schedule->line, schedule->lambda_index); // create name
+
+    SCIPcreateVar(scipRMP_,                // scip-env
+                  &new_variable,           // connect with the new variable
+                  var_name,                // set name
+                  0.0,                     // lower bound
+                  SCIPinfinity(scipRMP_),  // upper bound
+                  schedule->schedule_cost, // objective
+                  SCIP_VARTYPE_CONTINUOUS, // continouus since we are using convexification
+                  before_solving,          // initial columns are in the first LP
+                  false,
+                  NULL,
+                  NULL,
+                  NULL,
+                  NULL,
+                  NULL);
+
+    if (before_solving)
+    {
+      SCIPaddVar(scipRMP_, new_variable);
+    }
+    else
+    {
+      // add the new variable and resume the simplex-algorithm with the reducedCosts
+      // TODO: find out why this is negative here
+      SCIPaddPricedVar(scipRMP_, new_variable, -schedule->reduced_cost);
+    }
+
+    // add variable to list of lambda variable per line
+    master_problem_->vars_lambda_[schedule->line].push_back(new_variable);
+
+    // add schedule to list of schedules per line
+    master_problem_->schedules_[schedule->line].push_back(schedule);
+
+    // distribute sparse column to rows
+    for (auto &[cons, coefficient] : ComputeColumnCoefficients(*schedule))
+    {
+      auto [entry, inserted] = row_index.emplace(cons, rows.size());
+      if (inserted)
+      {
+        rows.emplace_back(cons, vector<SCIP_VAR *>(), vector<SCIP_Real>());
+      }
+
+      auto &[_, row_vars, row_coefficients] = rows[entry->second];
+      row_vars.push_back(new_variable);
+      row_coefficients.push_back(coefficient);
+    }
   }
 
-  // var Z
-  for (auto &[coil, delayed] : schedule->delayedness)
+  // ############################################################################################################
+
+  //  add coefficients to the constraints, all new columns of a constraint at once
+  for (auto &[cons, row_vars, row_coefficients] : rows)
   {
-    // TODO: decide whether to add if incidence == false
-    SCIP_Real column_coefficient = delayed ? 1 : 0;
-    SCIPaddCoefLinear(scipRMP_, master_problem_->cons_original_var_Z[coil], new_variable, -column_coefficient);
+    for (size_t entry = 0; entry < row_vars.size(); entry++)
+    {
+      SCIPaddCoefLinear(scipRMP_, cons, row_vars[entry], row_coefficients[entry]);
+    }
   }
 
+  // there is no transformed problem before solving
+  if (before_solving)
+    return;
+
+  if (!master_problem_->write_model_files_)
+    return;
+
   char model_name[Settings::kSCIPMaxStringLength];
-  (void)SCIPsnprintf(model_name, Settings::kSCIPMaxStringLength, "TransMasterProblems/TransMaster_%d_%d.lp", schedule->line, lambda_index);
+  (void)SCIPsnprintf(model_name, Settings::kSCIPMaxStringLength, "TransMasterProblems/TransMaster_%d.lp", redcost_iteration_ + farkas_iteration_);
   SCIPwriteTransProblem(scipRMP_, model_name, "lp", FALSE);
 }
+
+/**
+ * @brief Writes the model files of the master problem and of all subproblems to the working directory
+ */
+void MyPricer::EnableModelFiles()
+{
+  master_problem_->EnableModelFiles();
+  for (auto &[line, subproblem] : subproblems_)
+  {
+    subproblem.write_model_files_ = true;
+  }
+}
+
+/**
+ * @brief Limits the memory SCIP may use for every subproblem, a subproblem reaching it stops its solve like its time limit
+ */
+void MyPricer::SetSubProblemMemoryLimit(double megabytes)
+{
+  for (auto &[line, subproblem] : subproblems_)
+  {
+    SCIPsetRealParam(subproblem.scipSP_, "limits/memory", megabytes);
+  }
+}
+
+/**
+ * @brief Memory currently used by the SCIP instances of all subproblems
+ */
+double MyPricer::GetSubProblemMemoryUsed()
+{
+  double megabytes = 0;
+  for (auto &[line, subproblem] : subproblems_)
+  {
+    megabytes += SCIPgetMemTotal(subproblem.scipSP_) / 1048576.0;
+  }
+  return megabytes;
+}
+
+/**
+ * @brief Adds columns known before solving, e.g. of an earlier solve, as initial variables of the master problem.
+ * Duplicates and columns that are already in the master problem are dropped like for imported solutions.
+ */
+void MyPricer::AddInitialColumns(const vector<shared_ptr<ProductionLineSchedule>> &columns)
+{
+  master_problem_->pending_columns_.insert(master_problem_->pending_columns_.end(), columns.begin(), columns.end());
+  AddPendingColumns();
+}
+
+/**
+ * @brief Starts branch and price from a known solution, e.g. the incumbent of the compact model. Its sequences are
+ * added as initial columns, so the first LP is feasible without farkas pricing, and the solution is added as incumbent
+ * that prunes nodes from the start. Has to be called before solving.
+ *
+ * @param solution Sequences of the solution with computed timing
+ * @return true If the solution could be translated into columns of the master problem
+ */
+bool MyPricer::AddInitialSolution(const SequenceSolution &solution)
+{
+  auto columns = master_problem_->CreateColumns(solution);
+  if (columns.empty())
+  {
+    PHALS_LOG(kInfo) << "Initial solution uses arcs removed by preprocessing, starting without initial columns" << endl;
+    return false;
+  }
+
+  AddInitialColumns(columns);
+
+  SCIP_SOL *sol;
+  SCIPcreateOrigSol(scipRMP_, &sol, NULL);
+  master_problem_->SetColumnSolution(sol, columns);
+
+  SCIP_Bool stored;
+  SCIPaddSolFree(scipRMP_, &sol, &stored);
+
+  PHALS_LOG(kInfo) << "Initial solution with cost " << solution.cost << (stored ? " added" : " rejected") << " as incumbent of the master problem" << endl;
+  return true;
+}
+
+/**
+ * @brief add a new variable (a new possible production schedule of a line) to the master problem.
+ *
+ * @param solution a pointer to a production schedule
+ */
+void MyPricer::AddNewVar(shared_ptr<ProductionLineSchedule> schedule)
+{
+  AddNewVars({schedule});
+}
 /** @brief Displays a found production schedule
  * @param column The schedule that should be printed
  */
 void MyPricer::DisplaySchedule(shared_ptr<ProductionLineSchedule> column)
 {
-  cout << "Schedule / new column" << endl
-       << "\tLine L" << column->line << endl
-       << "\tReduced costs: " << column->reduced_cost << endl
-       << "\tSchedule costs: " << column->schedule_cost << endl
-       << "\tEdges: ";
+  // don't even build the message if debug messages are disabled
+  if constexpr (!IsLogLevelEnabled(LogLevel::kDebug))
+  {
+    return;
+  }
+
+  LogLine log_line(LogLevel::kDebug);
+  log_line << "Schedule / new column" << endl
+           << "\tLine L" << column->line << endl
+           << "\tReduced costs: " << column->reduced_cost << endl
+           << "\tSchedule costs: " << column->schedule_cost << endl
+           << "\tEdges: ";
   for (auto &[tuple, incidence] : column->edges)
   {
     auto &[coil_i, coil_j, line, mode_i, mode_j] = tuple;
     assert(line == column->line);
 
     if (incidence)
-      cout << "\t\tC" << coil_i << "M" << mode_i << " -> C" << coil_j << "M" << mode_j << endl;
+      log_line << "\t\tC" << coil_i << "M" << mode_i << " -> C" << coil_j << "M" << mode_j << endl;
   }
 
-  cout << "\tDelayed coils:" << endl;
+  log_line << "\tDelayed coils:" << endl;
   for (auto &[coil, delayed] : column->delayedness)
   {
     if (delayed)
-      cout << "\t\tCoil " << coil << endl;
+      log_line << "\t\tCoil " << coil << endl;
   }
 
-  cout << endl;
+  log_line << endl;
 }
 /**
  * @brief Starts Master Problem SCIP clock 
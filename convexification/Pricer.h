@@ -14,8 +14,11 @@
 #include "Master.h"
 
 #include "SubProblem.h"
+#include "BucketPricing.h"
 
 #include "ProductionLineSchedule.h"
+#include "ColumnQueue.h"
+#include "PricingResult.h"
 
 using namespace std;
 using namespace scip;
@@ -34,12 +37,13 @@ public:
    SCIP *scipRMP_;                     // pointer to the scip-env of the master-problem
 
    map<ProductionLine, SubProblem> subproblems_;
+   map<ProductionLine, BucketPricing> bucket_pricings_;
 
    const char *pricer_name_;
    const char *pricer_desc_;
 
    // constructor
-   MyPricer(shared_ptr<Master> master_problem, const char *pricer_name, const char *pricer_description, int pricer_priority, SCIP_Bool pricer_delay);
+   MyPricer(shared_ptr<Master> master_problem, const char *pricer_name, const char *pricer_description, int pricer_priority, SCIP_Bool pricer_delay, Settings::TimingFormulation timing_formulation = Settings::kDefaultTimingFormulation);
 
    virtual ~MyPricer();
 
@@ -57,7 +61,18 @@ public:
    virtual SCIP_RETCODE scip_farkas(SCIP *scip, SCIP_PRICER *pricer, SCIP_RESULT *result) override;
 
    // perform pricing for dual and farkas combined with flag isFarkas
-   SCIP_RESULT Pricing(const bool is_farkas);
+   PricingRoundResult Pricing(const bool is_farkas);
+
+   // columns and incumbent of a known solution, called before solving
+   bool AddInitialSolution(const SequenceSolution &solution);
+   void AddInitialColumns(const vector<shared_ptr<ProductionLineSchedule>> &columns);
+
+   // write the master problem and the subproblems of every pricing round for debugging, see Master::EnableModelFiles
+   void EnableModelFiles();
+
+   // memory limit of every subproblem SCIP in megabytes and the memory they currently use together
+   void SetSubProblemMemoryLimit(double megabytes);
+   double GetSubProblemMemoryUsed();
 
 private:
 
@@ -66,6 +81,13 @@ private:
    // to add the new column, i.e., the stable set, to the master problem
    void AddNewVar(shared_ptr<ProductionLineSchedule> column);
 
+   // to add many new columns to the master problem at once
+   void AddNewVars(const vector<shared_ptr<ProductionLineSchedule>> &columns);
+
+   // nonzero coefficients of a column in the master problem
+   using SparseColumn = vector<pair<SCIP_CONS *, SCIP_Real>>;
+   SparseColumn ComputeColumnCoefficients(const ProductionLineSchedule &schedule);
+
    void DisplaySchedule(shared_ptr<ProductionLineSchedule> column);
 
    shared_ptr<DualValues> dual_values_; // Pointer to the values of the dual variables for the current iteration of the ColumnGeneration
@@ -74,9 +96,19 @@ private:
    int redcost_iteration_ = 0;
    int farkas_iteration_ = 0;
 
-   SCIP_RESULT SolveSubProblem(ProductionLine line, SubProblem& subproblem, bool is_farkas, vector<shared_ptr<ProductionLineSchedule>> solutions, condition_variable& search_terminated, bool& termination_flag);
+   SCIP_RESULT SolveSubProblem(ProductionLine line, SubProblem& subproblem, bool is_farkas, LinePricingResult& line_result, condition_variable& search_terminated, bool& termination_flag);
+   void RecordDualBound(SubProblem& subproblem, LinePricingResult& line_result);
+   void LogPricingRoundResult(const PricingRoundResult& round_result);
 
    bool CheckSolutionAlreadyPresent(ProductionLine& line, shared_ptr<ProductionLineSchedule>& solution);
+   static bool ScheduleContained(const vector<shared_ptr<ProductionLineSchedule>>& schedules, const shared_ptr<ProductionLineSchedule>& solution);
+
+   // columns found by the pricing threads, added to the master problem by AddQueuedColumns at the end of a pricing round
+   ColumnQueue column_queue_;
+   int AddQueuedColumns();
+
+   // columns of solutions imported from other solvers, see Master::pending_columns_
+   void AddPendingColumns();
 
    void StartMeasurePricingRound(bool is_farkas);
    void StopMeasurePricingRound(bool is_farkas);
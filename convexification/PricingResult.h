@@ -0,0 +1,64 @@
+#pragma once
+#include <scip/scip_general.h>
+#include <memory>
+#include <vector>
+#include <map>
+
+#include "ProductionLineSchedule.h"
+
+// Struct capturing the outcome of pricing a single production line in one pricing round
+struct LinePricingResult {
+    ProductionLine line = 0;
+    SCIP_RESULT result = SCIP_DIDNOTFIND;
+
+    // unique columns with negative reduced cost found by this line
+    vector<shared_ptr<ProductionLineSchedule>> columns;
+
+    // best (largest) dual bound of all subproblem solves of this round, i.e. lower bound on the minimal reduced cost
+    // of any column of this line. Only meaningful if dual_bound_valid is set
+    SCIP_Real dual_bound = 0;
+    bool dual_bound_valid = false;
+
+    // set if the search of this line was stopped before it finished, e.g. because another line found a column
+    bool interrupted = false;
+
+    double solving_time_in_seconds = 0;
+};
+
+// Struct capturing the outcome of a whole pricing round over all production lines
+struct PricingRoundResult {
+    map<ProductionLine, LinePricingResult> lines;
+
+    // columns actually added to the master problem after duplicate removal
+    int columns_added = 0;
+
+    double solving_time_in_seconds = 0;
+
+    // pricing was successful if any column was added to the master problem
+    SCIP_RESULT Result() const
+    {
+        return columns_added > 0 ? SCIP_SUCCESS : SCIP_DIDNOTFIND;
+    }
+
+    // true if no line was stopped before its search finished
+    bool AllLinesComplete() const
+    {
+        for (auto &[line, line_result] : lines)
+        {
+            if (line_result.interrupted)
+                return false;
+        }
+        return true;
+    }
+
+    // true if every line provided a dual bound, i.e. a Lagrangian bound can be computed
+    bool AllDualBoundsValid() const
+    {
+        for (auto &[line, line_result] : lines)
+        {
+            if (!line_result.dual_bound_valid)
+                return false;
+        }
+        return true;
+    }
+};
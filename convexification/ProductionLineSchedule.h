@@ -6,6 +6,7 @@ struct ProductionLineSchedule {
     bool reduced_cost_negative = false;
     SCIP_Real schedule_cost = 0;
     ProductionLine line = 0;
+    // sparse: only selected edges and delayed coils are contained
     map<tuple<Coil, Coil, ProductionLine, Mode, Mode>, bool> edges;
     map<Coil, bool> delayedness;
     int lambda_index = 0;
@@ -1,7 +1,11 @@
 #include "SubProblem.h"
+#include "../StartTimeLinkingConshdlr.h"
+#include "../Logger.h"
+#include <algorithm>
 #include <memory>
 #include <scip/scip.h>
 #include <scip/scipdefplugins.h>
+#include <scip/cons_indicator.h>
 /**
  * @brief Sets the gap of the subproblem
  * 
@@ -62,7 +66,7 @@ void SubProblem::CreateZVariable(Coil coil_i)
                      0,                     // lower bound
                      1,                     // upper bound
                      0,                     // objective function coefficient, equal to 0 according to model
-                     SCIP_VARTYPE_INTEGER); // variable type
+                     SCIP_VARTYPE_BINARY);  // variable type, binary since it may be used as indicator
 
   SCIPaddVar(scipSP_, *z_var_pointer);
 }
@@ -75,9 +79,12 @@ void SubProblem::CreateZVariable(Coil coil_i)
 void SubProblem::CreateSVariable(Coil coil_i)
 {
   assert(vars_S_.count(coil_i) == 0);
-  // bounds of variable: if this is start coil, variable should be equal to 0, else 0 <= var <= +infty
+  // bounds of variable: if this is start coil, variable should be equal to 0, else 0 <= var <= latest start on this line
+  // the end coil has no start time restrictions
   SCIP_Real lb = instance_->IsStartCoil(coil_i) ? 0 : 0;
-  SCIP_Real ub = instance_->IsStartCoil(coil_i) ? 0 : SCIPinfinity(scipSP_);
+  SCIP_Real ub = instance_->IsStartCoil(coil_i)   ? 0
+                 : instance_->IsEndCoil(coil_i) ? SCIPinfinity(scipSP_)
+                                                : instance_->GetStartTimeUpperBound(coil_i, line_);
 
   char var_cons_name[Settings::kSCIPMaxStringLength];
 
@@ -125,7 +132,7 @@ void SubProblem::CreateXVariable(Coil coil_i, Coil coil_j, ProductionLine line,
                      lb,                    // lower bound
                      ub,                    // upper bound
                      0,                     // objective function coefficient, this is 0 since it is altered by pricer
-                     SCIP_VARTYPE_INTEGER); // variable type
+                     SCIP_VARTYPE_BINARY);  // variable type, binary since it may be used as indicator
 
   SCIPaddVar(scipSP_, *x_var_pointer);
 }
@@ -156,11 +163,13 @@ void SubProblem::InterruptSolving()
  * 
  * @param instance The instance that is to be solved
  * @param line Production line of the subproblem
+ * @param timing_formulation Formulation of delay linking and start time linking constraints
  */
-void SubProblem::Setup(shared_ptr<Instance> instance, ProductionLine line)
+void SubProblem::Setup(shared_ptr<Instance> instance, ProductionLine line, Settings::TimingFormulation timing_formulation)
 {
   instance_ = instance;
   line_ = line;
+  timing_formulation_ = timing_formulation;
   // first generate the Subproblem with the method of the compact Model
   SCIPcreate(&scipSP_);
   SCIPincludeDefaultPlugins(scipSP_);
@@ -208,13 +217,17 @@ void SubProblem::Setup(shared_ptr<Instance> instance, ProductionLine line)
         continue;
       }
 
-      auto &modes_i = instance_->modes[make_tuple(coil_i, line_)];
-      auto &modes_j = instance_->modes[make_tuple(coil_j, line_)];
+      auto &modes_i = instance_->GetModes(coil_i, line_);
+      auto &modes_j = instance_->GetModes(coil_j, line_);
 
       for (auto &mode_i : modes_i)
       {
         for (auto &mode_j : modes_j)
         {
+          // no variable for arcs removed by preprocessing
+          if (instance_->IsArcEliminated(coil_i, mode_i, coil_j, mode_j, line_))
+            continue;
+
           CreateXVariable(coil_i, coil_j, line_, mode_i, mode_j);
         }
       }
@@ -251,11 +264,16 @@ void SubProblem::Setup(shared_ptr<Instance> instance, ProductionLine line)
   // skip sentinel coils, only regular coils
   for (auto &coil_j : instance_->regularCoils)
   {
-    for (auto &mode_i : instance_->modes[make_tuple(coil_i, line_)])
+    for (auto &mode_i : instance_->GetModes(coil_i, line_))
     {
-      for (auto &mode_j : instance_->modes[make_tuple(coil_j, line_)])
+      for (auto &mode_j : instance_->GetModes(coil_j, line_))
       {
-        SCIPaddCoefLinear(scipSP_, cons_production_line_start_, vars_X_[make_tuple(coil_i, coil_j, line_, mode_i, mode_j)], 1);
+        auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line_, mode_i, mode_j));
+        // skip variables that don't exist
+        if (var_X == vars_X_.end())
+          continue;
+
+        SCIPaddCoefLinear(scipSP_, cons_production_line_start_, var_X->second, 1);
       }
     }
   }
@@ -281,13 +299,16 @@ void SubProblem::Setup(shared_ptr<Instance> instance, ProductionLine line)
   // skip sentinel coils, only regular coils
   for (auto &coil_i : instance_->regularCoils)
   {
-    for (auto &mode_i : instance_->modes[make_tuple(coil_i, line_)])
+    for (auto &mode_i : instance_->GetModes(coil_i, line_))
     {
-      for (auto &mode_j : instance_->modes[make_tuple(coil_j, line_)])
+      for (auto &mode_j : instance_->GetModes(coil_j, line_))
       {
-        auto tuple = make_tuple(coil_i, coil_j, line_, mode_i, mode_j);
-        auto &var_X = vars_X_[tuple];
-        SCIPaddCoefLinear(scipSP_, cons_production_line_end_, var_X, 1);
+        auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line_, mode_i, mode_j));
+        // skip variables that don't exist
+        if (var_X == vars_X_.end())
+          continue;
+
+        SCIPaddCoefLinear(scipSP_, cons_production_line_end_, var_X->second, 1);
       }
     }
   }
@@ -298,9 +319,7 @@ void SubProblem::Setup(shared_ptr<Instance> instance, ProductionLine line)
   // skip sentinel coils, only regular coils
   for (auto &coil_j : instance_->regularCoils)
   {
-
-    auto coil_j_line_tuple = make_tuple(coil_j, line_);
-    for (auto &mode_j : instance_->modes[coil_j_line_tuple])
+    for (auto &mode_j : instance_->GetModes(coil_j, line_))
     {
       auto cons_tuple = make_tuple(coil_j, mode_j);
       SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "cons_flow_conservation_C%d_M%d", coil_j, mode_j);
@@ -320,9 +339,13 @@ void SubProblem::Setup(shared_ptr<Instance> instance, ProductionLine line)
       // skip end coil and include start coil
       for (auto &coil_i : instance_->coilsWithoutEndCoil)
       {
-        for (auto &mode_i : instance_->modes[make_tuple(coil_i, line_)])
+        for (auto &mode_i : instance_->GetModes(coil_i, line_))
         {
-          SCIPaddCoefLinear(scipSP_, cons_flow_conservation_[cons_tuple], vars_X_[make_tuple(coil_i, coil_j, line_, mode_i, mode_j)], 1);
+          auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line_, mode_i, mode_j));
+          if (var_X == vars_X_.end())
+            continue;
+
+          SCIPaddCoefLinear(scipSP_, cons_flow_conservation_[cons_tuple], var_X->second, 1);
         }
       }
 
@@ -333,9 +356,13 @@ void SubProblem::Setup(shared_ptr<Instance> instance, ProductionLine line)
         if (instance_->IsStartCoil(coil_i))
           continue;
 
-        for (auto &mode_i : instance_->modes[make_tuple(coil_i, line_)])
+        for (auto &mode_i : instance_->GetModes(coil_i, line_))
         {
-          SCIPaddCoefLinear(scipSP_, cons_flow_conservation_[cons_tuple], vars_X_[make_tuple(coil_j, coil_i, line_, mode_j, mode_i)], -1);
+          auto var_X = vars_X_.find(make_tuple(coil_j, coil_i, line_, mode_j, mode_i));
+          if (var_X == vars_X_.end())
+            continue;
+
+          SCIPaddCoefLinear(scipSP_, cons_flow_conservation_[cons_tuple], var_X->second, -1);
         }
       }
 
@@ -346,96 +373,125 @@ void SubProblem::Setup(shared_ptr<Instance> instance, ProductionLine line)
   // (6) delay linking: link Z_i, S_i and X_..
   // skip non-regular coils
   // see compact model
-  for (auto &coil_i : instance_->regularCoils)
+  if (timing_formulation_ == Settings::TimingFormulation::kIndicator)
   {
-    SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "delay_linking_C%d", coil_i);
-
-    SCIPcreateConsBasicLinear(scipSP_,                      // scip
-                              &cons_delay_linking_[coil_i], // cons
-                              var_cons_name,                // name
-                              0,                            // nvar
-                              0,                            // vars
-                              0,                            // coeffs
-                              -SCIPinfinity(scipSP_),       // lhs
-                              0);                           // rhs
-
-    // add coefficients
-    // add S_i
-    SCIPaddCoefLinear(scipSP_, cons_delay_linking_[coil_i], vars_S_[coil_i], 1);
-
-    // other
-    // if coil_j is start coil, skip
-    for (auto &coil_j : instance_->coilsWithoutStartCoil)
+    CreateIndicatorDelayLinking();
+  }
+  else
+  {
+    for (auto &coil_i : instance_->regularCoils)
     {
-      for (auto &mode_j : instance_->modes[make_tuple(coil_j, line_)])
+      SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "delay_linking_C%d", coil_i);
+
+      SCIPcreateConsBasicLinear(scipSP_,                      // scip
+                                &cons_delay_linking_[coil_i], // cons
+                                var_cons_name,                // name
+                                0,                            // nvar
+                                0,                            // vars
+                                0,                            // coeffs
+                                -SCIPinfinity(scipSP_),       // lhs
+                                0);                           // rhs
+
+      // add coefficients
+      // add S_i
+      SCIPaddCoefLinear(scipSP_, cons_delay_linking_[coil_i], vars_S_[coil_i], 1);
+
+      // other
+      // if coil_j is start coil, skip
+      for (auto &coil_j : instance_->coilsWithoutStartCoil)
       {
-        for (auto &mode_i : instance_->modes[make_tuple(coil_i, line_)])
+        for (auto &mode_j : instance_->GetModes(coil_j, line_))
         {
-          auto processing_time = instance_->processingTimes[make_tuple(coil_i, line_, mode_i)];
+          for (auto &mode_i : instance_->GetModes(coil_i, line_))
+          {
+            auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line_, mode_i, mode_j));
+            if (var_X == vars_X_.end())
+              continue;
 
-          SCIPaddCoefLinear(scipSP_, cons_delay_linking_[coil_i], vars_X_[make_tuple(coil_i, coil_j, line_, mode_i, mode_j)], processing_time);
+            auto processing_time = instance_->GetProcessingTime(coil_i, line_, mode_i);
+
+            SCIPaddCoefLinear(scipSP_, cons_delay_linking_[coil_i], var_X->second, processing_time);
+          }
         }
       }
-    }
 
-    // RHS
-    // due date d_i
-    SCIPaddCoefLinear(scipSP_, cons_delay_linking_[coil_i], var_constant_one_, -instance_->dueDates[coil_i]);
+      // RHS
+      // due date d_i
+      SCIPaddCoefLinear(scipSP_, cons_delay_linking_[coil_i], var_constant_one_, -instance_->dueDates.at(coil_i));
 
-    // big M linearization
-    SCIP_Real big_M = instance_->bigM[line_];
-    SCIPaddCoefLinear(scipSP_, cons_delay_linking_[coil_i], vars_Z_[coil_i], -big_M);
+      // big M linearization, latest completion of coil_i minus its due date
+      SCIP_Real big_M = instance_->GetDelayBigM(coil_i, line_);
+      SCIPaddCoefLinear(scipSP_, cons_delay_linking_[coil_i], vars_Z_[coil_i], -big_M);
 
-    SCIPaddCons(scipSP_, cons_delay_linking_[coil_i]);
+      SCIPaddCons(scipSP_, cons_delay_linking_[coil_i]);
+    }
   }
 
   // (7) start time linking: link S_i and X_..
   // skip non-regular coils for both coil_i and coil_j
   // see compact model
-  for (auto &coil_i : instance_->regularCoils)
+  if (timing_formulation_ == Settings::TimingFormulation::kLazy)
   {
-    for (auto &coil_j : instance_->regularCoils)
+    // linking constraints are added by the constraint handler once an arc is selected
+    auto linkings = StartTimeLinkingConshdlr::CreateLinkings(instance_, vars_X_, vars_S_, {line_}, [this](Coil coil_i, Coil coil_j)
+                                                             { return instance_->GetStartTimeBigM(coil_i, coil_j, line_); });
+    SCIPincludeObjConshdlr(scipSP_, new StartTimeLinkingConshdlr(scipSP_, std::move(linkings)), TRUE);
+  }
+  else if (timing_formulation_ == Settings::TimingFormulation::kIndicator)
+  {
+    CreateIndicatorStartTimeLinking();
+  }
+  else
+  {
+    for (auto &coil_i : instance_->regularCoils)
     {
+      for (auto &coil_j : instance_->regularCoils)
+      {
 
-      auto con_tuple = make_tuple(coil_i, coil_j);
+        auto con_tuple = make_tuple(coil_i, coil_j);
 
-      SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "start_time_linking_CI%d_CJ%d", coil_i, coil_j);
+        SCIPsnprintf(var_cons_name, Settings::kSCIPMaxStringLength, "start_time_linking_CI%d_CJ%d", coil_i, coil_j);
 
-      SCIPcreateConsBasicLinear(scipSP_,                              // scip
-                                &cons_start_time_linking_[con_tuple], // cons
-                                var_cons_name,                        // name
-                                0,                                    // nvar
-                                0,                                    // vars
-                                0,                                    // coeffs
-                                -SCIPinfinity(scipSP_),               // lhs
-                                0);                                   // rhs
+        SCIPcreateConsBasicLinear(scipSP_,                              // scip
+                                  &cons_start_time_linking_[con_tuple], // cons
+                                  var_cons_name,                        // name
+                                  0,                                    // nvar
+                                  0,                                    // vars
+                                  0,                                    // coeffs
+                                  -SCIPinfinity(scipSP_),               // lhs
+                                  0);                                   // rhs
 
-      // add coefficients
-      // add S_i
-      SCIPaddCoefLinear(scipSP_, cons_start_time_linking_[con_tuple], vars_S_[coil_i], 1);
+        // add coefficients
+        // add S_i
+        SCIPaddCoefLinear(scipSP_, cons_start_time_linking_[con_tuple], vars_S_[coil_i], 1);
 
-      // add -S_j
-      SCIPaddCoefLinear(scipSP_, cons_start_time_linking_[con_tuple], vars_S_[coil_j], -1);
+        // add -S_j
+        SCIPaddCoefLinear(scipSP_, cons_start_time_linking_[con_tuple], vars_S_[coil_j], -1);
 
-      // add -M
-      SCIP_Real big_M = instance_->bigM[line_];
-      SCIPaddCoefLinear(scipSP_, cons_start_time_linking_[con_tuple], var_constant_one_, -big_M);
-      for (auto &mode_i : instance_->modes[make_tuple(coil_i, line_)])
-      {
-        for (auto &mode_j : instance_->modes[make_tuple(coil_j, line_)])
+        // add -M, latest start of coil_i minus earliest start of coil_j
+        SCIP_Real big_M = instance_->GetStartTimeBigM(coil_i, coil_j, line_);
+        SCIPaddCoefLinear(scipSP_, cons_start_time_linking_[con_tuple], var_constant_one_, -big_M);
+        for (auto &mode_i : instance_->GetModes(coil_i, line_))
         {
-          // (p_ikm+tijkmn)*X_ijkmn
-          auto processing_time = instance_->processingTimes[make_tuple(coil_i, line_, mode_i)];
-          auto setup_time = instance_->setupTimes[make_tuple(coil_i, mode_i, coil_j, mode_j, line_)];
-          SCIP_Real coefficient = processing_time + setup_time;
-
-          SCIPaddCoefLinear(scipSP_, cons_start_time_linking_[con_tuple], vars_X_[make_tuple(coil_i, coil_j, line_, mode_i, mode_j)], coefficient);
-
-          // M*X_ijkmn
-          SCIPaddCoefLinear(scipSP_, cons_start_time_linking_[con_tuple], vars_X_[make_tuple(coil_i, coil_j, line_, mode_i, mode_j)], big_M);
+          for (auto &mode_j : instance_->GetModes(coil_j, line_))
+          {
+            auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line_, mode_i, mode_j));
+            if (var_X == vars_X_.end())
+              continue;
+
+            // (p_ikm+tijkmn)*X_ijkmn
+            auto processing_time = instance_->GetProcessingTime(coil_i, line_, mode_i);
+            auto setup_time = instance_->GetSetupTime(coil_i, mode_i, coil_j, mode_j, line_);
+            SCIP_Real coefficient = processing_time + setup_time;
+
+            SCIPaddCoefLinear(scipSP_, cons_start_time_linking_[con_tuple], var_X->second, coefficient);
+
+            // M*X_ijkmn
+            SCIPaddCoefLinear(scipSP_, cons_start_time_linking_[con_tuple], var_X->second, big_M);
+          }
         }
+        SCIPaddCons(scipSP_, cons_start_time_linking_[con_tuple]);
       }
-      SCIPaddCons(scipSP_, cons_start_time_linking_[con_tuple]);
     }
   }
 
@@ -490,6 +546,105 @@ void SubProblem::Setup(shared_ptr<Instance> instance, ProductionLine line)
   //   SCIPaddCons(scipSP_, cons_delay_edge_linking_[coil_i]);
   // }
 }
+
+/**
+ * @brief Create delay linking constraints as indicator constraints: if coil_i is not delayed, it is completed until its
+ * due date, i.e.
+ * Z_i = 0 -> S_i + sum(coil_j, mode_i, mode_j, p_ikm * X_ijkmn) <= d_i
+ */
+void SubProblem::CreateIndicatorDelayLinking()
+{
+  char cons_name[Settings::kSCIPMaxStringLength];
+
+  for (auto &coil_i : instance_->regularCoils)
+  {
+    vector<SCIP_VAR *> vars = {vars_S_[coil_i]};
+    vector<SCIP_Real> coefficients = {1};
+
+    for (auto &coil_j : instance_->coilsWithoutStartCoil)
+    {
+      for (auto &mode_j : instance_->GetModes(coil_j, line_))
+      {
+        for (auto &mode_i : instance_->GetModes(coil_i, line_))
+        {
+          auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line_, mode_i, mode_j));
+          if (var_X == vars_X_.end())
+            continue;
+
+          vars.push_back(var_X->second);
+          coefficients.push_back(instance_->GetProcessingTime(coil_i, line_, mode_i));
+        }
+      }
+    }
+
+    // indicator is active if Z_i = 0
+    SCIP_VAR *not_delayed;
+    SCIPgetNegatedVar(scipSP_, vars_Z_[coil_i], &not_delayed);
+
+    SCIPsnprintf(cons_name, Settings::kSCIPMaxStringLength, "delay_linking_C%d", coil_i);
+
+    SCIP_CONS *cons;
+    SCIPcreateConsBasicIndicator(scipSP_,                       // scip
+                                 &cons,                         // cons
+                                 cons_name,                     // name
+                                 not_delayed,                   // binary indicator variable
+                                 vars.size(),                   // nvar
+                                 vars.data(),                   // vars
+                                 coefficients.data(),           // coeffs
+                                 instance_->dueDates.at(coil_i));  // rhs
+    SCIPaddCons(scipSP_, cons);
+    cons_indicator_.push_back(cons);
+  }
+}
+
+/**
+ * @brief Create start time linking constraints as indicator constraints: if an arc is selected, its successor starts
+ * after the processing and setup time, i.e. for every arc of regular coils
+ * X_ijkmn = 1 -> S_i - S_j <= -(p_ikm + t_ijkmn)
+ */
+void SubProblem::CreateIndicatorStartTimeLinking()
+{
+  char cons_name[Settings::kSCIPMaxStringLength];
+
+  for (auto &coil_i : instance_->regularCoils)
+  {
+    for (auto &coil_j : instance_->regularCoils)
+    {
+      // arcs of a coil to itself are fixed to 0
+      if (coil_i == coil_j)
+        continue;
+
+      for (auto &mode_i : instance_->GetModes(coil_i, line_))
+      {
+        for (auto &mode_j : instance_->GetModes(coil_j, line_))
+        {
+          auto var_X = vars_X_.find(make_tuple(coil_i, coil_j, line_, mode_i, mode_j));
+          if (var_X == vars_X_.end())
+            continue;
+
+          SCIP_VAR *vars[] = {vars_S_[coil_i], vars_S_[coil_j]};
+          SCIP_Real coefficients[] = {1, -1};
+          SCIP_Real duration = instance_->GetProcessingTime(coil_i, line_, mode_i) + instance_->GetSetupTime(coil_i, mode_i, coil_j, mode_j, line_);
+
+          SCIPsnprintf(cons_name, Settings::kSCIPMaxStringLength, "start_time_linking_CI%d_CJ%d_MI%d_MJ%d", coil_i, coil_j, mode_i, mode_j);
+
+          SCIP_CONS *cons;
+          SCIPcreateConsBasicIndicator(scipSP_,                                                  // scip
+                                       &cons,                                                    // cons
+                                       cons_name,                                                // name
+                                       var_X->second,                                            // binary indicator variable
+                                       2,                                                        // nvar
+                                       vars,                                                     // vars
+                                       coefficients,                                             // coeffs
+                                       -duration);                                               // rhs
+          SCIPaddCons(scipSP_, cons);
+          cons_indicator_.push_back(cons);
+        }
+      }
+    }
+  }
+}
+
 // destructor
 /**
  * @brief Destroy the Sub Problem object and release SCIP ressources
@@ -521,6 +676,11 @@ SubProblem::~SubProblem()
     SCIPreleaseCons(scipSP_, &cons);
   }
 
+  for (auto &cons : this->cons_indicator_)
+  {
+    SCIPreleaseCons(scipSP_, &cons);
+  }
+
   for (auto &[_, var] : this->vars_X_)
   {
     SCIPreleaseVar(scipSP_, &var);
@@ -624,7 +784,7 @@ void SubProblem::UpdateObjective(shared_ptr<DualValues> dual_values, const bool
       }
       else
       {
-        column_cost = instance_->stringerCosts[make_tuple(coil_i, mode_i, coil_j, mode_j, line)];
+        column_cost = instance_->GetStringerCost(coil_i, mode_i, coil_j, mode_j, line);
       }
 
       // if we are doing Farkas pricing, don't use column cost in objective at all
@@ -670,11 +830,17 @@ vector<shared_ptr<ProductionLineSchedule>> SubProblem::Solve()
   // set gap to specified dynamic gap
   this->SetGap(dynamic_gap_);
   
-  char model_name[Settings::kSCIPMaxStringLength];
-  (void)SCIPsnprintf(model_name, Settings::kSCIPMaxStringLength, "SubProblems/SubProblem_L%d_%d.lp", line_, iteration_);
+  if (write_model_files_)
+  {
+    char model_name[Settings::kSCIPMaxStringLength];
+    (void)SCIPsnprintf(model_name, Settings::kSCIPMaxStringLength, "SubProblems/SubProblem_L%d_%d.lp", line_, iteration_);
 
-  // write out to disk
-  SCIPwriteOrigProblem(scipSP_, model_name, "lp", FALSE);
+    // write out to disk
+    SCIPwriteOrigProblem(scipSP_, model_name, "lp", FALSE);
+  }
+
+  // start from routes of the previous round
+  AddWarmStartSolutions();
 
   // solve
   SCIPsolve(scipSP_);
@@ -740,12 +906,12 @@ vector<shared_ptr<ProductionLineSchedule>> SubProblem::Solve()
       // TODO: use SCIP epsilon methods here
       auto edge_selected = SCIPgetSolVal(scipSP_, scip_solution, var_X) > 0.5;
 
-      // set incidence of this edge corresponding to current variable
-      schedule->edges[tuple] = edge_selected;
+      // only selected edges are stored, so a schedule is as sparse as its column in the master problem
+      if (!edge_selected)
+        continue;
 
-      // add cost to schedule if edge is included, else don't
-      if (edge_selected)
-        schedule->schedule_cost += instance_->stringerCosts[make_tuple(coil_i, mode_i, coil_j, mode_j, line)];
+      schedule->edges[tuple] = true;
+      schedule->schedule_cost += instance_->GetStringerCost(coil_i, mode_i, coil_j, mode_j, line);
     }
 
     // restore delayedness
@@ -753,19 +919,151 @@ vector<shared_ptr<ProductionLineSchedule>> SubProblem::Solve()
     {
       auto coil_delayed = SCIPgetSolVal(scipSP_, scip_solution, var_Z) > 0.5; // TODO: use SCIP epsilon methods
 
-      schedule->delayedness[coil_i] = coil_delayed;
+      // only delayed coils are stored
+      if (coil_delayed)
+        schedule->delayedness[coil_i] = true;
     }
 
     // add solution to list
     schedules.push_back(schedule);
   }
 
+  // keep best routes for warm starting the next solve, solutions of SCIP are sorted by objective
+  if (!schedules.empty())
+  {
+    warm_start_routes_.assign(schedules.begin(), schedules.begin() + std::min(schedules.size(), Settings::kWarmStartSolutionsPerLine));
+  }
+
   // increment iteration counter
   iteration_++;
 
   return schedules;
 }
 
+/**
+ * @brief Sets the columns of this line that are active in the current master LP. They are injected as starting
+ * solutions of the next solves together with the best routes of the last solve.
+ *
+ * @param columns Columns of this line with positive LP value
+ */
+void SubProblem::SetWarmStartColumns(vector<shared_ptr<ProductionLineSchedule>> columns)
+{
+  warm_start_columns_ = std::move(columns);
+}
+
+/**
+ * @brief Injects the best routes of the last solve and the LP-active columns as starting solutions. SCIP checks them
+ * against the new objective, so only routes with negative reduced cost under the current duals are kept. Must be called
+ * while the problem is not transformed.
+ */
+void SubProblem::AddWarmStartSolutions()
+{
+  if (!Settings::kEnableWarmStart || Settings::kEnableReoptimization)
+    return;
+
+  if (SCIPgetStage(scipSP_) != SCIP_STAGE_PROBLEM)
+    return;
+
+  vector<const ProductionLineSchedule *> injected;
+  int accepted = 0;
+
+  for (auto *routes : {&warm_start_routes_, &warm_start_columns_})
+  {
+    for (auto &schedule : *routes)
+    {
+      // LP-active columns are often found again as routes, inject every route once
+      bool already_injected = std::any_of(injected.begin(), injected.end(), [&schedule](const ProductionLineSchedule *other)
+                                          { return other->edges == schedule->edges; });
+      if (already_injected)
+        continue;
+
+      injected.push_back(schedule.get());
+      if (AddWarmStartSolution(*schedule))
+        accepted++;
+    }
+  }
+
+  PHALS_LOG(kDebug) << "[Subproblem L" << line_ << "]: " << accepted << " of " << injected.size() << " warm start solutions stored" << endl;
+}
+
+/**
+ * @brief Builds a full solution of the subproblem from the edges of a route and adds it as starting solution. Start
+ * times are set to the earliest possible start of every coil along the route, delayed coils follow from these start
+ * times.
+ *
+ * @param schedule Route of this line, only selected edges are contained
+ * @return true If SCIP stored the solution
+ */
+bool SubProblem::AddWarmStartSolution(const ProductionLineSchedule &schedule)
+{
+  if (schedule.line != line_)
+    return false;
+
+  // successor and mode of every coil on the route
+  map<Coil, tuple<Coil, Mode, Mode>> successors;
+  for (auto &[tuple, incidence] : schedule.edges)
+  {
+    if (!incidence)
+      continue;
+
+    // edge must exist in this subproblem, e.g. trivial columns are not routes
+    if (vars_X_.count(tuple) == 0)
+      return false;
+
+    auto &[coil_i, coil_j, line, mode_i, mode_j] = tuple;
+    successors[coil_i] = make_tuple(coil_j, mode_i, mode_j);
+  }
+
+  SCIP_SOL *solution;
+  SCIPcreateSol(scipSP_, &solution, NULL);
+
+  SCIPsetSolVal(scipSP_, solution, var_constant_one_, 1);
+  for (auto &[tuple, incidence] : schedule.edges)
+  {
+    if (incidence)
+      SCIPsetSolVal(scipSP_, solution, vars_X_.at(tuple), 1);
+  }
+
+  // earliest start times along the route, first coil after the start coil starts at 0
+  SCIP_Real start_time = 0;
+  auto current = successors.find(instance_->startCoil);
+  size_t visited = 0;
+  while (current != successors.end() && visited < successors.size())
+  {
+    auto &[coil, mode, _] = current->second;
+    if (!instance_->IsRegularCoil(coil))
+      break;
+
+    // mode of coil is the mode of its outgoing edge
+    auto next = successors.find(coil);
+    if (next == successors.end())
+      break;
+
+    auto &[next_coil, coil_mode, next_mode] = next->second;
+
+    auto processing_time = instance_->processingTimes.find(make_tuple(coil, line_, coil_mode));
+    SCIP_Real finish_time = start_time + (processing_time != instance_->processingTimes.end() ? processing_time->second : 0);
+
+    SCIPsetSolVal(scipSP_, solution, vars_S_.at(coil), start_time);
+    if (SCIPisGT(scipSP_, finish_time, instance_->dueDates.at(coil)))
+    {
+      SCIPsetSolVal(scipSP_, solution, vars_Z_.at(coil), 1);
+    }
+
+    auto setup_time = instance_->setupTimes.find(make_tuple(coil, coil_mode, next_coil, next_mode, line_));
+    start_time = finish_time + (setup_time != instance_->setupTimes.end() ? setup_time->second : 0);
+
+    current = next;
+    visited++;
+  }
+
+  // solution is checked and freed by SCIP
+  SCIP_Bool stored = FALSE;
+  SCIPaddSolFree(scipSP_, &solution, &stored);
+
+  return stored;
+}
+
 /**
  * @brief Gets dual bound of subproblem
  * 
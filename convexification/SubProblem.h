@@ -9,7 +9,7 @@ class SubProblem
 {
 public:
     ~SubProblem();
-    void Setup(shared_ptr<Instance> instance, ProductionLine line);
+    void Setup(shared_ptr<Instance> instance, ProductionLine line, Settings::TimingFormulation timing_formulation = Settings::kDefaultTimingFormulation);
 
     void UpdateObjective(shared_ptr<DualValues> dual_values, const bool is_farkas);
     vector<shared_ptr<ProductionLineSchedule>> Solve();
@@ -26,7 +26,13 @@ public:
     SCIP_Real GetDualBound();
     bool IsDualBoundNegative();
 
+    // columns of this line that are active in the current master LP, injected as starting solutions
+    void SetWarmStartColumns(vector<shared_ptr<ProductionLineSchedule>> columns);
+
     double dynamic_gap_ = Settings::kDynamicGap;
+
+    // write the model of every solve to SubProblems/ for debugging
+    bool write_model_files_ = false;
     
     ProductionLine line_;
     SCIP *scipSP_;
@@ -48,7 +54,19 @@ private:
     map<tuple<Coil, Coil>, SCIP_CONS *> cons_start_time_linking_;
 
     SCIP_CONS* cons_max_delayed_coils_;
+
+    // timing constraints of the indicator formulation
+    Settings::TimingFormulation timing_formulation_;
+    vector<SCIP_CONS *> cons_indicator_;
+    void CreateIndicatorDelayLinking();
+    void CreateIndicatorStartTimeLinking();
     
+    // best routes of the last solve and LP-active columns, used as starting solutions of the next solve
+    vector<shared_ptr<ProductionLineSchedule>> warm_start_routes_;
+    vector<shared_ptr<ProductionLineSchedule>> warm_start_columns_;
+    void AddWarmStartSolutions();
+    bool AddWarmStartSolution(const ProductionLineSchedule &schedule);
+
     int iteration_ = 0;
     void CreateZVariable(Coil coil_i);
     void CreateSVariable(Coil coil_i);
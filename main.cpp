@@ -1,49 +1,104 @@
-#include "Instance.h"
-#include "compact/CompactModel.h"
-#include "convexification/Master.h"
-#include "convexification/Pricer.h"
+#include <fstream>
+
+#include "BatchRunner.h"
+#include "InstanceRun.h"
+#include "Logger.h"
+#include "SolverService.h"
+
+/**
+ * @brief Solves the instances of a manifest, see BatchRunner::ReadManifest
+ *
+ * @param argv --batch manifest [concurrency] [memory limit per instance in MB] [report path]
+ */
+int RunBatch(int argc, char *argv[])
+{
+    if (argc < 3)
+        throw std::invalid_argument("Missing manifest, expected --batch manifest [concurrency] [memory limit] [report]");
+
+    auto jobs = BatchRunner::ReadManifest(argv[2]);
+
+    // if a parameter is passed, this is used as number of concurrent jobs, else the default concurrency is used
+    auto concurrency = argc >= 4 ? stoul(argv[3]) : Settings::kDefaultBatchConcurrency;
+
+    // if a parameter is passed, this is used as memory limit of every job in megabytes
+    auto memory_limit = argc >= 5 ? stod(argv[4]) : Settings::kDefaultBatchMemoryLimit;
+
+    BatchRunner runner(concurrency, memory_limit);
+    runner.Run(jobs);
+
+    // if a parameter is passed, the report is written to this path, else to cout
+    if (argc >= 6)
+    {
+        std::ofstream report(argv[5]);
+        runner.WriteReport(report);
+    }
+    else
+    {
+        runner.WriteReport(cout);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Serves requests on a Unix domain socket until a shutdown request, see SolverService
+ *
+ * @param argv --serve socket [workers]
+ */
+int RunService(int argc, char *argv[])
+{
+    if (argc < 3)
+        throw std::invalid_argument("Missing socket path, expected --serve socket [workers]");
+
+    // if a parameter is passed, this is used as number of workers, else the default number of workers is used
+    auto workers = argc >= 4 ? stoul(argv[3]) : Settings::kDefaultServiceWorkers;
+
+    SolverService service(argv[2], workers);
+    service.Run();
+
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
+    if (argc >= 2 && string(argv[1]) == "--batch")
+        return RunBatch(argc, argv);
+    if (argc >= 2 && string(argv[1]) == "--serve")
+        return RunService(argc, argv);
+
+    RunOptions options;
+
     auto default_instance = "../data/Ins_8.cal";
 
     // if a parameter is passed, this is used as file path, else default_instance is used
-    auto instance_path = argc >= 2 ? argv[1] : default_instance; 
-    
-    auto instance = make_shared<Instance>();
-
-    // read instance
-    instance->read(instance_path);
+    options.instance_path = argc >= 2 ? argv[1] : default_instance;
 
     // if a parameter is passed, this is used as time limit in seconds, else default time limit is used
-    auto time_limit = argc >= 3 ? stod(argv[2]) : Settings::kDefaultTimeLimit;
-
-    // create compact model
-    auto compact_model = make_unique<CompactModel>(instance);
-
-    // solve and display solution
-    compact_model->Solve(time_limit);
-    compact_model->DisplaySolution();
-    
-    // create master problem
-    auto master_problem = make_shared<Master>(instance);
-
-    // create pricer for linking SubProblem and Master in B&P algo
-    MyPricer *pricer = new MyPricer(
-        master_problem,
-        "PHALS_exact_mip",                                                      // name of the pricer
-        "PHALS Pricer with convexification and braching on original variables", // short description of the pricer
-        0,                                                                      //
-        TRUE);                                                                  //
-
-    // include pricer in Master SCIP object
-    SCIPincludeObjPricer(master_problem->scipRMP_, //
-                         pricer,
-                         true);
-
-    // activate pricer
-    SCIPactivatePricer(master_problem->scipRMP_, SCIPfindPricer(master_problem->scipRMP_, pricer->pricer_name_));
-
-    
-    master_problem->Solve(time_limit);
-    master_problem->DisplaySolution();
-}
\ No newline at end of file
+    if (argc >= 3)
+        options.time_limit = stod(argv[2]);
+
+    // if a parameter is passed, this is used as formulation of the timing constraints in compact model and subproblems
+    if (argc >= 4)
+        options.timing_formulation = ParseTimingFormulation(argv[3]);
+
+    // if a parameter is passed, this is used as run mode, else the default run mode is used
+    if (argc >= 5)
+        options.run_mode = ParseRunMode(argv[4]);
+
+    // if a parameter is passed, the final schedule is exported to this path, as csv if it ends in .csv, else as json
+    if (argc >= 6)
+        options.export_path = argv[5];
+
+    // if parameters are passed, instances with more coils than the window size are solved by a rolling horizon with
+    // windows of this size overlapping by the given number of coils, see RollingHorizon
+    if (argc >= 7)
+        options.horizon_window_size = stoul(argv[6]);
+    if (argc >= 8)
+        options.horizon_overlap = stoul(argv[7]);
+
+    RunInstance(options);
+
+    // a single run is the only run of the process
+    PHALS_LOG(kInfo) << "Peak RSS " << PeakResidentSetSizeInMegabytes() << " MB" << endl;
+    Logger::Get().Flush();
+}
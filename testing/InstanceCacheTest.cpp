@@ -0,0 +1,102 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "../Instance.h"
+#include "../InstanceCache.h"
+#include "../Logger.h"
+#include "../MappedFile.h"
+#include "../Settings.h"
+
+/**
+ * @brief Checks that a cached instance loads with every field it was written with, and that a cache whose source
+ * checksum was corrupted or that belongs to another source is rejected
+ *
+ * Usage: InstanceCacheTest instance_file
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: InstanceCacheTest instance_file" << endl;
+        return 2;
+    }
+
+    // everything Instance::read derives from the text file, without loading an existing cache
+    Instance written;
+    written.parse(argv[1]);
+    if (Settings::kEnablePreprocessing)
+        written.Preprocess();
+    written.ComputeBigM();
+
+    uint64_t source_size;
+    uint64_t source_checksum;
+    {
+        MappedFile source(argv[1]);
+        source_size = source.size();
+        source_checksum = InstanceCache::Checksum(source.begin(), source.size());
+    }
+
+    // written to the working directory, i.e. the build directory under ctest
+    string cache_path = "InstanceCacheTest.bin";
+    string corrupted_path = "InstanceCacheTest.corrupted.bin";
+
+    int failures = 0;
+    auto check = [&](const string &name, bool passed)
+    {
+        if (passed)
+        {
+            cout << "ok " << name << endl;
+        }
+        else
+        {
+            cerr << "FAIL " << name << endl;
+            failures++;
+        }
+    };
+
+    check("write cache", InstanceCache::Write(cache_path, written, source_size, source_checksum));
+
+    Instance loaded;
+    check("load cache", InstanceCache::Load(cache_path, loaded, source_size, source_checksum));
+    check("round trip of scalars", loaded.numberOfCoils == written.numberOfCoils && loaded.numberOfModes == written.numberOfModes &&
+                                       loaded.numberOfProductionLines == written.numberOfProductionLines &&
+                                       loaded.maximumDelayedCoils == written.maximumDelayedCoils &&
+                                       loaded.startCoil == written.startCoil && loaded.endCoil == written.endCoil);
+    check("round trip of comments", loaded.comments == written.comments);
+    check("round trip of coil sets", loaded.coils == written.coils && loaded.regularCoils == written.regularCoils &&
+                                         loaded.coilsWithoutStartCoil == written.coilsWithoutStartCoil &&
+                                         loaded.coilsWithoutEndCoil == written.coilsWithoutEndCoil);
+    check("round trip of lines and modes", loaded.productionLines == written.productionLines && loaded.allModes == written.allModes &&
+                                               loaded.modes == written.modes);
+    check("round trip of due dates and processing times", loaded.dueDates == written.dueDates && loaded.processingTimes == written.processingTimes);
+    check("round trip of setup times and stringer costs", loaded.setupTimes == written.setupTimes && loaded.stringerCosts == written.stringerCosts &&
+                                                              loaded.stringerNeeded == written.stringerNeeded);
+    check("round trip of preprocessing", loaded.eliminatedArcs == written.eliminatedArcs && loaded.removedModes == written.removedModes &&
+                                             loaded.numberOfModesAfterPreprocessing == written.numberOfModesAfterPreprocessing &&
+                                             loaded.numberOfArcsAfterPreprocessing == written.numberOfArcsAfterPreprocessing);
+    check("round trip of big M values", loaded.bigM == written.bigM && loaded.startTimeUpperBound == written.startTimeUpperBound &&
+                                            loaded.delayBigM == written.delayBigM);
+
+    Instance other_source;
+    check("reject cache of another source", !InstanceCache::Load(cache_path, other_source, source_size, source_checksum + 1));
+
+    // flip a bit of the source checksum stored in the header, it follows magic, version, settings and source size
+    {
+        ifstream cache(cache_path, std::ios::binary);
+        string content((std::istreambuf_iterator<char>(cache)), std::istreambuf_iterator<char>());
+        content[8 + 4 + 4 + 8] ^= 1;
+        ofstream corrupted(corrupted_path, std::ios::binary);
+        corrupted << content;
+    }
+    Instance corrupted;
+    check("reject cache with corrupted checksum", !InstanceCache::Load(corrupted_path, corrupted, source_size, source_checksum));
+
+    std::remove(cache_path.c_str());
+    std::remove(corrupted_path.c_str());
+
+    Logger::Get().Flush();
+    return failures == 0 ? 0 : 1;
+}
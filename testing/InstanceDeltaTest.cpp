@@ -0,0 +1,175 @@
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "../Instance.h"
+#include "../InstanceDelta.h"
+#include "../Logger.h"
+#include "../Settings.h"
+
+/**
+ * @brief Checks that incomplete or inconsistent deltas are rejected and leave the instance unchanged, while a complete
+ * delta is applied and its repair of a previous result drops the removed coils and places the added coil
+ *
+ * Usage: InstanceDeltaTest instance_file
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: InstanceDeltaTest instance_file" << endl;
+        return 2;
+    }
+
+    // everything Instance::read derives from the text file, without writing a cache next to it
+    Instance instance;
+    instance.parse(argv[1]);
+    if (Settings::kEnablePreprocessing)
+        instance.Preprocess();
+    instance.ComputeBigM();
+    instance.DetectIdenticalLines();
+    auto added_coil = instance.endCoil;
+    auto number_of_coils = instance.regularCoils.size();
+
+    int failures = 0;
+    // written to the working directory, i.e. the build directory under ctest
+    string delta_path = "InstanceDeltaTest.delta";
+
+    // reads and applies a delta file, returns the error or an empty string
+    auto apply = [&](const string &content, Instance &target, InstanceDelta &delta)
+    {
+        {
+            ofstream file(delta_path);
+            file << content;
+        }
+
+        string error;
+        try
+        {
+            delta.Read(delta_path);
+            target.ApplyDelta(delta);
+        }
+        catch (const std::exception &exception)
+        {
+            error = exception.what();
+        }
+        std::remove(delta_path.c_str());
+        return error;
+    };
+
+    auto expect_rejected = [&](const string &name, const string &content)
+    {
+        auto copy = instance;
+        InstanceDelta delta;
+        auto error = apply(content, copy, delta);
+        if (error.empty())
+        {
+            cerr << "FAIL " << name << ": delta was accepted" << endl;
+            failures++;
+        }
+        else if (copy.regularCoils.size() != number_of_coils || copy.endCoil != instance.endCoil)
+        {
+            cerr << "FAIL " << name << ": instance was changed by a rejected delta" << endl;
+            failures++;
+        }
+        else
+        {
+            cout << "ok " << name << ": " << error << endl;
+        }
+    };
+
+    auto coil = std::to_string(added_coil);
+    auto complete_coil = "n " + coil + "\nm " + coil + " 0 0\np " + coil + " 0 0 3\n";
+
+    expect_rejected("added coil without due date", complete_coil);
+    expect_rejected("added coil without mode", "n " + coil + "\nd " + coil + " 10\n");
+    expect_rejected("added mode without processing time", "n " + coil + "\nd " + coil + " 10\nm " + coil + " 0 0\n");
+    expect_rejected("modes of a coil that is not added", "m 0 0 1\np 0 0 1 3\n");
+    expect_rejected("due date of an unknown coil", "d " + std::to_string(added_coil + 5) + " 10\n");
+    expect_rejected("removal of an unknown coil", "r " + std::to_string(added_coil + 5) + "\n");
+    expect_rejected("setup time of an unknown coil", "t 0 " + std::to_string(added_coil + 5) + " 0 0 0 1\n");
+    expect_rejected("added coil numbered before the end coil", "n 0\nd 0 10\nm 0 0 0\np 0 0 0 3\n");
+
+    auto changed = instance;
+    InstanceDelta complete_delta;
+    auto error = apply(complete_coil + "d " + coil + " 10\nt " + coil + " end 0 0 0 1\n", changed, complete_delta);
+    if (!error.empty() || changed.regularCoils.size() != number_of_coils + 1 || changed.dueDates.at(added_coil) != 10 ||
+        changed.GetProcessingTime(added_coil, 0, 0) != 3)
+    {
+        cerr << "FAIL complete delta: " << (error.empty() ? "coil not added as given" : error) << endl;
+        failures++;
+    }
+    else
+    {
+        cout << "ok complete delta" << endl;
+    }
+
+    // previous result: every coil on the first line it can be produced on, and one column per line of the same sequences
+    RunResult previous;
+    for (auto &line : instance.productionLines)
+    {
+        previous.solution.sequences[line];
+    }
+    for (auto &regular_coil : instance.regularCoils)
+    {
+        for (auto &line : instance.productionLines)
+        {
+            if (instance.GetModes(regular_coil, line).empty())
+                continue;
+
+            previous.solution.sequences[line].push_back(make_tuple(regular_coil, instance.GetModes(regular_coil, line).front()));
+            break;
+        }
+    }
+    previous.has_solution = true;
+    for (auto &[line, sequence] : previous.solution.sequences)
+    {
+        previous.columns.emplace_back(line, sequence);
+    }
+
+    // the added coil is due late, so no arc to or from it is eliminated for its due date
+    auto removed_coil = instance.regularCoils.front();
+    auto repaired_instance = instance;
+    InstanceDelta repair_delta;
+    error = apply(complete_coil + "d " + coil + " 100000\nr " + std::to_string(removed_coil) + "\n", repaired_instance, repair_delta);
+    auto repaired = error.empty() ? repair_delta.Repair(previous, repaired_instance) : RunResult();
+
+    // every regular coil of the changed instance exactly once in the incumbent, no removed coil in any column
+    map<Coil, int> occurrences;
+    for (auto &[line, sequence] : repaired.solution.sequences)
+    {
+        for (auto &[placed_coil, mode] : sequence)
+        {
+            occurrences[placed_coil]++;
+        }
+    }
+    bool columns_without_removed_coil = true;
+    for (auto &[line, sequence] : repaired.columns)
+    {
+        for (auto &[column_coil, mode] : sequence)
+        {
+            columns_without_removed_coil = columns_without_removed_coil && column_coil != removed_coil;
+        }
+    }
+    bool every_coil_once = occurrences.size() == repaired_instance.regularCoils.size();
+    for (auto &regular_coil : repaired_instance.regularCoils)
+    {
+        every_coil_once = every_coil_once && occurrences[regular_coil] == 1;
+    }
+
+    if (!error.empty() || !repaired.has_solution || occurrences.count(removed_coil) > 0 || occurrences[added_coil] != 1 ||
+        !columns_without_removed_coil || repaired.columns.size() != previous.columns.size() || !every_coil_once)
+    {
+        cerr << "FAIL repair: " << (error.empty() ? "incumbent or columns not repaired as expected" : error) << endl;
+        failures++;
+    }
+    else
+    {
+        cout << "ok repair" << endl;
+    }
+
+    Logger::Get().Flush();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "../Instance.h"
+
+/**
+ * @brief Parameters of a generated instance, defaults follow the profile of Ins_20 to Ins_50
+ */
+struct GeneratorParameters
+{
+    int coils = 100;
+    int lines = 3;
+    // mode m stands for width class m / thickness_classes and thickness class m % thickness_classes
+    int width_classes = 6;
+    int thickness_classes = 11;
+    // modes of a coil come in groups of consecutive thickness classes of one width class sharing one processing time
+    int mode_group_size = 3;
+    // probability that a coil has a second mode group in the next width class
+    double second_mode_group_probability = 0.58;
+    // number of lines every coil can be produced on
+    int lines_per_coil = 2;
+
+    double min_processing_time = 7.8;
+    double max_processing_time = 32.5;
+
+    // due dates are drawn uniformly from [min, max] * horizon * tightness, smaller tightness gives later coils
+    double min_due_date_factor = 0.3;
+    double max_due_date_factor = 1.15;
+    double due_date_tightness = 1.0;
+
+    // alpha as share of the number of coils
+    double delayed_coils_ratio = 0.24;
+
+    SetupTime setup_time = 3;
+    StringerCosts stringer_cost = 1;
+    // probability that two coils are compatible, transitions of compatible coils between neighboring width and thickness
+    // classes need no stringer, every other transition does
+    double compatible_coils_probability = 0.056;
+
+    uint64_t seed = 1;
+    string output;
+};
+
+/**
+ * @brief Random numbers that are identical on every platform for the same seed, unlike the distributions of <random>
+ */
+class Random
+{
+public:
+    explicit Random(uint64_t seed) : engine_(seed) {}
+
+    // uniform in [0, 1)
+    double Uniform() { return (engine_() >> 11) * 0x1.0p-53; }
+
+    double Uniform(double min, double max) { return min + (max - min) * Uniform(); }
+
+    // uniform integer in [0, bound)
+    int Below(int bound) { return static_cast<int>(Uniform() * bound); }
+
+    bool Bernoulli(double probability) { return Uniform() < probability; }
+
+private:
+    std::mt19937_64 engine_;
+};
+
+/**
+ * @brief Generates a random instance
+ */
+Instance Generate(const GeneratorParameters &parameters)
+{
+    Random random(parameters.seed);
+    Instance instance;
+
+    int number_of_modes = parameters.width_classes * parameters.thickness_classes;
+    instance.comments = {"Instance name: Ins_" + std::to_string(parameters.coils),
+                         "Instance with " + std::to_string(parameters.coils) + " coils, " + std::to_string(parameters.lines) + " lines, and " + std::to_string(number_of_modes) + " modi",
+                         "Generated by InstanceGenerator with seed " + std::to_string(parameters.seed)};
+
+    instance.numberOfCoils = parameters.coils;
+    instance.numberOfProductionLines = parameters.lines;
+    instance.numberOfModes = number_of_modes;
+
+    instance.regularCoils.resize(parameters.coils);
+    std::iota(instance.regularCoils.begin(), instance.regularCoils.end(), 0);
+    instance.productionLines.resize(parameters.lines);
+    std::iota(instance.productionLines.begin(), instance.productionLines.end(), 0);
+
+    int lines_per_coil = std::clamp(parameters.lines_per_coil, 1, parameters.lines);
+    int group_size = std::clamp(parameters.mode_group_size, 1, parameters.thickness_classes);
+
+    // modes and processing times
+    double total_processing_time = 0;
+    for (auto &coil : instance.regularCoils)
+    {
+        // lines of this coil
+        vector<ProductionLine> lines = instance.productionLines;
+        for (int i = 0; i < lines_per_coil; i++)
+        {
+            std::swap(lines[i], lines[i + random.Below(lines.size() - i)]);
+        }
+        lines.resize(lines_per_coil);
+        std::sort(lines.begin(), lines.end());
+
+        // mode groups of this coil, processing times are the same on all of its lines
+        bool second_group = parameters.width_classes > 1 && random.Bernoulli(parameters.second_mode_group_probability);
+        int width = random.Below(parameters.width_classes - (second_group ? 1 : 0));
+        int thickness = random.Below(parameters.thickness_classes - group_size + 1);
+        ProcessingTime time = random.Uniform(parameters.min_processing_time, parameters.max_processing_time);
+
+        vector<pair<Mode, ProcessingTime>> groups = {{width * parameters.thickness_classes + thickness, std::round(time * 1000) / 1000}};
+        if (second_group)
+        {
+            // the next wider class is processed slightly faster
+            groups.emplace_back((width + 1) * parameters.thickness_classes + thickness, std::round(time * random.Uniform(0.95, 0.99) * 1000) / 1000);
+        }
+
+        double coil_processing_time = 0;
+        for (auto &line : lines)
+        {
+            auto &coil_modes = instance.modes[make_tuple(coil, line)];
+            for (auto &[first_mode, time] : groups)
+            {
+                for (Mode mode = first_mode; mode < first_mode + group_size; mode++)
+                {
+                    coil_modes.push_back(mode);
+                    instance.processingTimes[make_tuple(coil, line, mode)] = time;
+                }
+            }
+        }
+
+        for (auto &[first_mode, time] : groups)
+        {
+            coil_processing_time += time / groups.size();
+        }
+        total_processing_time += coil_processing_time + parameters.setup_time;
+    }
+
+    // due dates relative to the time needed to produce every coil on evenly loaded lines
+    double horizon = total_processing_time / parameters.lines * parameters.due_date_tightness;
+    for (auto &coil : instance.regularCoils)
+    {
+        instance.dueDates[coil] = std::max(1, (int)std::lround(random.Uniform(parameters.min_due_date_factor, parameters.max_due_date_factor) * horizon));
+    }
+
+    instance.maximumDelayedCoils = (int)std::lround(parameters.delayed_coils_ratio * parameters.coils);
+
+    // compatibility of coil pairs is symmetric and the same on every line
+    vector<vector<bool>> compatible(parameters.coils, vector<bool>(parameters.coils, false));
+    for (int coil_i = 0; coil_i < parameters.coils; coil_i++)
+    {
+        for (int coil_j = coil_i + 1; coil_j < parameters.coils; coil_j++)
+        {
+            compatible[coil_i][coil_j] = compatible[coil_j][coil_i] = random.Bernoulli(parameters.compatible_coils_probability);
+        }
+    }
+
+    auto neighboring_modes = [&parameters](Mode mode_i, Mode mode_j)
+    {
+        return std::abs(mode_i / parameters.thickness_classes - mode_j / parameters.thickness_classes) <= 1 &&
+               std::abs(mode_i % parameters.thickness_classes - mode_j % parameters.thickness_classes) <= 1;
+    };
+
+    // transitions
+    for (auto &line : instance.productionLines)
+    {
+        for (auto &coil_i : instance.regularCoils)
+        {
+            for (auto &coil_j : instance.regularCoils)
+            {
+                if (coil_i == coil_j)
+                    continue;
+
+                for (auto &mode_i : instance.GetModes(coil_i, line))
+                {
+                    for (auto &mode_j : instance.GetModes(coil_j, line))
+                    {
+                        if (compatible[coil_i][coil_j] && neighboring_modes(mode_i, mode_j))
+                            continue;
+
+                        auto tuple = make_tuple(coil_i, mode_i, coil_j, mode_j, line);
+                        instance.stringerNeeded[tuple] = true;
+                        instance.stringerCosts[tuple] = parameters.stringer_cost;
+                        instance.setupTimes[tuple] = parameters.setup_time;
+                    }
+                }
+            }
+        }
+    }
+
+    return instance;
+}
+
+/**
+ * @brief Generates a seeded random instance in the .cal format
+ *
+ * Usage: InstanceGenerator --coils I [--lines K] [--seed S] [--output file] [further options]
+ * The instance is written to standard output if no output file is given.
+ */
+int main(int argc, char *argv[])
+{
+    GeneratorParameters parameters;
+
+    map<string, std::function<void(const string &)>> options = {
+        {"--coils", [&](const string &value) { parameters.coils = std::stoi(value); }},
+        {"--lines", [&](const string &value) { parameters.lines = std::stoi(value); }},
+        {"--width-classes", [&](const string &value) { parameters.width_classes = std::stoi(value); }},
+        {"--thickness-classes", [&](const string &value) { parameters.thickness_classes = std::stoi(value); }},
+        {"--mode-group-size", [&](const string &value) { parameters.mode_group_size = std::stoi(value); }},
+        {"--second-mode-group-probability", [&](const string &value) { parameters.second_mode_group_probability = std::stod(value); }},
+        {"--lines-per-coil", [&](const string &value) { parameters.lines_per_coil = std::stoi(value); }},
+        {"--min-processing-time", [&](const string &value) { parameters.min_processing_time = std::stod(value); }},
+        {"--max-processing-time", [&](const string &value) { parameters.max_processing_time = std::stod(value); }},
+        {"--min-due-date-factor", [&](const string &value) { parameters.min_due_date_factor = std::stod(value); }},
+        {"--max-due-date-factor", [&](const string &value) { parameters.max_due_date_factor = std::stod(value); }},
+        {"--due-date-tightness", [&](const string &value) { parameters.due_date_tightness = std::stod(value); }},
+        {"--delayed-coils-ratio", [&](const string &value) { parameters.delayed_coils_ratio = std::stod(value); }},
+        {"--setup-time", [&](const string &value) { parameters.setup_time = std::stoi(value); }},
+        {"--stringer-cost", [&](const string &value) { parameters.stringer_cost = std::stoi(value); }},
+        {"--compatible-coils-probability", [&](const string &value) { parameters.compatible_coils_probability = std::stod(value); }},
+        {"--seed", [&](const string &value) { parameters.seed = std::stoull(value); }},
+        {"--output", [&](const string &value) { parameters.output = value; }},
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        auto option = options.find(argv[i]);
+        if (option == options.end() || i + 1 >= argc)
+        {
+            cerr << "Unknown option or missing value: " << argv[i] << endl;
+            cerr << "Options:";
+            for (auto &[name, _] : options)
+            {
+                cerr << " " << name;
+            }
+            cerr << endl;
+            return 1;
+        }
+        option->second(argv[++i]);
+    }
+
+    if (parameters.coils < 1 || parameters.lines < 1 || parameters.width_classes < 1 || parameters.thickness_classes < 1)
+    {
+        cerr << "Coils, lines, width and thickness classes must be positive" << endl;
+        return 1;
+    }
+
+    auto instance = Generate(parameters);
+
+    if (parameters.output.empty())
+    {
+        instance.printStructured(cout);
+        return 0;
+    }
+
+    ofstream file(parameters.output);
+    if (!file)
+    {
+        cerr << "Cannot write file " << parameters.output << endl;
+        return 1;
+    }
+    instance.printStructured(file);
+    return file ? 0 : 1;
+}
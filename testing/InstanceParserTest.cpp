@@ -0,0 +1,191 @@
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+
+#include "../Instance.h"
+#include "../Logger.h"
+
+/**
+ * @brief Reference parser: the istream based reader Instance::parse replaced, without preprocessing. Unlike the
+ * original, the M record does not fall through into the K record.
+ */
+static void ParseReference(const string &path, Instance &instance)
+{
+    ifstream file(path);
+    if (!file)
+        throw std::runtime_error("Cannot read file " + path);
+
+    string line;
+    while (getline(file, line))
+    {
+        if (line.empty())
+            continue;
+
+        istringstream ss(line);
+        char key;
+        ss >> key;
+
+        switch (key)
+        {
+        case 'X':
+        {
+            string comment;
+            getline(ss, comment);
+            comment.erase(0, 1);
+            instance.comments.push_back(comment);
+            break;
+        }
+        case 'I':
+        {
+            ss >> instance.numberOfCoils;
+            for (auto coil_set : {&instance.coils, &instance.regularCoils, &instance.coilsWithoutStartCoil, &instance.coilsWithoutEndCoil})
+            {
+                coil_set->resize(instance.numberOfCoils);
+                std::iota(coil_set->begin(), coil_set->end(), 0);
+            }
+
+            instance.startCoil = -1;
+            instance.endCoil = instance.numberOfCoils;
+            instance.coils.push_back(instance.startCoil);
+            instance.coilsWithoutEndCoil.push_back(instance.startCoil);
+            instance.coils.push_back(instance.endCoil);
+            instance.coilsWithoutStartCoil.push_back(instance.endCoil);
+            break;
+        }
+        case 'M':
+        {
+            ss >> instance.numberOfModes;
+            instance.allModes.resize(instance.numberOfModes);
+            std::iota(instance.allModes.begin(), instance.allModes.end(), 0);
+            break;
+        }
+        case 'K':
+        {
+            ss >> instance.numberOfProductionLines;
+            instance.productionLines.resize(instance.numberOfProductionLines);
+            std::iota(instance.productionLines.begin(), instance.productionLines.end(), 0);
+            break;
+        }
+        case 'a':
+        {
+            ss >> instance.maximumDelayedCoils;
+            break;
+        }
+        case 'm':
+        {
+            Coil coil;
+            ProductionLine production_line;
+            Mode mode;
+            bool enabled;
+            ss >> coil >> production_line >> mode >> enabled;
+            if (enabled)
+                instance.modes[make_tuple(coil, production_line)].push_back(mode);
+            break;
+        }
+        case 'd':
+        {
+            Coil coil;
+            ss >> coil;
+            ss >> instance.dueDates[coil];
+            break;
+        }
+        case 'p':
+        {
+            Coil coil;
+            ProductionLine production_line;
+            Mode mode;
+            ss >> coil >> production_line >> mode;
+            ss >> instance.processingTimes[make_tuple(coil, production_line, mode)];
+            break;
+        }
+        case 't':
+        case 'c':
+        {
+            Coil coil_1, coil_2;
+            ProductionLine production_line;
+            Mode mode_1, mode_2;
+            ss >> coil_1 >> coil_2 >> production_line >> mode_1 >> mode_2;
+
+            auto arc = make_tuple(coil_1, mode_1, coil_2, mode_2, production_line);
+            if (key == 't')
+            {
+                ss >> instance.setupTimes[arc];
+            }
+            else
+            {
+                ss >> instance.stringerCosts[arc];
+                instance.stringerNeeded[arc] = true;
+            }
+            break;
+        }
+        }
+    }
+
+    for (auto &production_line : instance.productionLines)
+    {
+        instance.modes[make_tuple(instance.startCoil, production_line)] = {0};
+        instance.modes[make_tuple(instance.endCoil, production_line)] = {0};
+    }
+}
+
+/**
+ * @brief Checks that Instance::parse reads every field of the given instance files like the reference parser
+ *
+ * Usage: InstanceParserTest instance_file...
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: InstanceParserTest instance_file..." << endl;
+        return 2;
+    }
+
+    int failures = 0;
+    for (int argument = 1; argument < argc; argument++)
+    {
+        string path = argv[argument];
+        Instance parsed, reference;
+        parsed.parse(path);
+        ParseReference(path, reference);
+
+        int file_failures = 0;
+        auto compare = [&](const char *field, bool equal)
+        {
+            if (!equal)
+            {
+                cerr << "FAIL " << path << ": " << field << " differs from the reference parser" << endl;
+                file_failures++;
+            }
+        };
+
+        compare("comments", parsed.comments == reference.comments);
+        compare("numberOfCoils", parsed.numberOfCoils == reference.numberOfCoils);
+        compare("numberOfModes", parsed.numberOfModes == reference.numberOfModes);
+        compare("numberOfProductionLines", parsed.numberOfProductionLines == reference.numberOfProductionLines);
+        compare("maximumDelayedCoils", parsed.maximumDelayedCoils == reference.maximumDelayedCoils);
+        compare("startCoil", parsed.startCoil == reference.startCoil);
+        compare("endCoil", parsed.endCoil == reference.endCoil);
+        compare("coils", parsed.coils == reference.coils);
+        compare("regularCoils", parsed.regularCoils == reference.regularCoils);
+        compare("coilsWithoutStartCoil", parsed.coilsWithoutStartCoil == reference.coilsWithoutStartCoil);
+        compare("coilsWithoutEndCoil", parsed.coilsWithoutEndCoil == reference.coilsWithoutEndCoil);
+        compare("productionLines", parsed.productionLines == reference.productionLines);
+        compare("allModes", parsed.allModes == reference.allModes);
+        compare("modes", parsed.modes == reference.modes);
+        compare("dueDates", parsed.dueDates == reference.dueDates);
+        compare("processingTimes", parsed.processingTimes == reference.processingTimes);
+        compare("setupTimes", parsed.setupTimes == reference.setupTimes);
+        compare("stringerCosts", parsed.stringerCosts == reference.stringerCosts);
+        compare("stringerNeeded", parsed.stringerNeeded == reference.stringerNeeded);
+
+        if (file_failures == 0)
+            cout << "ok " << path << ": " << parsed.regularCoils.size() << " coils, " << parsed.setupTimes.size() << " setup times" << endl;
+        failures += file_failures;
+    }
+
+    Logger::Get().Flush();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../Instance.h"
+#include "../Logger.h"
+#include "../SequenceSolution.h"
+#include "../Settings.h"
+#include "../compact/CompactModel.h"
+
+/**
+ * @brief Checks that the compact model accepts a solution whose identical lines are not in the order of its line
+ * symmetry breaking, and whose first produced coil on a line is not the smallest coil of the line
+ *
+ * Usage: LineSymmetryTest instance_file
+ * The instance needs two identical lines that can produce every coil and enough delayed coils for any sequence,
+ * e.g. InstanceGenerator --coils 8 --lines 2 --lines-per-coil 2 --delayed-coils-ratio 1
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        cerr << "Usage: LineSymmetryTest instance_file" << endl;
+        return 2;
+    }
+
+    // without preprocessing, every arc of the sequences below is a variable of the model
+    auto instance = make_shared<Instance>();
+    instance->parse(argv[1]);
+    instance->ComputeBigM();
+    instance->DetectIdenticalLines();
+
+    if (!Settings::kBreakLineSymmetry)
+    {
+        cout << "ok line symmetry breaking is disabled" << endl;
+        return 0;
+    }
+
+    vector<ProductionLine> lines;
+    for (auto &[_, identical_lines] : instance->identicalLines)
+    {
+        if (identical_lines.size() >= 2)
+            lines = identical_lines;
+    }
+    auto &coils = instance->regularCoils;
+    if (lines.size() != 2 || instance->productionLines.size() != 2 || coils.size() < 6)
+    {
+        cerr << "FAIL instance needs two identical lines and at least 6 coils" << endl;
+        return 2;
+    }
+
+    // the first line starts with coils[3] but contains coils[0], the second line starts with coils[1]. Ordered by the
+    // first produced coil, coils[0] would be produced on the second line before any coil on the first one.
+    SequenceSolution solution;
+    auto append = [&](ProductionLine line, Coil coil)
+    {
+        solution.sequences[line].push_back(make_tuple(coil, instance->GetModes(coil, line).front()));
+    };
+    append(lines[1], coils[3]);
+    append(lines[1], coils[0]);
+    append(lines[0], coils[1]);
+    append(lines[0], coils[2]);
+    for (size_t position = 4; position < coils.size(); position++)
+    {
+        append(lines[position % 2], coils[position]);
+    }
+    solution.ComputeTiming(*instance);
+    solution.ComputeCost(*instance);
+
+    CompactModel model(instance);
+    auto result = model.ImportSolution(solution, nullptr);
+
+    Logger::Get().Flush();
+    if (result != SCIP_FOUNDSOL)
+    {
+        cerr << "FAIL solution with identical lines in another order was rejected" << endl;
+        return 1;
+    }
+
+    cout << "ok solution with identical lines in another order was accepted" << endl;
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "../Instance.h"
+#include "../Logger.h"
+
+/**
+ * @brief Measures the throughput of the instance parser
+ *
+ * Usage: ParserBenchmark [instance file] [repetitions]
+ * Reports the throughput of parsing only and of reading, which loads the instance cache once it was written by the
+ * first read, see InstanceCache.
+ */
+int main(int argc, char *argv[])
+{
+    string instance_path = argc >= 2 ? argv[1] : "../data/Ins_50.cal";
+    int repetitions = argc >= 3 ? std::stoi(argv[2]) : 20;
+
+    ifstream file(instance_path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        cerr << "Cannot read file " << instance_path << endl;
+        return 1;
+    }
+    double megabytes = file.tellg() / (1024.0 * 1024.0);
+
+    auto measure = [&](auto &&load)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int repetition = 0; repetition < repetitions; repetition++)
+        {
+            Instance instance;
+            load(instance);
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repetitions;
+    };
+
+    auto parse_time = measure([&](Instance &instance)
+                              { instance.parse(instance_path); });
+    auto read_time = measure([&](Instance &instance)
+                             { instance.read(instance_path); });
+
+    // preprocessing statistics are logged by every read
+    Logger::Get().Flush();
+
+    cout << "Instance " << instance_path << " (" << megabytes << " MB), " << repetitions << " repetitions" << endl;
+    cout << "parse: " << parse_time * 1000 << " ms, " << megabytes / parse_time << " MB/s" << endl;
+    cout << "read:  " << read_time * 1000 << " ms, " << megabytes / read_time << " MB/s" << endl;
+
+    return 0;
+}
@@ -0,0 +1,14 @@
+# generates the synthetic scaling instances Ins_100 to Ins_500 into data/, run from the testing directory after
+# building the InstanceGenerator target in build/
+# generation is seeded, thus every run produces the same files
+GENERATOR=../build/InstanceGenerator
+
+for COILS in 100 200 300 400 500
+do
+    $GENERATOR --coils $COILS --seed $COILS --output ../data/Ins_$COILS.cal
+done
+
+# variants of Ins_100 for scaling in lines, due date tightness and alpha
+$GENERATOR --coils 100 --lines 5 --seed 1001 --output ../data/Ins_100_K5.cal
+$GENERATOR --coils 100 --due-date-tightness 0.7 --seed 1002 --output ../data/Ins_100_tight.cal
+$GENERATOR --coils 100 --delayed-coils-ratio 0.1 --seed 1003 --output ../data/Ins_100_alpha10.cal
@@ -0,0 +1,21 @@
+TIME_LIMIT=3600
+for FORMULATION in bigm lazy indicator
+do
+    for INSTANCE in Ins_4.cal Ins_8.cal Ins_12.cal Ins_20.cal Ins_30.cal Ins_40.cal Ins_50.cal
+    do
+        ./run_timing.sh $FORMULATION $INSTANCE $TIME_LIMIT
+    done
+done
+
+# compare solving times of compact model and B&P per formulation and instance
+echo "formulation;instance;compact;bp"
+for FORMULATION in bigm lazy indicator
+do
+    for INSTANCE in Ins_4.cal Ins_8.cal Ins_12.cal Ins_20.cal Ins_30.cal Ins_40.cal Ins_50.cal
+    do
+        LOG_FILE="Timing_"$FORMULATION"_"$TIME_LIMIT"/"$INSTANCE"/Timing_"$FORMULATION"_"$TIME_LIMIT"_"$INSTANCE.log
+        COMPACT=$(grep "TOTAL TIME IN COMPACT MODEL" $LOG_FILE | awk '{print $NF}')
+        BP=$(grep "TOTAL TIME IN B&P" $LOG_FILE | awk '{print $NF}')
+        echo "$FORMULATION;$INSTANCE;$COMPACT;$BP"
+    done
+done
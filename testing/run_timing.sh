@@ -0,0 +1,15 @@
+
+FORMULATION=$1
+TIME_LIMIT=$3
+MY_PWD="Timing_"$FORMULATION"_"$TIME_LIMIT"/"$2
+
+mkdir -p $MY_PWD
+cd $MY_PWD
+
+mkdir -p TransMasterProblems
+mkdir -p SubProblems
+
+INSTANCE=../../../data/$2
+LOG_FILE="Timing_"$FORMULATION"_"$TIME_LIMIT"_"$2.log
+
+../../../build/PHALS $INSTANCE $TIME_LIMIT $FORMULATION | tee $LOG_FILE